@@ -11,7 +11,7 @@
 struct EDITORTestLevelSpawnPoint_XData
 {
     RenderObjectManager* rom;
-    RenderObject*        renderObj;
+    RenderObjectHandle   renderObj;
 
     int32_t spawnIdx        = 0;
     vec3    position        = GLM_VEC3_ZERO_INIT;
@@ -10,7 +10,7 @@
 struct EDITORTextureViewer_XData
 {
     RenderObjectManager* rom;
-    RenderObject*        renderObj;
+    RenderObjectHandle   renderObj;
 
     size_t currentAssignedUMB = (size_t)-1;
     size_t currentAssignedDMPS = (size_t)-1;
@@ -62,6 +62,7 @@ void EDITORTextureViewer::simulationUpdate(float_t simDeltaTime)
         d->currentAssignedDMPS = INTERNAL_EDITORTEXTUREVIEWER_assignedMaterialDMPS;
         for (auto& cmi : d->renderObj->calculatedModelInstances)
             cmi.materialID = d->currentAssignedDMPS;
+        d->rom->flagInstanceDataChanged();
     }
     if (forceBucketResorting)
         d->rom->flagMetaMeshListAsUnoptimized();
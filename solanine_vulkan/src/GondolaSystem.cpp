@@ -28,13 +28,13 @@ constexpr float_t LENGTH_BOGIE_PADDING_LOCAL_NETWORK = LENGTH_CART_LOCAL_NETWORK
 struct GondolaSystem_XData
 {
     RenderObjectManager*       rom;
-    RenderObject*              controlRenderObj;
+    RenderObjectHandle         controlRenderObj;
 
     vec3                       position = GLM_VEC3_ZERO_INIT;
     struct ControlPoint
     {
         vec3          position;
-        RenderObject* renderObj;
+        RenderObjectHandle renderObj;
     };
     std::vector<ControlPoint>  controlPoints;
     float_t                    lineYoff = 0.5f;  // Add this to the y of the rendered lines.
@@ -95,7 +95,7 @@ struct GondolaSystem_XData
     struct Simulation
     {
         float_t                    offsetT;
-        std::vector<RenderObject*> renderObjs;  // @NOTE: For LODs, switch out the assigned model, not unregister/register new RenderObjects.  -Timo 2020/10/04
+        std::vector<RenderObjectHandle> renderObjs;  // @NOTE: For LODs, switch out the assigned model, not unregister/register new RenderObjects.  -Timo 2020/10/04
         struct GondolaCart
         {
             float_t length;  // Length of the cabin (excluding the connector halls)
@@ -132,7 +132,7 @@ struct GondolaSystem_XData
         size_t secondaryBackwardCPIdx = (size_t)-1;
         size_t auxiliaryForwardCPIdx = (size_t)-1;
         size_t auxiliaryBackwardCPIdx = (size_t)-1;
-        RenderObject* renderObj = nullptr;
+        RenderObjectHandle renderObj = nullptr;
     };
     std::vector<Station> stations;
 
@@ -330,6 +330,7 @@ void buildCollisions(GondolaSystem_XData* d, std::vector<VoxelField*>& outCollis
         if (entAsVF = dynamic_cast<VoxelField*>(ent))
         {
             entAsVF->setBodyKinematic(true);  // Since they'll be essentially glued from the track, no use having them be dynamic.
+            entAsVF->setCollisionLayer(physengine::Layers::GONDOLA);
             outCollisions.push_back(entAsVF);
         }
     }
@@ -358,10 +359,13 @@ void moveCollisionBodies(GondolaSystem_XData* d, bool staticMove, float_t simDel
 void readyGondolaInteraction(GondolaSystem_XData* d, EntityManager* em, const GondolaSystem_XData::Simulation& simulation, size_t desiredSimulationIdx)
 {
     // Clear and rebuild
+    // @NOTE: the new cars get batched in so they go into the broadphase already moved into place.
+    physengine::beginBodyBatch();
     destructAndResetGondolaCollisions(d, em);
     buildCollisions(d, d->detailedGondola.collisions, d->gondolaNetworkType);
     d->detailedGondola.prevClosestSimulation = desiredSimulationIdx;  // Mark cache as completed.
     moveCollisionBodies(d, true, 0.0f);
+    physengine::endBodyBatch();
 }
 
 void destructAndResetStationCollision(GondolaSystem_XData* d, EntityManager* em)
@@ -374,6 +378,7 @@ void destructAndResetStationCollision(GondolaSystem_XData* d, EntityManager* em)
 void readyStationInteraction(GondolaSystem_XData* d, GondolaSystem_XData::Station& station, size_t stationIdx)
 {
     // Add station collision if not existing yet.
+    physengine::beginBodyBatch();
     if (d->detailedStation.collision == nullptr)
     {
         std::vector<Entity*> ents;
@@ -385,6 +390,7 @@ void readyStationInteraction(GondolaSystem_XData* d, GondolaSystem_XData::Statio
             {
                 // Just nab the first voxelfield and then dip.
                 d->detailedStation.collision = entAsVF;
+                entAsVF->setCollisionLayer(physengine::Layers::GONDOLA);
                 break;
             }
         }
@@ -417,6 +423,7 @@ void readyStationInteraction(GondolaSystem_XData* d, GondolaSystem_XData::Statio
     glm_vec3_add(d->controlPoints[station.anchorCPIdx].position, extent, newPos);
 
     d->detailedStation.collision->moveBody(newPos, rotationV, true, 0.0f);
+    physengine::endBodyBatch();
     d->detailedStation.prevClosestStation = stationIdx;
     // glm_mat4_zero(d->detailedStation.prevCollisionTransform);  // Invalidate prev collision cache.  // @INCOMPLETE: there's no way to tell if the new transform is similar to the old one.
 }
@@ -506,7 +513,7 @@ GondolaSystem::GondolaSystem(EntityManager* em, RenderObjectManager* rom, DataSe
 
     // Load in control point render objs.
     std::vector<RenderObject> inROs;
-    std::vector<RenderObject**> outROs;
+    std::vector<RenderObjectHandle*> outROs;
     inROs.resize(_data->controlPoints.size(), {
         .model = _data->rom->getModel("BuilderObj_BezierHandle", this, [](){}),
         .renderLayer = RenderLayer::BUILDER,
@@ -525,7 +532,7 @@ GondolaSystem::~GondolaSystem()
 {
     hotswapres::removeOwnedCallbacks(this);
 
-    std::vector<RenderObject*> renderObjsToUnregister;
+    std::vector<RenderObjectHandle> renderObjsToUnregister;
     renderObjsToUnregister.push_back(_data->controlRenderObj);
     for (auto& cp : _data->controlPoints)
         renderObjsToUnregister.push_back(cp.renderObj);
@@ -635,7 +642,7 @@ void spawnSimulation(GondolaSystem_XData* d, void* modelOwner, const std::string
     newSimulation.renderObjs.resize(NUM_CARTS_LOCAL_NETWORK, nullptr);
 
     std::vector<RenderObject> inROs;
-    std::vector<RenderObject**> outROs;
+    std::vector<RenderObjectHandle*> outROs;
     for (size_t i = 0; i < NUM_CARTS_LOCAL_NETWORK; i++)
     {
         // Setup render object registration.
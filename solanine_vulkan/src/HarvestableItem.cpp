@@ -16,7 +16,7 @@
 struct HarvestableItem_XData
 {
     RenderObjectManager* rom;
-    RenderObject* renderObj;
+    RenderObjectHandle renderObj;
     physengine::CapsulePhysicsData* cpd;  // @DEBUG
     vec3 position = GLM_VEC3_ZERO_INIT;
     size_t harvestableItemId = 0;
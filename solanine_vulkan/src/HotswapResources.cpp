@@ -26,6 +26,7 @@ namespace hotswapres
         ".log",
         ".swp",
         ".gitkeep",
+        ".vfcache",
     };
 
     struct JobDependency
@@ -1,7 +1,7 @@
 #pragma once
 
 #include "Entity.h"
-struct RenderObject;
+#include "RenderObject.h"
 class RenderObjectManager;
 
 
@@ -21,7 +21,7 @@ public:
     void renderImGui();
 
 private:
-    RenderObject*        _renderObj;
+    RenderObjectHandle   _renderObj;
     RenderObjectManager* _rom;
 
     // Load Props
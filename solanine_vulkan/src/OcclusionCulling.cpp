@@ -0,0 +1,261 @@
+#include "pch.h"
+
+#include "OcclusionCulling.h"
+#include "Debug.h"
+
+
+namespace occlusionculling
+{
+	uint32_t DepthPyramid::getMipWidth(uint32_t mip) const
+	{
+		return std::max(1u, width >> mip);
+	}
+
+	uint32_t DepthPyramid::getMipHeight(uint32_t mip) const
+	{
+		return std::max(1u, height >> mip);
+	}
+
+	uint32_t previousPow2(uint32_t value)
+	{
+		uint32_t result = 1;
+		while (result * 2 <= value)
+			result *= 2;
+		return result;
+	}
+
+	uint32_t calcNumMips(uint32_t width, uint32_t height)
+	{
+		uint32_t numMips = 1;
+		while ((width | height) >> numMips)
+			numMips++;
+		return numMips;
+	}
+
+	float_t sampleMax(const float_t* image, uint32_t width, uint32_t height, float_t u, float_t v)
+	{
+		// Texels that a linear filter would blend.
+		float_t x = u * width - 0.5f;
+		float_t y = v * height - 0.5f;
+		int32_t x0 = (int32_t)std::floor(x);
+		int32_t y0 = (int32_t)std::floor(y);
+
+		float_t result = -std::numeric_limits<float_t>::max();
+		for (int32_t yy = y0; yy <= y0 + 1; yy++)
+		for (int32_t xx = x0; xx <= x0 + 1; xx++)
+		{
+			int32_t cx = std::clamp(xx, 0, (int32_t)width - 1);
+			int32_t cy = std::clamp(yy, 0, (int32_t)height - 1);
+			result = std::max(result, image[cy * width + cx]);
+		}
+		return result;
+	}
+
+	float_t sampleMax(const DepthPyramid& pyramid, float_t u, float_t v, float_t level)
+	{
+		// @NOTE: the gpu sampler uses `VK_SAMPLER_MIPMAP_MODE_NEAREST`.
+		int32_t mip = std::clamp((int32_t)std::round(level), 0, (int32_t)pyramid.mips.size() - 1);
+		return sampleMax(pyramid.mips[mip].data(), pyramid.getMipWidth(mip), pyramid.getMipHeight(mip), u, v);
+	}
+
+	void buildDepthPyramid(const float_t* depth, uint32_t depthWidth, uint32_t depthHeight, DepthPyramid& outPyramid)
+	{
+		outPyramid.width = previousPow2(depthWidth);
+		outPyramid.height = previousPow2(depthHeight);
+		outPyramid.mips.resize(calcNumMips(outPyramid.width, outPyramid.height));
+
+		for (uint32_t mip = 0; mip < (uint32_t)outPyramid.mips.size(); mip++)
+		{
+			uint32_t mipWidth = outPyramid.getMipWidth(mip);
+			uint32_t mipHeight = outPyramid.getMipHeight(mip);
+			outPyramid.mips[mip].resize(mipWidth * mipHeight);
+
+			// Mip 0 reduces the depth buffer, the rest reduce the previous mip.
+			const float_t* source = (mip == 0 ? depth : outPyramid.mips[mip - 1].data());
+			uint32_t sourceWidth = (mip == 0 ? depthWidth : outPyramid.getMipWidth(mip - 1));
+			uint32_t sourceHeight = (mip == 0 ? depthHeight : outPyramid.getMipHeight(mip - 1));
+
+			for (uint32_t y = 0; y < mipHeight; y++)
+			for (uint32_t x = 0; x < mipWidth; x++)
+				outPyramid.mips[mip][y * mipWidth + x] =
+					sampleMax(
+						source,
+						sourceWidth,
+						sourceHeight,
+						(x + 0.5f) / mipWidth,
+						(y + 0.5f) / mipHeight
+					);
+		}
+	}
+
+	bool projectSphere(vec3 viewCenter, float_t radius, const SphereTestParams& params, vec4& outUVAABB)
+	{
+		// Flip to looking down +z.
+		vec3 c = { viewCenter[0], viewCenter[1], -viewCenter[2] };
+		if (c[2] < radius + params.zNear)
+			return false;
+
+		// 2D Polyhedral Bounds of a Clipped, Perspective-Projected 3D Sphere. Michael Mara, Morgan McGuire. 2013
+		vec3 cr;
+		glm_vec3_scale(c, radius, cr);
+		float_t czr2 = c[2] * c[2] - radius * radius;
+
+		float_t vx = std::sqrt(c[0] * c[0] + czr2);
+		float_t minX = (vx * c[0] - cr[2]) / (vx * c[2] + cr[0]);
+		float_t maxX = (vx * c[0] + cr[2]) / (vx * c[2] - cr[0]);
+
+		float_t vy = std::sqrt(c[1] * c[1] + czr2);
+		float_t minY = (vy * c[1] - cr[2]) / (vy * c[2] + cr[1]);
+		float_t maxY = (vy * c[1] + cr[2]) / (vy * c[2] - cr[1]);
+
+		// Ndc to uv. P11 flips y, so min and max could trade places.
+		float_t ndcY0 = minY * params.P11;
+		float_t ndcY1 = maxY * params.P11;
+		outUVAABB[0] = minX * params.P00 * 0.5f + 0.5f;
+		outUVAABB[1] = std::min(ndcY0, ndcY1) * 0.5f + 0.5f;
+		outUVAABB[2] = maxX * params.P00 * 0.5f + 0.5f;
+		outUVAABB[3] = std::max(ndcY0, ndcY1) * 0.5f + 0.5f;
+		return true;
+	}
+
+	bool isSphereOccluded(const DepthPyramid& pyramid, vec3 viewCenter, float_t radius, const SphereTestParams& params)
+	{
+		vec4 aabb;
+		if (!projectSphere(viewCenter, radius, params, aabb))
+			return false;
+
+		float_t width = (aabb[2] - aabb[0]) * pyramid.width;
+		float_t height = (aabb[3] - aabb[1]) * pyramid.height;
+		float_t level = std::floor(std::log2(std::max(width, height)));
+
+		float_t pyramidDepth = sampleMax(pyramid, (aabb[0] + aabb[2]) * 0.5f, (aabb[1] + aabb[3]) * 0.5f, level);
+
+		// Depth of the point on the sphere nearest to the camera.
+		float_t nearestZ = viewCenter[2] + radius;
+		float_t sphereDepth = (params.P22 * nearestZ + params.P32) / -nearestZ;
+		return sphereDepth > pyramidDepth;
+	}
+
+#ifdef _DEVELOP
+	bool runSelfCheck()
+	{
+		// Same kind of projection as the scene camera.
+		constexpr float_t zNear = 0.1f;
+		mat4 projection;
+		glm_perspective(glm_rad(70.0f), 16.0f / 9.0f, zNear, 100.0f, projection);
+		projection[1][1] *= -1.0f;
+		SphereTestParams params = {
+			.zNear = zNear,
+			.P00 = projection[0][0],
+			.P11 = projection[1][1],
+			.P22 = projection[2][2],
+			.P32 = projection[3][2],
+		};
+		auto viewZToDepth = [&](float_t viewZ) { return (params.P22 * viewZ + params.P32) / -viewZ; };
+		auto uToViewX = [&](float_t u, float_t viewZ) { return (u * 2.0f - 1.0f) * -viewZ / params.P00; };
+
+		size_t numFailed = 0;
+		auto report = [&](bool passed, const std::string& checkName) {
+			if (passed)
+				return;
+			numFailed++;
+			debug::pushDebugMessage({
+				.message = "Occlusion culling self-check failed: " + checkName,
+				.type = 2,
+				.timeUntilDeletion = 15.0f,
+				});
+		};
+
+		// Sphere projection of a sphere straight ahead: bounds are the tangent lines, `r / sqrt(d^2 - r^2)`.
+		{
+			constexpr float_t d = 20.0f, r = 2.0f;
+			float_t tangent = r / std::sqrt(d * d - r * r);
+			vec3 center = { 0.0f, 0.0f, -d };
+			vec4 aabb;
+			bool projected = projectSphere(center, r, params, aabb);
+			report(projected &&
+				std::abs(aabb[0] - (0.5f - 0.5f * params.P00 * tangent)) < 1e-5f &&
+				std::abs(aabb[2] - (0.5f + 0.5f * params.P00 * tangent)) < 1e-5f &&
+				std::abs(aabb[1] - (0.5f + 0.5f * params.P11 * tangent)) < 1e-5f &&
+				std::abs(aabb[3] - (0.5f - 0.5f * params.P11 * tangent)) < 1e-5f,
+				"projectSphere() on a centered sphere");
+		}
+
+		// Sphere projection of an off center sphere vs. projecting points all over its surface.
+		{
+			vec3 center = { 3.0f, -2.0f, -15.0f };
+			constexpr float_t r = 1.5f;
+			vec4 aabb;
+			bool projected = projectSphere(center, r, params, aabb);
+
+			vec4 pointsAABB = { 1.0f, 1.0f, 0.0f, 0.0f };
+			constexpr int32_t NUM_STEPS = 256;
+			for (int32_t i = 0; i <= NUM_STEPS; i++)
+			for (int32_t j = 0; j < NUM_STEPS; j++)
+			{
+				float_t theta = GLM_PIf * i / NUM_STEPS;
+				float_t phi = 2.0f * GLM_PIf * j / NUM_STEPS;
+				vec3 point = {
+					center[0] + r * std::sin(theta) * std::cos(phi),
+					center[1] + r * std::cos(theta),
+					center[2] + r * std::sin(theta) * std::sin(phi),
+				};
+				float_t u = point[0] / -point[2] * params.P00 * 0.5f + 0.5f;
+				float_t v = point[1] / -point[2] * params.P11 * 0.5f + 0.5f;
+				pointsAABB[0] = std::min(pointsAABB[0], u);
+				pointsAABB[1] = std::min(pointsAABB[1], v);
+				pointsAABB[2] = std::max(pointsAABB[2], u);
+				pointsAABB[3] = std::max(pointsAABB[3], v);
+			}
+			report(projected &&
+				std::abs(aabb[0] - pointsAABB[0]) < 1e-3f &&
+				std::abs(aabb[1] - pointsAABB[1]) < 1e-3f &&
+				std::abs(aabb[2] - pointsAABB[2]) < 1e-3f &&
+				std::abs(aabb[3] - pointsAABB[3]) < 1e-3f,
+				"projectSphere() on an off center sphere");
+		}
+
+		// Occlusion against a wall 10 units away covering the left half of the screen.
+		// @NOTE: not a power of 2 on purpose, so that the mip 0 reduction gets checked too.
+		constexpr uint32_t depthWidth = 1280, depthHeight = 720;
+		constexpr float_t wallZ = -10.0f;
+		std::vector<float_t> depth(depthWidth * depthHeight, 1.0f);
+		for (uint32_t y = 0; y < depthHeight; y++)
+		for (uint32_t x = 0; x < depthWidth / 2; x++)
+			depth[y * depthWidth + x] = viewZToDepth(wallZ);
+
+		DepthPyramid pyramid;
+		buildDepthPyramid(depth.data(), depthWidth, depthHeight, pyramid);
+		report(pyramid.width == 1024 && pyramid.height == 512 && pyramid.mips.size() == 11, "buildDepthPyramid() size");
+		report(pyramid.mips.back()[0] == 1.0f, "buildDepthPyramid() last mip is the max depth");
+
+		struct SphereCase
+		{
+			const char* name;
+			float_t u;
+			float_t viewZ;
+			float_t radius;
+			bool expectOccluded;
+		};
+		SphereCase sphereCases[] = {
+			{ "behind the wall",          0.25f, -30.0f, 1.0f, true },
+			{ "in front of the wall",     0.25f,  -5.0f, 1.0f, false },
+			{ "touching the wall",        0.25f, -10.5f, 1.0f, false },
+			{ "open side of the screen",  0.75f, -30.0f, 1.0f, false },
+			{ "straddling the wall edge", 0.5f,  -30.0f, 2.0f, false },
+			{ "crossing the near plane",  0.25f,  -0.5f, 1.0f, false },
+		};
+		for (SphereCase& sc : sphereCases)
+		{
+			vec3 viewCenter = { uToViewX(sc.u, sc.viewZ), 0.0f, sc.viewZ };
+			report(isSphereOccluded(pyramid, viewCenter, sc.radius, params) == sc.expectOccluded, std::string("isSphereOccluded() sphere ") + sc.name);
+		}
+
+		if (numFailed == 0)
+			debug::pushDebugMessage({
+				.message = "Occlusion culling self-check passed",
+				});
+		return (numFailed == 0);
+	}
+#endif
+}
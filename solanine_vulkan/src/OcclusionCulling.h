@@ -0,0 +1,45 @@
+#pragma once
+
+
+// CPU reference of the hierarchical Z occlusion culling that `depth_reduce.comp`
+// and `indirect_culling.comp` do on the gpu. The math here is kept 1:1 with the
+// shaders so that culling decisions can get checked without a gpu.
+namespace occlusionculling
+{
+	struct DepthPyramid
+	{
+		uint32_t width;
+		uint32_t height;
+		std::vector<std::vector<float_t>> mips;  // Row major, mip 0 is `width` x `height`.
+
+		uint32_t getMipWidth(uint32_t mip) const;
+		uint32_t getMipHeight(uint32_t mip) const;
+	};
+
+	// Same values as what gets pushed in `GPUCullingParams`.
+	struct SphereTestParams
+	{
+		float_t zNear;
+		float_t P00;
+		float_t P11;  // @NOTE: negative, since the projection matrix gets its y flipped.
+		float_t P22;
+		float_t P32;
+	};
+
+	uint32_t previousPow2(uint32_t value);
+	uint32_t calcNumMips(uint32_t width, uint32_t height);
+
+	// Emulates a `VK_SAMPLER_REDUCTION_MODE_MAX` linear sample (max of the 2x2 texel footprint) with clamp to edge.
+	float_t sampleMax(const float_t* image, uint32_t width, uint32_t height, float_t u, float_t v);
+	float_t sampleMax(const DepthPyramid& pyramid, float_t u, float_t v, float_t level);
+
+	void buildDepthPyramid(const float_t* depth, uint32_t depthWidth, uint32_t depthHeight, DepthPyramid& outPyramid);
+
+	// `viewCenter` is in view space (looking down -z). Returns false if the sphere crosses the near plane.
+	bool projectSphere(vec3 viewCenter, float_t radius, const SphereTestParams& params, vec4& outUVAABB);
+	bool isSphereOccluded(const DepthPyramid& pyramid, vec3 viewCenter, float_t radius, const SphereTestParams& params);
+
+#ifdef _DEVELOP
+	bool runSelfCheck();  // Checks the above against known spheres and a known depth buffer. Failures go to debug messages.
+#endif
+}
@@ -31,8 +31,8 @@ namespace physengine
     // Physics engine works
     //
     constexpr float_t simDeltaTime = 0.025f;    // 40fps. This seemed to be the sweet spot. 25/30fps would be inconsistent for getting smaller platform jumps with the dash move. 50fps felt like too many physics calculations all at once. 40fps seems right, striking a balance.  -Timo 2023/01/26
-    constexpr float_t physicsDeltaTimeInMS = simDeltaTime * 1000.0f;
-    constexpr float_t oneOverPhysicsDeltaTimeInMS = 1.0f / physicsDeltaTimeInMS;
+    constexpr size_t maxCatchUpTicks = 4;       // Ticks that can run back to back when the simulation falls behind. Any more than this get dropped.
+    std::atomic<int32_t> collisionStepsPerTick = 1;  // Substeps Jolt takes inside of each tick.
 
     constexpr float_t collisionTolerance = 0.05f;  // For physics characters.
 
@@ -40,12 +40,25 @@ namespace physengine
     EntityManager* entityManager;
     bool isAsyncRunnerRunning;
     std::thread* asyncRunner = nullptr;
-    uint64_t lastTick;
+    std::atomic<uint64_t> lastTick;  // Performance counter time of when the latest tick was due.
+
+    struct TickTimingStats
+    {
+        size_t  numTicks = 0;
+        size_t  numCatchUpTicks = 0;   // Ticks that ran late, back to back with another tick.
+        size_t  numOverrunLoops = 0;   // Times the simulation fell behind by one or more ticks.
+        size_t  numDroppedTicks = 0;   // Ticks skipped bc of falling behind more than `maxCatchUpTicks`.
+        float_t lastWakeErrorMS = 0.0f;
+        float_t maxWakeErrorMS = 0.0f;
+    } tickStats;
 
     bool runPhysicsSimulations = false;
 
+    constexpr uint32_t PHYSICS_MAX_BODIES = 65536;
     PhysicsSystem* physicsSystem = nullptr;
-    std::map<uint32_t, std::string> bodyIdToEntityGuidMap;
+    JobSystem* queryJobSystem = nullptr;  // Simulation's job system, borrowed for batched queries.
+    std::shared_mutex queryJobSystemMutex;  // Shared while a batch is using `queryJobSystem`, exclusive while the simulation thread sets/clears it.
+    Entity* bodyIdToEntity[PHYSICS_MAX_BODIES] = {};  // Indexed by `BodyID::GetIndex()`.
 
     enum class UserDataMeaning
     {
@@ -62,6 +75,14 @@ namespace physengine
     struct SimulationInterpolationSet
     {
         SimulationTransform simTransforms[65536 * 2];
+
+        // @NOTE: a slot is changed in this set if its transform is different from the set before it. Changed slots get
+        //        `changedStamps[i] == stamp` and are listed in `changedIndices`, so the render thread only has to interpolate those.
+        //        The list is a fixed array so reading it while the sim thread refills it can't crash (same tearing as `simTransforms`).
+        uint64_t stamp = (uint64_t)-1;
+        uint64_t changedStamps[65536 * 2] = {};
+        uint32_t changedIndices[65536 * 2];
+        std::atomic<uint32_t> numChangedIndices = 0;
     };
     // @NOTE: The interpolated simulation position is calculated between `prevSimSet` and `currentSimSet` and is stored in `calcInterpolatedSet`.
     //        New simulation transforms are written to `nextSimSet` as the calculations are formed. Once the "tick" or new frame has started,
@@ -77,6 +98,7 @@ namespace physengine
     };
     std::atomic<size_t> simSetOffset = 0;
     SimulationInterpolationSet* calcInterpolatedSet = nullptr;
+    size_t calcInterpolatedSimSetOffset = (size_t)-1;  // `simSetOffset` when `calcInterpolatedSet` was last recalculated.
     std::vector<size_t> registeredSimSetIndices;
     std::mutex mutateSimSetPoolsMutex;
 
@@ -441,18 +463,34 @@ namespace physengine
             << "WARNING: id " << id << " was not found in pool to delete. It did not exist." << std::endl;
     }
 
+    inline void markSimulationTransformChanged(SimulationInterpolationSet& simSet, size_t id)
+    {
+        if (simSet.changedStamps[id] == simSet.stamp)
+            return;  // Already listed.
+
+        simSet.changedStamps[id] = simSet.stamp;
+        simSet.changedIndices[simSet.numChangedIndices] = (uint32_t)id;
+        simSet.numChangedIndices++;
+    }
+
     void updateSimulationTransformPosition(size_t id, vec3 pos)
     {
         size_t simSetOffsetCopy = simSetOffset;
+        size_t currentSimSet = (simSetOffsetCopy + 1) % 3;
         size_t nextSimSet = (simSetOffsetCopy + 2) % 3;
         glm_vec3_copy(pos, simSetChain[nextSimSet]->simTransforms[id].position);
+        if (!glm_vec3_eqv(pos, simSetChain[currentSimSet]->simTransforms[id].position))
+            markSimulationTransformChanged(*simSetChain[nextSimSet], id);
     }
 
     void updateSimulationTransformRotation(size_t id, versor rot)
     {
         size_t simSetOffsetCopy = simSetOffset;
+        size_t currentSimSet = (simSetOffsetCopy + 1) % 3;
         size_t nextSimSet = (simSetOffsetCopy + 2) % 3;
         glm_quat_copy(rot, simSetChain[nextSimSet]->simTransforms[id].rotation);
+        if (!glm_vec4_eqv(rot, simSetChain[currentSimSet]->simTransforms[id].rotation))
+            markSimulationTransformChanged(*simSetChain[nextSimSet], id);
     }
 
     void getInterpSimulationTransformPosition(size_t id, vec3& outPos)
@@ -466,6 +504,7 @@ namespace physengine
     }
 
     void transformSwap();
+    void applyPendingSaveVoxelShapeCaches();
     void copyResultTransforms();
 
     static void TraceImpl(const char* inFMT, ...)  // Callback for traces, connect this to your own trace function if you have one
@@ -495,60 +534,121 @@ namespace physengine
 
 #endif // JPH_ENABLE_ASSERTS
 
-    // Layer that objects can be in, determines which other objects it can collide with
-// Typically you at least want to have 1 layer for moving bodies and 1 layer for static bodies, but you can have more
-// layers if you want. E.g. you could have a layer for high detail collision (which is not used by the physics simulation
-// but only if you do collision testing).
-    namespace Layers
+    // Each broadphase layer results in a separate bounding volume tree in the broad phase. You at least want to have
+    // a layer for non-moving and moving objects to avoid having to update a tree full of static objects every frame.
+    // If you have many object layers you'll be creating many broad phase trees, which is not efficient, so object layers
+    // that get queried together share a tree. If you want to fine tune your broadphase layers define
+    // JPH_TRACK_BROADPHASE_STATS and look at the stats reported on the TTY.
+    namespace BroadPhaseLayers
+    {
+        static constexpr BroadPhaseLayer NON_MOVING(0);
+        static constexpr BroadPhaseLayer MOVING(1);
+        static constexpr BroadPhaseLayer CHARACTER(2);
+        static constexpr BroadPhaseLayer TRIGGER(3);
+        static constexpr uint32_t NUM_LAYERS(4);
+    };
+
+    struct CollisionLayerProps
     {
-        static constexpr ObjectLayer NON_MOVING = 0;
-        static constexpr ObjectLayer MOVING = 1;
-        static constexpr ObjectLayer NUM_LAYERS = 2;
+        const char*     name;
+        BroadPhaseLayer broadPhaseLayer;
+        uint32_t        collidesWith;  // Bitmask of object layers.
+    };
+
+    // @NOTE: keep `collidesWith` symmetric when editing this table (`setLayersCollide()` keeps it symmetric).
+    constexpr uint32_t layerBit(ObjectLayer layer) { return (1u << layer); }
+    CollisionLayerProps collisionLayerTable[Layers::NUM_LAYERS] = {
+        {  // NON_MOVING
+            .name = "NonMoving",
+            .broadPhaseLayer = BroadPhaseLayers::NON_MOVING,
+            .collidesWith = layerBit(Layers::MOVING) | layerBit(Layers::CHARACTER) | layerBit(Layers::PROJECTILE),
+        },
+        {  // MOVING
+            .name = "Moving",
+            .broadPhaseLayer = BroadPhaseLayers::MOVING,
+            .collidesWith = layerBit(Layers::NON_MOVING) | layerBit(Layers::MOVING) | layerBit(Layers::CHARACTER) | layerBit(Layers::TRIGGER) | layerBit(Layers::GONDOLA) | layerBit(Layers::PROJECTILE),
+        },
+        {  // CHARACTER
+            .name = "Character",
+            .broadPhaseLayer = BroadPhaseLayers::CHARACTER,
+            .collidesWith = layerBit(Layers::NON_MOVING) | layerBit(Layers::MOVING) | layerBit(Layers::CHARACTER) | layerBit(Layers::TRIGGER) | layerBit(Layers::GONDOLA) | layerBit(Layers::PROJECTILE),
+        },
+        {  // TRIGGER
+            .name = "Trigger",
+            .broadPhaseLayer = BroadPhaseLayers::TRIGGER,
+            .collidesWith = layerBit(Layers::MOVING) | layerBit(Layers::CHARACTER),
+        },
+        {  // GONDOLA
+            .name = "Gondola",
+            .broadPhaseLayer = BroadPhaseLayers::MOVING,  // @NOTE: gondolas move every frame and get queried with the props, so they share the tree.
+            .collidesWith = layerBit(Layers::MOVING) | layerBit(Layers::CHARACTER) | layerBit(Layers::PROJECTILE),
+        },
+        {  // PROJECTILE
+            .name = "Projectile",
+            .broadPhaseLayer = BroadPhaseLayers::MOVING,
+            .collidesWith = layerBit(Layers::NON_MOVING) | layerBit(Layers::MOVING) | layerBit(Layers::CHARACTER) | layerBit(Layers::GONDOLA),
+        },
     };
 
+    // Object layer vs broadphase layer lookup, derived from `collisionLayerTable`.
+    bool objectVsBroadPhaseTable[Layers::NUM_LAYERS][BroadPhaseLayers::NUM_LAYERS];
+
+    void rebuildObjectVsBroadPhaseTable()
+    {
+        for (ObjectLayer i = 0; i < Layers::NUM_LAYERS; i++)
+        {
+            for (uint32_t j = 0; j < BroadPhaseLayers::NUM_LAYERS; j++)
+                objectVsBroadPhaseTable[i][j] = false;
+
+            for (ObjectLayer j = 0; j < Layers::NUM_LAYERS; j++)
+                if (collisionLayerTable[i].collidesWith & layerBit(j))
+                    objectVsBroadPhaseTable[i][(BroadPhaseLayer::Type)collisionLayerTable[j].broadPhaseLayer] = true;
+        }
+    }
+
+    void setLayersCollide(ObjectLayer layer1, ObjectLayer layer2, bool collide)
+    {
+        if (layer1 >= Layers::NUM_LAYERS || layer2 >= Layers::NUM_LAYERS)
+        {
+            std::cerr << "[SET LAYERS COLLIDE]" << std::endl
+                << "ERROR: layer " << layer1 << " or " << layer2 << " does not exist." << std::endl;
+            return;
+        }
+
+        if (collide)
+        {
+            collisionLayerTable[layer1].collidesWith |= layerBit(layer2);
+            collisionLayerTable[layer2].collidesWith |= layerBit(layer1);
+        }
+        else
+        {
+            collisionLayerTable[layer1].collidesWith &= ~layerBit(layer2);
+            collisionLayerTable[layer2].collidesWith &= ~layerBit(layer1);
+        }
+        rebuildObjectVsBroadPhaseTable();
+    }
+
+    bool getLayersCollide(ObjectLayer layer1, ObjectLayer layer2)
+    {
+        return (collisionLayerTable[layer1].collidesWith & layerBit(layer2));
+    }
+
     /// Class that determines if two object layers can collide
     class ObjectLayerPairFilterImpl : public ObjectLayerPairFilter
     {
     public:
         virtual bool ShouldCollide(ObjectLayer inObject1, ObjectLayer inObject2) const override
         {
-            switch (inObject1)
-            {
-            case Layers::NON_MOVING:
-                return inObject2 == Layers::MOVING; // Non moving only collides with moving
-            case Layers::MOVING:
-                return true; // Moving collides with everything
-            default:
-                JPH_ASSERT(false);
-                return false;
-            }
+            JPH_ASSERT(inObject1 < Layers::NUM_LAYERS && inObject2 < Layers::NUM_LAYERS);
+            return (collisionLayerTable[inObject1].collidesWith & layerBit(inObject2));
         }
-    };
-
-    // Each broadphase layer results in a separate bounding volume tree in the broad phase. You at least want to have
-    // a layer for non-moving and moving objects to avoid having to update a tree full of static objects every frame.
-    // You can have a 1-on-1 mapping between object layers and broadphase layers (like in this case) but if you have
-    // many object layers you'll be creating many broad phase trees, which is not efficient. If you want to fine tune
-    // your broadphase layers define JPH_TRACK_BROADPHASE_STATS and look at the stats reported on the TTY.
-    namespace BroadPhaseLayers
-    {
-        static constexpr BroadPhaseLayer NON_MOVING(0);
-        static constexpr BroadPhaseLayer MOVING(1);
-        static constexpr uint32_t NUM_LAYERS(2);
-    };
+    } objectVsObjectLayerFilter;
 
     // BroadPhaseLayerInterface implementation
     // This defines a mapping between object and broadphase layers.
     class BPLayerInterfaceImpl final : public BroadPhaseLayerInterface
     {
     public:
-        BPLayerInterfaceImpl()
-        {
-            // Create a mapping table from object to broad phase layer
-            mObjectToBroadPhase[Layers::NON_MOVING] = BroadPhaseLayers::NON_MOVING;
-            mObjectToBroadPhase[Layers::MOVING] = BroadPhaseLayers::MOVING;
-        }
-
         virtual uint32_t GetNumBroadPhaseLayers() const override
         {
             return BroadPhaseLayers::NUM_LAYERS;
@@ -557,7 +657,7 @@ namespace physengine
         virtual BroadPhaseLayer GetBroadPhaseLayer(ObjectLayer inLayer) const override
         {
             JPH_ASSERT(inLayer < Layers::NUM_LAYERS);
-            return mObjectToBroadPhase[inLayer];
+            return collisionLayerTable[inLayer].broadPhaseLayer;
         }
 
 #if defined(JPH_EXTERNAL_PROFILE) || defined(JPH_PROFILE_ENABLED)
@@ -567,14 +667,13 @@ namespace physengine
             {
             case (BroadPhaseLayer::Type)BroadPhaseLayers::NON_MOVING:	return "NON_MOVING";
             case (BroadPhaseLayer::Type)BroadPhaseLayers::MOVING:		return "MOVING";
+            case (BroadPhaseLayer::Type)BroadPhaseLayers::CHARACTER:	return "CHARACTER";
+            case (BroadPhaseLayer::Type)BroadPhaseLayers::TRIGGER:		return "TRIGGER";
             default:													JPH_ASSERT(false); return "INVALID";
             }
         }
 #endif // JPH_EXTERNAL_PROFILE || JPH_PROFILE_ENABLED
-
-    private:
-        BroadPhaseLayer mObjectToBroadPhase[Layers::NUM_LAYERS];
-    };
+    } broadphaseLayerInterface;
 
     /// Class that determines if an object layer can collide with a broadphase layer
     class ObjectVsBroadPhaseLayerFilterImpl : public ObjectVsBroadPhaseLayerFilter
@@ -582,18 +681,10 @@ namespace physengine
     public:
         virtual bool ShouldCollide(ObjectLayer inLayer1, BroadPhaseLayer inLayer2) const override
         {
-            switch (inLayer1)
-            {
-            case Layers::NON_MOVING:
-                return inLayer2 == BroadPhaseLayers::MOVING;
-            case Layers::MOVING:
-                return true;
-            default:
-                JPH_ASSERT(false);
-                return false;
-            }
+            JPH_ASSERT(inLayer1 < Layers::NUM_LAYERS);
+            return objectVsBroadPhaseTable[inLayer1][(BroadPhaseLayer::Type)inLayer2];
         }
-    };
+    } objectVsBroadphaseLayerFilter;
 
     // An example contact listener
     class MyContactListener : public ContactListener
@@ -619,7 +710,7 @@ namespace physengine
                 {
                     uint32_t id = thisBody.GetID().GetIndex();
                     SimulationCharacter* entityAsChar;
-                    if (entityAsChar = dynamic_cast<SimulationCharacter*>(entityManager->getEntityViaGUID(bodyIdToEntityGuidMap[id])))
+                    if (entityAsChar = dynamic_cast<SimulationCharacter*>(bodyIdToEntity[id]))
                         entityAsChar->reportPhysicsContact(otherBody, manifold, &ioSettings);
                 } return;
             }
@@ -660,6 +751,98 @@ namespace physengine
         }
     } bodyActivationListener;
 
+    void runSimulationTick(TempAllocator& tempAllocator, JobSystem& jobSystem)
+    {
+        ZoneScoped;
+
+#ifdef _DEVELOP
+        {   // Reset all the debug vis lines.
+            std::lock_guard<std::mutex> lg(mutateDebugVisLines);
+            debugVisLines.clear();
+        }
+
+        uint64_t perfTime = SDL_GetPerformanceCounter();
+#endif
+
+        if (!globalState::isEditingMode &&
+            input::editorInputSet().playModeToggleSimulation.onAction)
+        {
+            runPhysicsSimulations = !runPhysicsSimulations;
+            debug::pushDebugMessage({
+                .message = std::string("Set running physics simulations to ") + (runPhysicsSimulations ? "on" : "off"),
+                });
+        }
+
+        // @NOTE: this is the only place where `timeScale` is used. That's
+        //        because this system is designed to be running at 40fps constantly
+        //        in real time, so it doesn't slow down or speed up with time scale.
+        // @REPLY: I thought that the system should just run in a constant 40fps. As in,
+        //         if the timescale slows down, then the tick rate should also slow down
+        //         proportionate to the timescale.  -Timo 2023/06/10
+        transformSwap();
+        applyPendingSaveVoxelShapeCaches();
+        input::editorInputSet().update();
+        input::simInputSet().update(simDeltaTime);
+        entityManager->INTERNALsimulationUpdate(simDeltaTime);  // @NOTE: if timescale changes, then the system just waits longer/shorter per loop.
+        if (runPhysicsSimulations)
+        {
+            ZoneScopedN("Update Jolt phys sys");
+            physicsSystem->Update(simDeltaTime, collisionStepsPerTick, 1, &tempAllocator, &jobSystem);
+        }
+        copyResultTransforms();
+
+#ifdef _DEVELOP
+        {
+            ZoneScopedN("Update performance metrics");
+
+            //
+            // Update performance metrics
+            // @COPYPASTA
+            //
+            perfTime = SDL_GetPerformanceCounter() - perfTime;
+            perfStats.simTimesUSHeadIndex = (size_t)std::fmodf((float_t)perfStats.simTimesUSHeadIndex + 1, (float_t)perfStats.simTimesUSCount);
+
+            // Find what the highest simulation time is
+            if (perfTime > perfStats.highestSimTime)
+                perfStats.highestSimTime = perfTime;
+            else if (perfStats.simTimesUS[perfStats.simTimesUSHeadIndex] == perfStats.highestSimTime)
+            {
+                // Former highest sim time is getting overwritten; recalculate the 2nd highest sim time.
+                float_t nextHighestsimTime = perfTime;
+                for (size_t i = perfStats.simTimesUSHeadIndex + 1; i < perfStats.simTimesUSHeadIndex + perfStats.simTimesUSCount; i++)
+                    nextHighestsimTime = std::max(nextHighestsimTime, perfStats.simTimesUS[i]);
+                perfStats.highestSimTime = nextHighestsimTime;
+            }
+
+            // Apply simulation time to buffer
+            perfStats.simTimesUS[perfStats.simTimesUSHeadIndex] =
+                perfStats.simTimesUS[perfStats.simTimesUSHeadIndex + perfStats.simTimesUSCount] =
+                perfTime;
+        }
+#endif
+    }
+
+    void sleepUntilPrecise(uint64_t targetPerfCounter)
+    {
+        ZoneScoped;
+
+        // @NOTE: the OS sleep can overshoot by a whole scheduler quantum (~1ms on Linux, up to ~15ms on
+        //        Windows w/o `timeBeginPeriod()`), so sleep until `sleepSpinMargin` away from the target
+        //        and spin the rest of the way.
+        static const uint64_t perfFrequency = SDL_GetPerformanceFrequency();
+        static const uint64_t sleepSpinMargin = perfFrequency * 2 / 1000;  // 2ms.
+
+        uint64_t now = SDL_GetPerformanceCounter();
+        if (targetPerfCounter > now + sleepSpinMargin)
+        {
+            uint64_t sleepNS = (targetPerfCounter - now - sleepSpinMargin) * 1000000000 / perfFrequency;
+            std::this_thread::sleep_for(std::chrono::nanoseconds(sleepNS));
+        }
+
+        while (SDL_GetPerformanceCounter() < targetPerfCounter)
+            std::this_thread::yield();
+    }
+
     void runPhysicsEngineAsync()
     {
         tracy::SetThreadName("Simulation Thread");
@@ -681,15 +864,17 @@ namespace physengine
         constexpr int32_t maxPhysicsJobs = 2048;
         constexpr int32_t maxPhysicsBarriers = 8;
         JobSystemThreadPool jobSystem(maxPhysicsJobs, maxPhysicsBarriers, std::thread::hardware_concurrency() - 1);
+        {
+            std::unique_lock<std::shared_mutex> lock(queryJobSystemMutex);
+            queryJobSystem = &jobSystem;
+        }
 
-        const uint32_t maxBodies = 65536;
+        const uint32_t maxBodies = PHYSICS_MAX_BODIES;
         const uint32_t numBodyMutexes = 0;  // Default settings is no mutexes to protect bodies from concurrent access.
         const uint32_t maxBodyPairs = 65536;
         const uint32_t maxContactConstraints = 10240;
 
-        BPLayerInterfaceImpl broadphaseLayerInterface;
-        ObjectVsBroadPhaseLayerFilterImpl objectVsBroadphaseLayerFilter;
-        ObjectLayerPairFilterImpl objectVsObjectLayerFilter;
+        rebuildObjectVsBroadPhaseTable();
 
         physicsSystem = new PhysicsSystem;
         physicsSystem->Init(maxBodies, numBodyMutexes, maxBodyPairs, maxContactConstraints, broadphaseLayerInterface, objectVsBroadphaseLayerFilter, objectVsObjectLayerFilter);
@@ -712,91 +897,297 @@ namespace physengine
 
         //
         // Run Physics Simulation until no more.
+        // @NOTE: real time (scaled by `timescale`) gets put into the accumulator and gets consumed in fixed
+        //        `simDeltaTime` ticks, so gameplay speed stays the same even if a tick runs late. If the
+        //        simulation falls too far behind, the extra time gets dropped instead of spiralling.
         //
+        const uint64_t perfFrequency = SDL_GetPerformanceFrequency();
+        uint64_t prevTime = SDL_GetPerformanceCounter();
+        double_t accumulator = 0.0;
+        lastTick = prevTime;
+
         while (isAsyncRunnerRunning)
         {
-            lastTick = SDL_GetTicks64();
+            uint64_t now = SDL_GetPerformanceCounter();
+            double_t timescale = std::max(0.0, (double_t)globalState::timescale);
+            accumulator += (double_t)(now - prevTime) / perfFrequency * timescale;
+            prevTime = now;
+
+            // Catch up on ticks.
+            size_t ticksThisLoop = 0;
+            while (accumulator >= simDeltaTime)
+            {
+                if (ticksThisLoop == maxCatchUpTicks)
+                {
+                    size_t numDropped = (size_t)(accumulator / simDeltaTime);
+                    accumulator -= numDropped * simDeltaTime;
+                    tickStats.numDroppedTicks += numDropped;
+                    std::cerr << "[PHYSICS ENGINE ASYNC]" << std::endl
+                        << "WARNING: physics engine is running too slowly. Dropped " << numDropped << " ticks." << std::endl;
+                    break;
+                }
 
-#ifdef _DEVELOP
-            {   // Reset all the debug vis lines.
-                std::lock_guard<std::mutex> lg(mutateDebugVisLines);
-                debugVisLines.clear();
+                runSimulationTick(tempAllocator, jobSystem);
+                accumulator -= simDeltaTime;
+                ticksThisLoop++;
             }
 
-            uint64_t perfTime = SDL_GetPerformanceCounter();
-#endif
-
-            if (!globalState::isEditingMode &&
-                input::editorInputSet().playModeToggleSimulation.onAction)
+            if (ticksThisLoop > 0)
             {
-                runPhysicsSimulations = !runPhysicsSimulations;
-                debug::pushDebugMessage({
-                    .message = std::string("Set running physics simulations to ") + (runPhysicsSimulations ? "on" : "off"),
-                    });
+                tickStats.numTicks += ticksThisLoop;
+                if (ticksThisLoop > 1)
+                {
+                    tickStats.numCatchUpTicks += ticksThisLoop - 1;
+                    tickStats.numOverrunLoops++;
+                }
+
+                // Time that the latest tick would've started if it were on time. Interpolation is relative to this.
+                now = SDL_GetPerformanceCounter();
+                accumulator += (double_t)(now - prevTime) / perfFrequency * timescale;
+                prevTime = now;
+                lastTick = now - (uint64_t)(accumulator / std::max(timescale, 0.0001) * perfFrequency);
             }
 
-            // @NOTE: this is the only place where `timeScale` is used. That's
-            //        because this system is designed to be running at 40fps constantly
-            //        in real time, so it doesn't slow down or speed up with time scale.
-            // @REPLY: I thought that the system should just run in a constant 40fps. As in,
-            //         if the timescale slows down, then the tick rate should also slow down
-            //         proportionate to the timescale.  -Timo 2023/06/10
-            transformSwap();
-            input::editorInputSet().update();
-            input::simInputSet().update(simDeltaTime);
-            entityManager->INTERNALsimulationUpdate(simDeltaTime);  // @NOTE: if timescale changes, then the system just waits longer/shorter per loop.
-            if (runPhysicsSimulations)
+            // Wait for remaining time.
+            double_t remainingSec = (simDeltaTime - accumulator) / std::max(timescale, 0.0001);
+            remainingSec = std::min(remainingSec, (double_t)simDeltaTime);  // Keep checking in when time is (nearly) stopped.
+            if (remainingSec > 0.0)
             {
-                ZoneScopedN("Update Jolt phys sys");
-                physicsSystem->Update(simDeltaTime, 1, 1, &tempAllocator, &jobSystem);
+                uint64_t targetTime = prevTime + (uint64_t)(remainingSec * perfFrequency);
+                sleepUntilPrecise(targetTime);
+
+                double_t wakeErrorMS = (double_t)((int64_t)SDL_GetPerformanceCounter() - (int64_t)targetTime) * 1000.0 / perfFrequency;
+                tickStats.lastWakeErrorMS = (float_t)wakeErrorMS;
+                tickStats.maxWakeErrorMS = std::max(tickStats.maxWakeErrorMS, (float_t)wakeErrorMS);
             }
-            copyResultTransforms();
+        }
 
-#ifdef _DEVELOP
-            {
-                ZoneScopedN("Update performance metrics");
+        {
+            // @NOTE: waits for any batched queries still using `jobSystem` before it goes out of scope.
+            std::unique_lock<std::shared_mutex> lock(queryJobSystemMutex);
+            queryJobSystem = nullptr;
+        }
+    }
 
-                //
-                // Update performance metrics
-                // @COPYPASTA
-                //
-                perfTime = SDL_GetPerformanceCounter() - perfTime;
-                perfStats.simTimesUSHeadIndex = (size_t)std::fmodf((float_t)perfStats.simTimesUSHeadIndex + 1, (float_t)perfStats.simTimesUSCount);
-
-                // Find what the highest simulation time is
-                if (perfTime > perfStats.highestSimTime)
-                    perfStats.highestSimTime = perfTime;
-                else if (perfStats.simTimesUS[perfStats.simTimesUSHeadIndex] == perfStats.highestSimTime)
-                {
-                    // Former highest sim time is getting overwritten; recalculate the 2nd highest sim time.
-                    float_t nextHighestsimTime = perfTime;
-                    for (size_t i = perfStats.simTimesUSHeadIndex + 1; i < perfStats.simTimesUSHeadIndex + perfStats.simTimesUSCount; i++)
-                        nextHighestsimTime = std::max(nextHighestsimTime, perfStats.simTimesUS[i]);
-                    perfStats.highestSimTime = nextHighestsimTime;
-                }
+    //
+    // Body batching
+    // @NOTE: adding bodies one at a time takes the broadphase lock and inserts into the tree for each body. While a batch is
+    //        open, adds and removes get queued up and then go in with `AddBodiesPrepare/Finalize` and `RemoveBodies` when
+    //        the outermost batch ends. Batches are per thread, so a batch on the main thread doesn't hold back bodies made
+    //        on the simulation thread.
+    //
+    struct BodyBatch
+    {
+        size_t depth = 0;
+        std::vector<BodyID> pendingAddBodies[2];  // [0]: `EActivation::DontActivate`, [1]: `EActivation::Activate`.
+        std::vector<BodyID> pendingRemoveBodies;
+        std::vector<BodyID> pendingDestroyBodies;  // Get destroyed after `pendingRemoveBodies` is removed.
+    };
+    thread_local BodyBatch bodyBatch;
 
-                // Apply simulation time to buffer
-                perfStats.simTimesUS[perfStats.simTimesUSHeadIndex] =
-                    perfStats.simTimesUS[perfStats.simTimesUSHeadIndex + perfStats.simTimesUSCount] =
-                    perfTime;
-            }
-#endif
+    void addBody(BodyID bodyId, EActivation activation)
+    {
+        if (bodyBatch.depth > 0)
+        {
+            bodyBatch.pendingAddBodies[activation == EActivation::Activate ? 1 : 0].push_back(bodyId);
+            return;
+        }
+        physicsSystem->GetBodyInterface().AddBody(bodyId, activation);
+    }
+
+    void removeBody(BodyID bodyId, bool destroy)
+    {
+        BodyInterface& bodyInterface = physicsSystem->GetBodyInterface();
 
-            // Wait for remaining time
-            uint64_t endingTime = SDL_GetTicks64();
-            uint64_t timeDiff = endingTime - lastTick;
-            uint64_t physicsDeltaTimeInMSScaled = physicsDeltaTimeInMS / globalState::timescale;
-            if (timeDiff > physicsDeltaTimeInMSScaled)
+        // Body that never made it into the world.
+        for (auto& bodies : bodyBatch.pendingAddBodies)
+        {
+            auto it = std::find(bodies.begin(), bodies.end(), bodyId);
+            if (it != bodies.end())
             {
-                std::cerr << "ERROR: physics engine is running too slowly. (" << (timeDiff - physicsDeltaTimeInMSScaled) << "ns behind)" << std::endl;
+                bodies.erase(it);
+                if (destroy)
+                    bodyInterface.DestroyBody(bodyId);
+                return;
             }
-            else
+        }
+
+        if (bodyBatch.depth > 0)
+        {
+            bodyBatch.pendingRemoveBodies.push_back(bodyId);
+            if (destroy)
+                bodyBatch.pendingDestroyBodies.push_back(bodyId);
+            return;
+        }
+        bodyInterface.RemoveBody(bodyId);
+        if (destroy)
+            bodyInterface.DestroyBody(bodyId);
+    }
+
+    bool isBodyAdded(BodyID bodyId)
+    {
+        return physicsSystem->GetBodyInterface().IsAdded(bodyId);
+    }
+
+    void beginBodyBatch()
+    {
+        bodyBatch.depth++;
+    }
+
+    void endBodyBatch()
+    {
+        ZoneScoped;
+
+        if (bodyBatch.depth == 0)
+        {
+            std::cerr << "[END BODY BATCH]" << std::endl
+                << "ERROR: no body batch was started." << std::endl;
+            return;
+        }
+        if (--bodyBatch.depth > 0)
+            return;  // Outermost batch does the work.
+
+        BodyInterface& bodyInterface = physicsSystem->GetBodyInterface();
+        if (!bodyBatch.pendingRemoveBodies.empty())
+        {
+            bodyInterface.RemoveBodies(bodyBatch.pendingRemoveBodies.data(), (int32_t)bodyBatch.pendingRemoveBodies.size());
+            bodyBatch.pendingRemoveBodies.clear();
+        }
+        if (!bodyBatch.pendingDestroyBodies.empty())
+        {
+            bodyInterface.DestroyBodies(bodyBatch.pendingDestroyBodies.data(), (int32_t)bodyBatch.pendingDestroyBodies.size());
+            bodyBatch.pendingDestroyBodies.clear();
+        }
+
+        for (size_t i = 0; i < 2; i++)
+        {
+            std::vector<BodyID>& bodies = bodyBatch.pendingAddBodies[i];
+            if (bodies.empty())
+                continue;
+
+            BodyInterface::AddState addState = bodyInterface.AddBodiesPrepare(bodies.data(), (int32_t)bodies.size());
+            bodyInterface.AddBodiesFinalize(bodies.data(), (int32_t)bodies.size(), addState, (i == 1 ? EActivation::Activate : EActivation::DontActivate));
+            bodies.clear();
+        }
+    }
+
+    //
+    // Voxel field chunks
+    //
+    const VoxelChunk emptyVoxelChunk;  // Shared sentinel for looking up chunks that aren't stored.
+
+    inline int32_t toVoxelChunkCoord(int32_t chunkSpacePosition)
+    {
+        // Floored division, so that negative positions land in the right chunk too.
+        return (chunkSpacePosition >= 0 ?
+            chunkSpacePosition / VOXEL_CHUNK_SIZE :
+            (chunkSpacePosition - VOXEL_CHUNK_SIZE + 1) / VOXEL_CHUNK_SIZE);
+    }
+
+    constexpr uint64_t VOXEL_CHUNK_KEY_AXIS_MASK = (1ull << 21) - 1;  // 21 bits per axis.
+
+    inline uint64_t toVoxelChunkKey(int32_t cx, int32_t cy, int32_t cz)
+    {
+        return ((uint64_t)(uint32_t)cx & VOXEL_CHUNK_KEY_AXIS_MASK) << 42 |
+            ((uint64_t)(uint32_t)cy & VOXEL_CHUNK_KEY_AXIS_MASK) << 21 |
+            ((uint64_t)(uint32_t)cz & VOXEL_CHUNK_KEY_AXIS_MASK);
+    }
+
+    inline int32_t fromVoxelChunkKeyAxis(uint64_t key, uint32_t shift)
+    {
+        uint32_t bits = (uint32_t)((key >> shift) & VOXEL_CHUNK_KEY_AXIS_MASK);
+        return (int32_t)(bits << 11) >> 11;  // Sign extend.
+    }
+
+    inline size_t toVoxelIndexInChunk(int32_t lx, int32_t ly, int32_t lz)
+    {
+        return ((size_t)lx * VOXEL_CHUNK_SIZE + (size_t)ly) * VOXEL_CHUNK_SIZE + (size_t)lz;
+    }
+
+    void getVoxelDataDense(const VoxelFieldPhysicsData& vfpd, std::vector<uint8_t>& outVoxelData)
+    {
+        outVoxelData.assign(vfpd.sizeX * vfpd.sizeY * vfpd.sizeZ, 0);
+
+        // Only visit the stored chunks.
+        for (auto it = vfpd.voxelChunks.begin(); it != vfpd.voxelChunks.end(); it++)
+        {
+            int32_t cx = fromVoxelChunkKeyAxis(it->first, 42);
+            int32_t cy = fromVoxelChunkKeyAxis(it->first, 21);
+            int32_t cz = fromVoxelChunkKeyAxis(it->first, 0);
+
+            const VoxelChunk& chunk = *it->second;
+            for (int32_t lx = 0; lx < VOXEL_CHUNK_SIZE; lx++)
+            for (int32_t ly = 0; ly < VOXEL_CHUNK_SIZE; ly++)
+            for (int32_t lz = 0; lz < VOXEL_CHUNK_SIZE; lz++)
             {
-                SDL_Delay((uint32_t)(physicsDeltaTimeInMSScaled - timeDiff));
+                uint8_t data = chunk.voxels[toVoxelIndexInChunk(lx, ly, lz)];
+                if (data == 0)
+                    continue;
+
+                int32_t x = cx * VOXEL_CHUNK_SIZE + lx - vfpd.chunkSpaceOffset[0];
+                int32_t y = cy * VOXEL_CHUNK_SIZE + ly - vfpd.chunkSpaceOffset[1];
+                int32_t z = cz * VOXEL_CHUNK_SIZE + lz - vfpd.chunkSpaceOffset[2];
+                if (x < 0 || y < 0 || z < 0 ||
+                    x >= vfpd.sizeX || y >= vfpd.sizeY || z >= vfpd.sizeZ)
+                    continue;
+                outVoxelData[(size_t)x * vfpd.sizeY * vfpd.sizeZ + (size_t)y * vfpd.sizeZ + (size_t)z] = data;
             }
         }
     }
 
+    uint64_t hashVoxelData(const VoxelFieldPhysicsData& vfpd)
+    {
+        ZoneScoped;
+
+        // FNV-1a per chunk, summed up so the chunk map's order doesn't matter.
+        constexpr uint64_t fnvOffsetBasis = 14695981039346656037ull;
+        constexpr uint64_t fnvPrime = 1099511628211ull;
+        auto fnv1a = [&](uint64_t hash, const void* data, size_t numBytes) {
+            for (size_t i = 0; i < numBytes; i++)
+                hash = (hash ^ ((const uint8_t*)data)[i]) * fnvPrime;
+            return hash;
+        };
+
+        uint64_t hash = fnvOffsetBasis;
+        uint64_t sizes[3] = { vfpd.sizeX, vfpd.sizeY, vfpd.sizeZ };
+        hash = fnv1a(hash, sizes, sizeof(sizes));
+        hash = fnv1a(hash, vfpd.chunkSpaceOffset, sizeof(ivec3));
+
+        for (auto it = vfpd.voxelChunks.begin(); it != vfpd.voxelChunks.end(); it++)
+        {
+            uint64_t chunkHash = fnv1a(fnvOffsetBasis, &it->first, sizeof(uint64_t));
+            chunkHash = fnv1a(chunkHash, it->second->voxels, sizeof(it->second->voxels));
+            hash += chunkHash ^ (chunkHash >> 29);
+        }
+        return hash;
+    }
+
+    inline void markVoxelCollisionChunkDirty(VoxelFieldPhysicsData& vfpd, int32_t x, int32_t y, int32_t z)
+    {
+        vfpd.dirtyCollisionChunks.insert(toVoxelChunkKey(
+            toVoxelChunkCoord(x + vfpd.chunkSpaceOffset[0]),
+            toVoxelChunkCoord(y + vfpd.chunkSpaceOffset[1]),
+            toVoxelChunkCoord(z + vfpd.chunkSpaceOffset[2])
+        ));
+    }
+
+    void markVoxelSlopeRunDirty(VoxelFieldPhysicsData& vfpd, int32_t x, int32_t y, int32_t z, uint8_t slopeType)
+    {
+        if (slopeType < 2 || slopeType > 5)
+            return;
+
+        // Slope runs get cooked by the chunk they start in, so walk back to the start of the run.
+        bool even = (slopeType == 2 || slopeType == 4);
+        int32_t dx = (even ? 0 : 1);
+        int32_t dz = (even ? 1 : 0);
+        while (getVoxelDataAtPosition(vfpd, x - dx, y, z - dz) == slopeType)
+        {
+            x -= dx;
+            z -= dz;
+        }
+        markVoxelCollisionChunkDirty(vfpd, x, y, z);
+    }
+
     //
     // Voxel field pool
     //
@@ -806,7 +1197,7 @@ namespace physengine
     size_t voxelFieldIndices[PHYSICS_OBJECTS_MAX_CAPACITY];
     size_t numVFsCreated = 0;
 
-    VoxelFieldPhysicsData* createVoxelField(const std::string& entityGuid, mat4 transform, const size_t& sizeX, const size_t& sizeY, const size_t& sizeZ, uint8_t* voxelData)
+    VoxelFieldPhysicsData* createVoxelField(Entity* entity, mat4 transform, const size_t& sizeX, const size_t& sizeY, const size_t& sizeZ, uint8_t* voxelData, JPH::ObjectLayer objectLayer)
     {
         if (numVFsCreated < PHYSICS_OBJECTS_MAX_CAPACITY)
         {
@@ -820,13 +1211,24 @@ namespace physengine
             numVFsCreated++;
 
             // Insert in the data
-            vfpd.entityGuid = entityGuid;
+            vfpd.entity = entity;
+            vfpd.entityGuid = entity->getGUID();
             glm_mat4_copy(transform, vfpd.transform);
             vfpd.sizeX = sizeX;
             vfpd.sizeY = sizeY;
             vfpd.sizeZ = sizeZ;
-            vfpd.voxelData = voxelData;
+            glm_ivec3_zero(vfpd.chunkSpaceOffset);
+            for (size_t i = 0; i < sizeX; i++)
+            for (size_t j = 0; j < sizeY; j++)
+            for (size_t k = 0; k < sizeZ; k++)
+            {
+                uint8_t data = voxelData[i * sizeY * sizeZ + j * sizeZ + k];
+                if (data != 0)
+                    setVoxelDataAtPosition(vfpd, (int32_t)i, (int32_t)j, (int32_t)k, data);
+            }
+            delete[] voxelData;
             vfpd.bodyId = JPH::BodyID();
+            vfpd.objectLayer = objectLayer;
             vfpd.simTransformId = registerSimulationTransform();
 
             return &vfpd;
@@ -855,12 +1257,20 @@ namespace physengine
                 numVFsCreated--;
 
                 // Destroy voxel data.
-                delete[] vfpd->voxelData;
+                for (auto it = vfpd->voxelChunks.begin(); it != vfpd->voxelChunks.end(); it++)
+                    delete it->second;
+                vfpd->voxelChunks.clear();
+                vfpd->dirtyCollisionChunks.clear();
+                vfpd->collisionChunks.clear();
+                vfpd->collisionShapeChunkKeys.clear();
 
                 // Remove and delete the voxel field body.
-                BodyInterface& bodyInterface = physicsSystem->GetBodyInterface();
-                bodyInterface.RemoveBody(vfpd->bodyId);
-                bodyInterface.DestroyBody(vfpd->bodyId);
+                if (!vfpd->bodyId.IsInvalid())
+                {
+                    bodyIdToEntity[vfpd->bodyId.GetIndex()] = nullptr;
+                    removeBody(vfpd->bodyId, true);
+                }
+                vfpd->collisionShape = nullptr;
                 unregisterSimulationTransform(vfpd->simTransformId);
 
                 return true;
@@ -874,15 +1284,67 @@ namespace physengine
         if (x < 0 || y < 0 || z < 0 ||
             x >= vfpd.sizeX || y >= vfpd.sizeY || z >= vfpd.sizeZ)
             return 0;
-        return vfpd.voxelData[(size_t)x * vfpd.sizeY * vfpd.sizeZ + (size_t)y * vfpd.sizeZ + (size_t)z];
+
+        int32_t csx = x + vfpd.chunkSpaceOffset[0];
+        int32_t csy = y + vfpd.chunkSpaceOffset[1];
+        int32_t csz = z + vfpd.chunkSpaceOffset[2];
+        int32_t cx = toVoxelChunkCoord(csx);
+        int32_t cy = toVoxelChunkCoord(csy);
+        int32_t cz = toVoxelChunkCoord(csz);
+
+        auto it = vfpd.voxelChunks.find(toVoxelChunkKey(cx, cy, cz));
+        const VoxelChunk& chunk = (it == vfpd.voxelChunks.end() ? emptyVoxelChunk : *it->second);
+        return chunk.voxels[toVoxelIndexInChunk(csx - cx * VOXEL_CHUNK_SIZE, csy - cy * VOXEL_CHUNK_SIZE, csz - cz * VOXEL_CHUNK_SIZE)];
     }
 
-    bool setVoxelDataAtPosition(const VoxelFieldPhysicsData& vfpd, const int32_t& x, const int32_t& y, const int32_t& z, uint8_t data)
+    bool setVoxelDataAtPosition(VoxelFieldPhysicsData& vfpd, const int32_t& x, const int32_t& y, const int32_t& z, uint8_t data)
     {
         if (x < 0 || y < 0 || z < 0 ||
             x >= vfpd.sizeX || y >= vfpd.sizeY || z >= vfpd.sizeZ)
             return false;
-        vfpd.voxelData[(size_t)x * vfpd.sizeY * vfpd.sizeZ + (size_t)y * vfpd.sizeZ + (size_t)z] = data;
+
+        int32_t csx = x + vfpd.chunkSpaceOffset[0];
+        int32_t csy = y + vfpd.chunkSpaceOffset[1];
+        int32_t csz = z + vfpd.chunkSpaceOffset[2];
+        int32_t cx = toVoxelChunkCoord(csx);
+        int32_t cy = toVoxelChunkCoord(csy);
+        int32_t cz = toVoxelChunkCoord(csz);
+        uint64_t key = toVoxelChunkKey(cx, cy, cz);
+
+        VoxelChunk* chunk;
+        auto it = vfpd.voxelChunks.find(key);
+        if (it == vfpd.voxelChunks.end())
+        {
+            if (data == 0)
+                return true;  // Already empty.
+            chunk = new VoxelChunk;
+            vfpd.voxelChunks[key] = chunk;
+        }
+        else
+            chunk = it->second;
+
+        uint8_t& voxel = chunk->voxels[toVoxelIndexInChunk(csx - cx * VOXEL_CHUNK_SIZE, csy - cy * VOXEL_CHUNK_SIZE, csz - cz * VOXEL_CHUNK_SIZE)];
+        if (voxel != data)
+        {
+            // Mark the chunks whose collision this touches.
+            markVoxelCollisionChunkDirty(vfpd, x, y, z);
+            markVoxelCollisionChunkDirty(vfpd, x + 1, y, z);  // In case a slope run starts/stops starting right after this.
+            markVoxelCollisionChunkDirty(vfpd, x, y, z + 1);
+            markVoxelSlopeRunDirty(vfpd, x, y, z, voxel);
+            markVoxelSlopeRunDirty(vfpd, x, y, z, data);
+        }
+
+        if (voxel == 0 && data != 0)
+            chunk->numNonEmpty++;
+        else if (voxel != 0 && data == 0)
+            chunk->numNonEmpty--;
+        voxel = data;
+
+        if (chunk->numNonEmpty == 0)
+        {
+            delete chunk;
+            vfpd.voxelChunks.erase(key);
+        }
         return true;
     }
 
@@ -895,23 +1357,8 @@ namespace physengine
         glm_ivec3_mul(outOffset, ivec3{ -1, -1, -1 }, outOffset);
         glm_ivec3_add(newSize, outOffset, newSize);  // Adds on the offset.
 
-        // Create a new data grid with new bounds.
-        size_t arraySize = newSize[0] * newSize[1] * newSize[2];
-        uint8_t* newVD = new uint8_t[arraySize];
-        for (size_t i = 0; i < arraySize; i++)
-            newVD[i] = 0;  // Init the value to be empty.
-
-        for (size_t i = 0; i < vfpd.sizeX; i++)
-        for (size_t j = 0; j < vfpd.sizeY; j++)
-        for (size_t k = 0; k < vfpd.sizeZ; k++)
-        {
-            uint8_t data = vfpd.voxelData[i * vfpd.sizeY * vfpd.sizeZ + j * vfpd.sizeZ + k];
-            ivec3 newIJK;
-            glm_ivec3_add(ivec3{ (int32_t)i, (int32_t)j, (int32_t)k }, outOffset, newIJK);
-            newVD[newIJK[0] * newSize[1] * newSize[2] + newIJK[1] * newSize[2] + newIJK[2]] = data;
-        }
-        delete[] vfpd.voxelData;
-        vfpd.voxelData = newVD;
+        // Existing voxels keep their spot in chunk space, so just shift the offset.
+        glm_ivec3_sub(vfpd.chunkSpaceOffset, outOffset, vfpd.chunkSpaceOffset);
 
         // Update size for voxel data structure.
         vfpd.sizeX = (size_t)newSize[0];
@@ -924,17 +1371,36 @@ namespace physengine
 
     void shrinkVoxelFieldBoundsAuto(VoxelFieldPhysicsData& vfpd, ivec3& outOffset)
     {
-        ivec3 boundsMin = { vfpd.sizeX, vfpd.sizeY, vfpd.sizeZ };
-        ivec3 boundsMax = { 0, 0, 0 };
-        for (size_t i = 0; i < vfpd.sizeX; i++)
-        for (size_t j = 0; j < vfpd.sizeY; j++)
-        for (size_t k = 0; k < vfpd.sizeZ; k++)
-            if (getVoxelDataAtPosition(vfpd, i, j, k) != 0)
-            {
-                ivec3 ijk = { i, j, k };
-                glm_ivec3_minv(boundsMin, ijk, boundsMin);
-                glm_ivec3_maxv(boundsMax, ijk, boundsMax);
-            }
+        // Find the bounds of what's left (only the stored chunks can have anything in them).
+        ivec3 boundsMin = { std::numeric_limits<int32_t>::max(), std::numeric_limits<int32_t>::max(), std::numeric_limits<int32_t>::max() };
+        ivec3 boundsMax = { std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::min() };
+        for (auto it = vfpd.voxelChunks.begin(); it != vfpd.voxelChunks.end(); it++)
+        {
+            ivec3 chunkOrigin = {
+                fromVoxelChunkKeyAxis(it->first, 42) * VOXEL_CHUNK_SIZE - vfpd.chunkSpaceOffset[0],
+                fromVoxelChunkKeyAxis(it->first, 21) * VOXEL_CHUNK_SIZE - vfpd.chunkSpaceOffset[1],
+                fromVoxelChunkKeyAxis(it->first, 0) * VOXEL_CHUNK_SIZE - vfpd.chunkSpaceOffset[2],
+            };
+
+            const VoxelChunk& chunk = *it->second;
+            for (int32_t lx = 0; lx < VOXEL_CHUNK_SIZE; lx++)
+            for (int32_t ly = 0; ly < VOXEL_CHUNK_SIZE; ly++)
+            for (int32_t lz = 0; lz < VOXEL_CHUNK_SIZE; lz++)
+                if (chunk.voxels[toVoxelIndexInChunk(lx, ly, lz)] != 0)
+                {
+                    ivec3 ijk = { chunkOrigin[0] + lx, chunkOrigin[1] + ly, chunkOrigin[2] + lz };
+                    glm_ivec3_minv(boundsMin, ijk, boundsMin);
+                    glm_ivec3_maxv(boundsMax, ijk, boundsMax);
+                }
+        }
+
+        if (vfpd.voxelChunks.empty())
+        {
+            // Nothing left to shrink around, so leave the bounds alone.
+            glm_ivec3_zero(outOffset);
+            return;
+        }
+
         glm_ivec3_mul(boundsMin, ivec3{ -1, -1, -1 }, outOffset);
 
         // Set the new bounds to the smaller amount.
@@ -943,26 +1409,8 @@ namespace physengine
         glm_ivec3_sub(newSize, boundsMin, newSize);
 
         // @COPYPASTA
-        // Create a new data grid with new bounds.
-        size_t arraySize = newSize[0] * newSize[1] * newSize[2];
-        uint8_t* newVD = new uint8_t[arraySize];
-        for (size_t i = 0; i < arraySize; i++)
-            newVD[i] = 0;  // Init the value to be empty.
-
-        for (size_t i = 0; i < vfpd.sizeX; i++)
-        for (size_t j = 0; j < vfpd.sizeY; j++)
-        for (size_t k = 0; k < vfpd.sizeZ; k++)
-        {
-            uint8_t data = vfpd.voxelData[i * vfpd.sizeY * vfpd.sizeZ + j * vfpd.sizeZ + k];
-            if (data == 0)
-                continue;  // Skip empty spaces (to also prevent inserting into out of bounds if shrinking the array).
-
-            ivec3 newIJK;
-            glm_ivec3_add(ivec3{ (int32_t)i, (int32_t)j, (int32_t)k }, outOffset, newIJK);
-            newVD[newIJK[0] * newSize[1] * newSize[2] + newIJK[1] * newSize[2] + newIJK[2]] = data;
-        }
-        delete[] vfpd.voxelData;
-        vfpd.voxelData = newVD;
+        // Existing voxels keep their spot in chunk space, so just shift the offset.
+        glm_ivec3_sub(vfpd.chunkSpaceOffset, outOffset, vfpd.chunkSpaceOffset);
 
         // Update size for voxel data structure.
         vfpd.sizeX = (size_t)newSize[0];
@@ -975,62 +1423,71 @@ namespace physengine
         std::cout << "Shurnk to { " << vfpd.sizeX << ", " << vfpd.sizeY << ", " << vfpd.sizeZ << " }" << std::endl;
     }
 
-    void cookVoxelDataIntoShape(VoxelFieldPhysicsData& vfpd, const std::string& entityGuid, std::vector<VoxelFieldCollisionShape>& outShapes)
+    size_t getVoxelSlopeRunLength(const VoxelFieldPhysicsData& vfpd, const int32_t& x, const int32_t& y, const int32_t& z)
     {
-        BodyInterface& bodyInterface = physicsSystem->GetBodyInterface();
+        uint8_t myType = getVoxelDataAtPosition(vfpd, x, y, z);
+        if (myType < 2 || myType > 5)
+            return 0;
 
-        // Recreate shape from scratch (property/feature of static compound shape).
-        if (!vfpd.bodyId.IsInvalid())
-        {
-            bodyInterface.RemoveBody(vfpd.bodyId);
-            bodyInterface.DestroyBody(vfpd.bodyId);
-            vfpd.bodyId = BodyID();
-        }
+        // Runs go along the uphill axis (Z for N/S slopes, X for E/W slopes).
+        bool even = (myType == 2 || myType == 4);
+        int32_t dx = (even ? 0 : 1);
+        int32_t dz = (even ? 1 : 0);
+        if (getVoxelDataAtPosition(vfpd, x - dx, y, z - dz) == myType)
+            return 0;  // Middle of a run.
+
+        size_t length = 1;
+        while (getVoxelDataAtPosition(vfpd, x + dx * (int32_t)length, y, z + dz * (int32_t)length) == myType)
+            length++;
+        return length;
+    }
 
+    void cookVoxelChunkIntoShapes(const VoxelFieldPhysicsData& vfpd, const VoxelChunk& chunk, ivec3 chunkOrigin, std::vector<VoxelFieldCollisionShape>& outShapes)
+    {
         // Create shape for each voxel.
         // (Simple greedy algorithm that pushes as far as possible in one dimension, then in another while throwing away portions that don't fit)
         // (Actually..... right now it's not a greedy algorithm and it's just a simple depth first flood that's good enough for now)  -Timo 2023/09/27
-        Ref<StaticCompoundShapeSettings> compoundShape = new StaticCompoundShapeSettings;
-
-        bool* processed = new bool[vfpd.sizeX * vfpd.sizeY * vfpd.sizeZ];  // Init processing datastructure
-        for (size_t i = 0; i < vfpd.sizeX * vfpd.sizeY * vfpd.sizeZ; i++)
-            processed[i] = false;
-
-        for (size_t i = 0; i < vfpd.sizeX; i++)
-        for (size_t j = 0; j < vfpd.sizeY; j++)
-        for (size_t k = 0; k < vfpd.sizeZ; k++)
+        // @NOTE: filled spaces only merge inside of the chunk, which makes the same collision just with more boxes.
+        //        Slope runs can't be cut up like that since it'd change the angle, so they're cooked whole by the chunk they start in.
+        constexpr size_t size = VOXEL_CHUNK_SIZE;
+        const uint8_t* voxelData = chunk.voxels;
+        bool processed[size * size * size] = {};  // Init processing datastructure
+
+        for (size_t i = 0; i < size; i++)
+        for (size_t j = 0; j < size; j++)
+        for (size_t k = 0; k < size; k++)
         {
-            size_t idx = i * vfpd.sizeY * vfpd.sizeZ + j * vfpd.sizeZ + k;
-            if (vfpd.voxelData[idx] == 0 || processed[idx])
+            size_t idx = i * size * size + j * size + k;
+            if (voxelData[idx] == 0 || processed[idx])
                 continue;
             
             // Start greedy search.
-            if (vfpd.voxelData[idx] == 1)
+            if (voxelData[idx] == 1)
             {
-                uint8_t myType = vfpd.voxelData[idx];
+                uint8_t myType = voxelData[idx];
 
                 // Filled space search.
                 size_t encX = 1,  // Encapsulation sizes. Multiply it all together to get the count of encapsulation.
                     encY = 1,
                     encZ = 1;
-                for (size_t x = i + 1; x < vfpd.sizeX; x++)
+                for (size_t x = i + 1; x < size; x++)
                 {
                     // Test whether next position is viable.
-                    size_t idx = x * vfpd.sizeY * vfpd.sizeZ + j * vfpd.sizeZ + k;
-                    bool viable = (vfpd.voxelData[idx] == myType && !processed[idx]);
+                    size_t idx = x * size * size + j * size + k;
+                    bool viable = (voxelData[idx] == myType && !processed[idx]);
                     if (!viable)
                         break;  // Exit if not viable.
                     
                     encX++; // March forward.
                 }
-                for (size_t y = j + 1; y < vfpd.sizeY; y++)
+                for (size_t y = j + 1; y < size; y++)
                 {
                     // Test whether next row of positions are viable.
                     bool viable = true;
                     for (size_t x = i; x < i + encX; x++)
                     {
-                        size_t idx = x * vfpd.sizeY * vfpd.sizeZ + y * vfpd.sizeZ + k;
-                        viable &= (vfpd.voxelData[idx] == myType && !processed[idx]);
+                        size_t idx = x * size * size + y * size + k;
+                        viable &= (voxelData[idx] == myType && !processed[idx]);
                         if (!viable)
                             break;
                     }
@@ -1040,15 +1497,15 @@ namespace physengine
                     
                     encY++; // March forward.
                 }
-                for (size_t z = k + 1; z < vfpd.sizeZ; z++)
+                for (size_t z = k + 1; z < size; z++)
                 {
                     // Test whether next sheet of positions are viable.
                     bool viable = true;
                     for (size_t x = i; x < i + encX; x++)
                     for (size_t y = j; y < j + encY; y++)
                     {
-                        size_t idx = x * vfpd.sizeY * vfpd.sizeZ + y * vfpd.sizeZ + z;
-                        viable &= (vfpd.voxelData[idx] == myType && !processed[idx]);
+                        size_t idx = x * size * size + y * size + z;
+                        viable &= (voxelData[idx] == myType && !processed[idx]);
                         if (!viable)
                             break;
                     }
@@ -1064,68 +1521,42 @@ namespace physengine
                 for (size_t y = 0; y < encY; y++)
                 for (size_t z = 0; z < encZ; z++)
                 {
-                    size_t idx = (x + i) * vfpd.sizeY * vfpd.sizeZ + (y + j) * vfpd.sizeZ + (z + k);
+                    size_t idx = (x + i) * size * size + (y + j) * size + (z + k);
                     processed[idx] = true;
                 }
 
-                // Create shape.
+                // Add shape props to `outShapes`.
                 Vec3 extent((float_t)encX * 0.5f, (float_t)encY * 0.5f, (float_t)encZ * 0.5f);
                 Vec3 origin((float_t)i + extent.GetX(), (float_t)j + extent.GetY(), (float_t)k + extent.GetZ());
                 Quat rotation = Quat::sIdentity();
-                compoundShape->AddShape(origin, rotation, new BoxShape(extent));
 
-                // Add shape props to `outShapes`.
                 VoxelFieldCollisionShape vfcs = {};
                 glm_vec3_copy(vec3{ origin.GetX(), origin.GetY(), origin.GetZ() }, vfcs.origin);
                 glm_quat_copy(versor{ rotation.GetX(), rotation.GetY(), rotation.GetZ(), rotation.GetW() }, vfcs.rotation);
                 glm_vec3_copy(vec3{ extent.GetX(), extent.GetY(), extent.GetZ() }, vfcs.extent);
                 outShapes.push_back(vfcs);
             }
-            else if (vfpd.voxelData[idx] >= 2)
+            else if (voxelData[idx] >= 2)
             {
-                uint8_t myType = vfpd.voxelData[idx];
+                uint8_t myType = voxelData[idx];
                 bool even = (myType == 2 || myType == 4);
 
                 // Slope space search.
-                size_t length = 1;   // Amount slope takes to go down 1 level.
+                size_t length = getVoxelSlopeRunLength(vfpd, chunkOrigin[0] + (int32_t)i, chunkOrigin[1] + (int32_t)j, chunkOrigin[2] + (int32_t)k);  // Amount slope takes to go down 1 level.
                 size_t width = 1;    // # spaces wide the same slope pattern goes.
                 size_t repeats = 1;  // # times this pattern repeats downward.
+                if (length == 0)
+                    continue;  // Part of a run that started earlier.
 
-                // Get length dimension.
-                for (size_t l = (even ? k : i) + 1; l < (even ? vfpd.sizeZ : vfpd.sizeX); l++)
+                // Get width dimension (neighboring runs that start and end at the same spots).
+                for (size_t w = (even ? i : k) + 1; w < size; w++)
                 {
-                    // Test whether next position is viable.
-                    size_t idx;
-                    if (even)
-                        idx = i * vfpd.sizeY * vfpd.sizeZ + j * vfpd.sizeZ + l;
-                    else
-                        idx = l * vfpd.sizeY * vfpd.sizeZ + j * vfpd.sizeZ + k;
-
-                    bool viable = (vfpd.voxelData[idx] == myType && !processed[idx]);
-                    if (!viable)
-                        break;  // Exit if not viable.
-                    
-                    length++; // March forward.
-                }
-
-                // Get width dimension.
-                for (size_t w = (even ? i : k) + 1; w < (even ? vfpd.sizeX : vfpd.sizeZ); w++)
-                {
-                    // Test whether next row of positions are viable.
-                    bool viable = true;
-                    for (size_t l = (even ? k : i); l < (even ? k : i) + length; l++)
-                    {
-                        size_t idx;
-                        if (even)
-                            idx = w * vfpd.sizeY * vfpd.sizeZ + j * vfpd.sizeZ + l;
-                        else
-                            idx = l * vfpd.sizeY * vfpd.sizeZ + j * vfpd.sizeZ + w;
-
-                        viable &= (vfpd.voxelData[idx] == myType && !processed[idx]);
-                        if (!viable)
-                            break;
-                    }
-
+                    size_t x = (even ? w : i);
+                    size_t z = (even ? k : w);
+                    size_t idx = x * size * size + j * size + z;
+                    bool viable = (voxelData[idx] == myType &&
+                        !processed[idx] &&
+                        getVoxelSlopeRunLength(vfpd, chunkOrigin[0] + (int32_t)x, chunkOrigin[1] + (int32_t)j, chunkOrigin[2] + (int32_t)z) == length);
                     if (!viable)
                         break;  // Exit if not viable.
                     
@@ -1134,11 +1565,10 @@ namespace physengine
 
                 // @TODO: get repeats.
 
-                // Mark all claimed as processed.
-                for (size_t x = 0; x < (even ? width : length); x++)
-                for (size_t z = 0; z < (even ? length : width); z++)
+                // Mark all claimed run starts as processed.
+                for (size_t w = 0; w < width; w++)
                 {
-                    size_t idx = (x + i) * vfpd.sizeY * vfpd.sizeZ + j * vfpd.sizeZ + (z + k);
+                    size_t idx = (even ? (i + w) * size * size + j * size + k : i * size * size + j * size + (k + w));
                     processed[idx] = true;
                 }
 
@@ -1171,8 +1601,6 @@ namespace physengine
 
                 Vec3 origin = Vec3{ (float_t)i, (float_t)j + yoff, (float_t)k } + rotation * (extent + Vec3(0.0f, -realHeight, 0.0f));
 
-                compoundShape->AddShape(origin, rotation, new BoxShape(extent));
-
                 // Add shape props to `outShapes`.
                 // @COPYPASTA
                 VoxelFieldCollisionShape vfcs = {};
@@ -1182,11 +1610,95 @@ namespace physengine
                 outShapes.push_back(vfcs);
             }
         }
+    }
+
+    inline void getVoxelChunkOrigin(const VoxelFieldPhysicsData& vfpd, uint64_t chunkKey, ivec3& outOrigin)
+    {
+        outOrigin[0] = fromVoxelChunkKeyAxis(chunkKey, 42) * VOXEL_CHUNK_SIZE - vfpd.chunkSpaceOffset[0];
+        outOrigin[1] = fromVoxelChunkKeyAxis(chunkKey, 21) * VOXEL_CHUNK_SIZE - vfpd.chunkSpaceOffset[1];
+        outOrigin[2] = fromVoxelChunkKeyAxis(chunkKey, 0) * VOXEL_CHUNK_SIZE - vfpd.chunkSpaceOffset[2];
+    }
+
+    bool restoreVoxelFieldShapesFromCache(VoxelFieldPhysicsData& vfpd);
+
+    void cookVoxelDataIntoShape(VoxelFieldPhysicsData& vfpd, std::vector<VoxelFieldCollisionShape>& outShapes)
+    {
+        ZoneScoped;
+        BodyInterface& bodyInterface = physicsSystem->GetBodyInterface();
+
+        // Skip cooking if the shapes are already cooked in the shape cache.
+        if (vfpd.bodyId.IsInvalid())
+            restoreVoxelFieldShapesFromCache(vfpd);
 
-        if (compoundShape->mSubShapes.size() == 0)
-            return;  // Cannot create empty body.
+        // Re-cook the changed chunks.
+        for (uint64_t key : vfpd.dirtyCollisionChunks)
+        {
+            auto it = vfpd.voxelChunks.find(key);
+            if (it == vfpd.voxelChunks.end())
+            {
+                vfpd.collisionChunks.erase(key);  // Chunk got emptied out.
+                continue;
+            }
+
+            ivec3 chunkOrigin;
+            getVoxelChunkOrigin(vfpd, key, chunkOrigin);
+            std::vector<VoxelFieldCollisionShape> shapes;
+            cookVoxelChunkIntoShapes(vfpd, *it->second, chunkOrigin, shapes);
+            if (shapes.empty())
+            {
+                vfpd.collisionChunks.erase(key);  // Only has the ends of slope runs owned by other chunks.
+                continue;
+            }
+
+            Ref<StaticCompoundShapeSettings> chunkShape = new StaticCompoundShapeSettings;
+            for (VoxelFieldCollisionShape& vfcs : shapes)
+                chunkShape->AddShape(
+                    Vec3(vfcs.origin[0], vfcs.origin[1], vfcs.origin[2]),
+                    Quat(vfcs.rotation[0], vfcs.rotation[1], vfcs.rotation[2], vfcs.rotation[3]),
+                    new BoxShape(Vec3(vfcs.extent[0], vfcs.extent[1], vfcs.extent[2]))
+                );
+            ShapeSettings::ShapeResult result = chunkShape->Create();
+            if (result.HasError())
+            {
+                std::cerr << "[COOKING VOXEL SHAPES]" << std::endl
+                    << "ERROR: chunk shape creation failed: " << result.GetError() << std::endl;
+                vfpd.collisionChunks.erase(key);
+                continue;
+            }
+
+            VoxelFieldCollisionChunk& collisionChunk = vfpd.collisionChunks[key];
+            collisionChunk.shape = result.Get();
+            collisionChunk.shapes = std::move(shapes);
+            collisionChunk.isPlaced = false;
+        }
+        vfpd.dirtyCollisionChunks.clear();
+
+        // Add shape props to `outShapes`.
+        for (auto& [key, collisionChunk] : vfpd.collisionChunks)
+        {
+            ivec3 chunkOrigin;
+            getVoxelChunkOrigin(vfpd, key, chunkOrigin);
+            for (VoxelFieldCollisionShape vfcs : collisionChunk.shapes)
+            {
+                glm_vec3_add(vfcs.origin, vec3{ (float_t)chunkOrigin[0], (float_t)chunkOrigin[1], (float_t)chunkOrigin[2] }, vfcs.origin);
+                outShapes.push_back(vfcs);
+            }
+        }
+
+        if (vfpd.collisionChunks.empty())
+        {
+            // Cannot have empty body.
+            if (!vfpd.bodyId.IsInvalid())
+            {
+                bodyIdToEntity[vfpd.bodyId.GetIndex()] = nullptr;
+                removeBody(vfpd.bodyId, true);
+                vfpd.bodyId = BodyID();
+            }
+            vfpd.collisionShape = nullptr;
+            vfpd.collisionShapeChunkKeys.clear();
+            return;
+        }
 
-        // Create body.
         vec4 pos;
         mat4 rot;
         vec3 sca;
@@ -1194,13 +1706,88 @@ namespace physengine
         versor rotV;
         glm_mat4_quat(rot, rotV);
 
-        // DYNAMIC is set so that voxel field can move around with the influence of other physics objects.
-        vfpd.bodyId = bodyInterface.CreateBody(BodyCreationSettings(compoundShape, RVec3(pos[0], pos[1], pos[2]), Quat(rotV[0], rotV[1], rotV[2], rotV[3]), EMotionType::Dynamic, Layers::MOVING))->GetID();
-        bodyInterface.SetGravityFactor(vfpd.bodyId, 0.0f);
-        bodyInterface.AddBody(vfpd.bodyId, EActivation::DontActivate);
+        if (vfpd.bodyId.IsInvalid())
+        {
+            // Create body.
+            if (vfpd.collisionShape == nullptr)  // @NOTE: already set if it came from the cooking snapshot.
+            {
+                Ref<MutableCompoundShapeSettings> compoundShapeSettings = new MutableCompoundShapeSettings;
+                vfpd.collisionShapeChunkKeys.clear();
+                for (auto& [key, collisionChunk] : vfpd.collisionChunks)
+                {
+                    getVoxelChunkOrigin(vfpd, key, collisionChunk.placedOrigin);
+                    collisionChunk.isPlaced = true;
+                    compoundShapeSettings->AddShape(Vec3((float_t)collisionChunk.placedOrigin[0], (float_t)collisionChunk.placedOrigin[1], (float_t)collisionChunk.placedOrigin[2]), Quat::sIdentity(), collisionChunk.shape);
+                    vfpd.collisionShapeChunkKeys.push_back(key);
+                }
+                vfpd.collisionShape = static_cast<MutableCompoundShape*>(compoundShapeSettings->Create().Get().GetPtr());
+            }
 
-        // Add guid into references.
-        bodyIdToEntityGuidMap[vfpd.bodyId.GetIndex()] = entityGuid;
+            // DYNAMIC is set so that voxel field can move around with the influence of other physics objects.
+            // @NOTE: the object layer is what decides what the field collides with (i.e. static terrain in
+            //        `NON_MOVING` doesn't get pair tested against other terrain or the gondolas).
+            vfpd.bodyId = bodyInterface.CreateBody(BodyCreationSettings(vfpd.collisionShape, RVec3(pos[0], pos[1], pos[2]), Quat(rotV[0], rotV[1], rotV[2], rotV[3]), EMotionType::Dynamic, vfpd.objectLayer))->GetID();
+            bodyInterface.SetGravityFactor(vfpd.bodyId, 0.0f);
+            addBody(vfpd.bodyId, EActivation::DontActivate);
+
+            // Add entity into references.
+            bodyIdToEntity[vfpd.bodyId.GetIndex()] = vfpd.entity;
+            return;
+        }
+
+        // Swap the changed chunks into the existing shape.
+        Vec3 prevCenterOfMass;
+        {
+            BodyLockWrite lock(physicsSystem->GetBodyLockInterface(), vfpd.bodyId);
+            if (!lock.Succeeded())
+            {
+                std::cerr << "[COOKING VOXEL SHAPES]" << std::endl
+                    << "ERROR: could not lock voxel field body of " << vfpd.entityGuid << std::endl;
+                return;
+            }
+
+            MutableCompoundShape& compoundShape = *vfpd.collisionShape;
+            prevCenterOfMass = compoundShape.GetCenterOfMass();
+
+            // Remove chunks that are gone (backwards so the indices stay put).
+            for (int64_t i = (int64_t)vfpd.collisionShapeChunkKeys.size() - 1; i >= 0; i--)
+                if (vfpd.collisionChunks.find(vfpd.collisionShapeChunkKeys[i]) == vfpd.collisionChunks.end())
+                {
+                    compoundShape.RemoveShape((uint)i);
+                    vfpd.collisionShapeChunkKeys.erase(vfpd.collisionShapeChunkKeys.begin() + i);
+                }
+
+            // Update re-cooked chunks, and move all chunks if the bounds changed.
+            for (size_t i = 0; i < vfpd.collisionShapeChunkKeys.size(); i++)
+            {
+                uint64_t key = vfpd.collisionShapeChunkKeys[i];
+                VoxelFieldCollisionChunk& collisionChunk = vfpd.collisionChunks[key];
+                ivec3 chunkOrigin;
+                getVoxelChunkOrigin(vfpd, key, chunkOrigin);
+                Vec3 position((float_t)chunkOrigin[0], (float_t)chunkOrigin[1], (float_t)chunkOrigin[2]);
+                if (!collisionChunk.isPlaced)
+                    compoundShape.ModifyShape((uint)i, position, Quat::sIdentity(), collisionChunk.shape);
+                else if (glm_ivec3_distance2(chunkOrigin, collisionChunk.placedOrigin) != 0)
+                    compoundShape.ModifyShape((uint)i, position, Quat::sIdentity());
+                glm_ivec3_copy(chunkOrigin, collisionChunk.placedOrigin);
+                collisionChunk.isPlaced = true;
+            }
+
+            // Add new chunks.
+            for (auto& [key, collisionChunk] : vfpd.collisionChunks)
+            {
+                if (collisionChunk.isPlaced)
+                    continue;
+                getVoxelChunkOrigin(vfpd, key, collisionChunk.placedOrigin);
+                collisionChunk.isPlaced = true;
+                compoundShape.AddShape(Vec3((float_t)collisionChunk.placedOrigin[0], (float_t)collisionChunk.placedOrigin[1], (float_t)collisionChunk.placedOrigin[2]), Quat::sIdentity(), collisionChunk.shape);
+                vfpd.collisionShapeChunkKeys.push_back(key);
+            }
+
+            compoundShape.AdjustCenterOfMass();  // Since it's a dynamic body.
+        }
+        bodyInterface.NotifyShapeChanged(vfpd.bodyId, prevCenterOfMass, true, EActivation::DontActivate);
+        bodyInterface.SetPositionAndRotation(vfpd.bodyId, RVec3(pos[0], pos[1], pos[2]), Quat(rotV[0], rotV[1], rotV[2], rotV[3]), EActivation::DontActivate);
     }
 
     void setVoxelFieldBodyTransform(VoxelFieldPhysicsData& vfpd, vec3 newPosition, versor newRotation)
@@ -1211,7 +1798,8 @@ namespace physengine
         Quat newRotationJolt(newRotation[0], newRotation[1], newRotation[2], newRotation[3]);
 
         EActivation activation = EActivation::DontActivate;
-        if (bodyInterface.GetMotionType(vfpd.bodyId) == EMotionType::Dynamic)
+        if (bodyInterface.GetMotionType(vfpd.bodyId) == EMotionType::Dynamic &&
+            isBodyAdded(vfpd.bodyId))  // Can't activate a body still waiting in a batch.
             activation = EActivation::Activate;
         bodyInterface.SetPositionAndRotation(vfpd.bodyId, newPositionReal, newRotationJolt, activation);
     }
@@ -1228,6 +1816,13 @@ namespace physengine
         physicsSystem->GetBodyInterface().SetMotionType(vfpd.bodyId, (isKinematic ? EMotionType::Kinematic : EMotionType::Dynamic), EActivation::DontActivate);
     }
 
+    void setVoxelFieldObjectLayer(VoxelFieldPhysicsData& vfpd, JPH::ObjectLayer objectLayer)
+    {
+        vfpd.objectLayer = objectLayer;
+        if (!vfpd.bodyId.IsInvalid())
+            physicsSystem->GetBodyInterface().SetObjectLayer(vfpd.bodyId, objectLayer);
+    }
+
     //
     // Capsule pool
     //
@@ -1235,7 +1830,7 @@ namespace physengine
     size_t capsuleIndices[PHYSICS_OBJECTS_MAX_CAPACITY];
     size_t numCapsCreated = 0;
 
-    CapsulePhysicsData* createCharacter(const std::string& entityGuid, vec3 position, const float_t& radius, const float_t& height, bool enableCCD)
+    CapsulePhysicsData* createCharacter(Entity* entity, vec3 position, const float_t& radius, const float_t& height, bool enableCCD)
     {
         if (numCapsCreated < PHYSICS_OBJECTS_MAX_CAPACITY)
         {
@@ -1249,7 +1844,8 @@ namespace physengine
             numCapsCreated++;
 
             // Insert in the data
-            cpd.entityGuid = entityGuid;
+            cpd.entity = entity;
+            cpd.entityGuid = entity->getGUID();
             glm_vec3_copy(position, cpd.currentCOMPosition);
             glm_vec3_copy(position, cpd.prevCOMPosition);
             cpd.radius = radius;
@@ -1260,7 +1856,7 @@ namespace physengine
 
             Ref<CharacterSettings> settings = new CharacterSettings;
             settings->mMaxSlopeAngle = glm_rad(45.0f);
-            settings->mLayer = Layers::MOVING;
+            settings->mLayer = Layers::CHARACTER;
             settings->mShape = capsuleShape;
 
             // @NOTE: this was in the past 0.0f, but after introducing the slightest slope, the character starts sliding down.
@@ -1273,11 +1869,11 @@ namespace physengine
             if (enableCCD)
                 physicsSystem->GetBodyInterface().SetMotionQuality(cpd.character->GetBodyID(), EMotionQuality::LinearCast);
 
-            cpd.character->AddToPhysicsSystem(EActivation::Activate);
+            addBody(cpd.character->GetBodyID(), EActivation::Activate);
             cpd.simTransformId = registerSimulationTransform();
 
-            // Add guid into references.
-            bodyIdToEntityGuidMap[cpd.character->GetBodyID().GetIndex()] = entityGuid;
+            // Add entity into references.
+            bodyIdToEntity[cpd.character->GetBodyID().GetIndex()] = entity;
 
             return &cpd;
         }
@@ -1304,7 +1900,8 @@ namespace physengine
                 numCapsCreated--;
 
                 // Remove and delete the physics capsule.
-                cpd->character->RemoveFromPhysicsSystem();
+                bodyIdToEntity[cpd->character->GetBodyID().GetIndex()] = nullptr;
+                removeBody(cpd->character->GetBodyID(), false);
                 unregisterSimulationTransform(cpd->simTransformId);
 
                 return true;
@@ -1330,7 +1927,8 @@ namespace physengine
 
     void setCharacterPosition(CapsulePhysicsData& cpd, vec3 position)
     {
-        cpd.character->SetPosition(RVec3(position[0], position[1] - collisionTolerance * 0.5f, position[2]));
+        EActivation activation = (isBodyAdded(cpd.character->GetBodyID()) ? EActivation::Activate : EActivation::DontActivate);  // Can't activate a body still waiting in a batch.
+        cpd.character->SetPosition(RVec3(position[0], position[1] - collisionTolerance * 0.5f, position[2]), activation);
     }
 
     void moveCharacter(CapsulePhysicsData& cpd, vec3 velocity)
@@ -1362,11 +1960,228 @@ namespace physengine
         return cpd.character->IsSlopeTooSteep(normal);
     }
 
+    //
+    // Cooked voxel shape cache
+    // @NOTE: the chunk shapes are immutable, so fields with the same voxel data can share them. Each
+    //        field still gets its own compound shape built when its body gets created.
+    //
+    const std::string VOXEL_SHAPE_CACHE_TAG = "Solanine voxel shape cache";
+    constexpr uint32_t VOXEL_SHAPE_CACHE_VERSION = 1;
+    constexpr uint64_t VOXEL_SHAPE_CACHE_MAX_CHUNKS_PER_FIELD = 1 << 16;  // Way more than any field has. Only for catching a corrupt count.
+
+    struct CachedVoxelCollisionChunk
+    {
+        uint64_t key;
+        RefConst<Shape> shape;
+        std::vector<VoxelFieldCollisionShape> shapes;
+    };
+
+    std::mutex voxelShapeCacheMutex;
+    std::unordered_map<uint64_t, std::vector<CachedVoxelCollisionChunk>> voxelShapeCache;  // Keyed by `hashVoxelData()`.
+    bool voxelShapeCacheIsLoaded = false;
+    bool voxelShapeCacheIsStale = false;
+
+    void loadVoxelShapeCache(const std::string& fname)
+    {
+        ZoneScoped;
+        std::lock_guard<std::mutex> lg(voxelShapeCacheMutex);
+
+        voxelShapeCache.clear();
+        voxelShapeCacheIsLoaded = true;
+        voxelShapeCacheIsStale = false;
+
+        std::ifstream infile(fname, std::ios::binary);
+        if (!infile.is_open())
+            return;  // No cache yet.
+        std::string data((std::istreambuf_iterator<char>(infile)), std::istreambuf_iterator<char>());
+
+        StateRecorderImpl recorder;
+        recorder.WriteBytes(data.data(), data.size());
+        recorder.Rewind();
+
+        std::string tag;
+        uint32_t version = 0;
+        recorder.Read(tag);
+        recorder.Read(version);
+        if (recorder.IsFailed() || tag != VOXEL_SHAPE_CACHE_TAG || version != VOXEL_SHAPE_CACHE_VERSION)
+        {
+            std::cerr << "[LOAD VOXEL SHAPE CACHE]" << std::endl
+                << "WARNING: \"" << fname << "\" is not a voxel shape cache or is an old version. It will be re-cooked." << std::endl;
+            voxelShapeCacheIsStale = true;
+            return;
+        }
+
+        Shape::IDToShapeMap shapeMap;
+        Shape::IDToMaterialMap materialMap;
+        uint64_t numEntries = 0;
+        recorder.Read(numEntries);
+        for (uint64_t i = 0; i < numEntries && !recorder.IsFailed(); i++)
+        {
+            uint64_t hash = 0;
+            uint64_t numChunks = 0;
+            recorder.Read(hash);
+            recorder.Read(numChunks);
+            if (recorder.IsFailed() || numChunks > VOXEL_SHAPE_CACHE_MAX_CHUNKS_PER_FIELD)
+            {
+                // @NOTE: bail before allocating anything with a count that came out of a broken file.
+                std::cerr << "[LOAD VOXEL SHAPE CACHE]" << std::endl
+                    << "ERROR: \"" << fname << "\" is truncated or corrupt. It will be re-cooked." << std::endl;
+                voxelShapeCache.clear();
+                voxelShapeCacheIsStale = true;
+                return;
+            }
+
+            std::vector<CachedVoxelCollisionChunk> chunks(numChunks);
+            for (CachedVoxelCollisionChunk& chunk : chunks)
+            {
+                recorder.Read(chunk.key);
+                Shape::ShapeResult result = Shape::sRestoreWithChildren(recorder, shapeMap, materialMap);
+                if (!result.IsValid())
+                {
+                    std::cerr << "[LOAD VOXEL SHAPE CACHE]" << std::endl
+                        << "ERROR: could not restore a chunk shape in \"" << fname << "\". It will be re-cooked." << std::endl;
+                    voxelShapeCache.clear();
+                    voxelShapeCacheIsStale = true;
+                    return;
+                }
+                chunk.shape = result.Get();
+                recorder.Read(chunk.shapes);
+            }
+            voxelShapeCache[hash] = std::move(chunks);
+        }
+
+        if (recorder.IsFailed())
+        {
+            std::cerr << "[LOAD VOXEL SHAPE CACHE]" << std::endl
+                << "ERROR: \"" << fname << "\" ended early. It will be re-cooked." << std::endl;
+            voxelShapeCache.clear();
+            voxelShapeCacheIsStale = true;
+        }
+    }
+
+    bool saveVoxelShapeCache(const std::string& fname)
+    {
+        ZoneScoped;
+
+        // @NOTE: runs at the start of a simulation tick (see `requestSaveVoxelShapeCache()`), so that
+        //        no voxel field is getting re-cooked by its simulation update while this reads the shapes.
+
+        StateRecorderImpl recorder;
+        Shape::ShapeToIDMap shapeMap;
+        Shape::MaterialToIDMap materialMap;
+        std::unordered_set<uint64_t> writtenHashes;
+        std::vector<const VoxelFieldPhysicsData*> cookedVFs;
+        std::vector<uint64_t> cookedVFHashes;
+        for (size_t i = 0; i < numVFsCreated; i++)
+        {
+            const VoxelFieldPhysicsData& vfpd = voxelFieldPool[voxelFieldIndices[i]];
+            if (!vfpd.dirtyCollisionChunks.empty())
+                continue;  // Not cooked.
+
+            uint64_t hash = hashVoxelData(vfpd);
+            if (writtenHashes.insert(hash).second)
+            {
+                cookedVFs.push_back(&vfpd);
+                cookedVFHashes.push_back(hash);
+            }
+        }
+
+        recorder.Write(VOXEL_SHAPE_CACHE_TAG);
+        recorder.Write(VOXEL_SHAPE_CACHE_VERSION);
+        recorder.Write((uint64_t)cookedVFs.size());
+        for (size_t i = 0; i < cookedVFs.size(); i++)
+        {
+            recorder.Write(cookedVFHashes[i]);
+            recorder.Write((uint64_t)cookedVFs[i]->collisionChunks.size());
+            for (auto& [key, collisionChunk] : cookedVFs[i]->collisionChunks)
+            {
+                recorder.Write(key);
+                collisionChunk.shape->SaveWithChildren(recorder, shapeMap, materialMap);
+                recorder.Write(collisionChunk.shapes);
+            }
+        }
+
+        std::ofstream outfile(fname, std::ios::binary);
+        if (!outfile.is_open())
+        {
+            std::cerr << "[SAVE VOXEL SHAPE CACHE]" << std::endl
+                << "ERROR: could not open \"" << fname << "\" for writing." << std::endl;
+            return false;
+        }
+        std::string data = recorder.GetData();
+        outfile.write(data.data(), data.size());
+        return true;
+    }
+
+    std::mutex pendingVoxelShapeCacheSavesMutex;
+    std::vector<std::string> pendingVoxelShapeCacheSaves;
+
+    void requestSaveVoxelShapeCache(const std::string& fname)
+    {
+        std::lock_guard<std::mutex> lg(pendingVoxelShapeCacheSavesMutex);
+        if (std::find(pendingVoxelShapeCacheSaves.begin(), pendingVoxelShapeCacheSaves.end(), fname) == pendingVoxelShapeCacheSaves.end())
+            pendingVoxelShapeCacheSaves.push_back(fname);
+    }
+
+    void applyPendingSaveVoxelShapeCaches()
+    {
+        std::vector<std::string> fnames;
+        {
+            std::lock_guard<std::mutex> lg(pendingVoxelShapeCacheSavesMutex);
+            if (pendingVoxelShapeCacheSaves.empty())
+                return;
+            fnames.swap(pendingVoxelShapeCacheSaves);
+        }
+        for (const std::string& fname : fnames)
+            saveVoxelShapeCache(fname);
+    }
+
+    bool clearVoxelShapeCache()
+    {
+        std::lock_guard<std::mutex> lg(voxelShapeCacheMutex);
+        voxelShapeCache.clear();
+        voxelShapeCacheIsLoaded = false;
+        bool wasStale = voxelShapeCacheIsStale;
+        voxelShapeCacheIsStale = false;
+        return wasStale;
+    }
+
+    bool restoreVoxelFieldShapesFromCache(VoxelFieldPhysicsData& vfpd)
+    {
+        std::lock_guard<std::mutex> lg(voxelShapeCacheMutex);
+        if (!voxelShapeCacheIsLoaded)
+            return false;
+
+        auto it = voxelShapeCache.find(hashVoxelData(vfpd));
+        if (it == voxelShapeCache.end())
+        {
+            voxelShapeCacheIsStale = true;  // This one has to get cooked.
+            return false;
+        }
+
+        ZoneScoped;
+        vfpd.collisionChunks.clear();
+        for (const CachedVoxelCollisionChunk& chunk : it->second)
+        {
+            VoxelFieldCollisionChunk& collisionChunk = vfpd.collisionChunks[chunk.key];
+            collisionChunk.shape = chunk.shape;
+            collisionChunk.shapes = chunk.shapes;
+            collisionChunk.isPlaced = false;
+        }
+        vfpd.dirtyCollisionChunks.clear();
+        return true;
+    }
+
     void transformSwap()
     {
         ZoneScoped;
 
-        simSetOffset++;
+        size_t simSetOffsetCopy = ++simSetOffset;
+
+        // Start the change list of the new next sim set.
+        SimulationInterpolationSet& nextSimSet = *simSetChain[(simSetOffsetCopy + 2) % 3];
+        nextSimSet.stamp = simSetOffsetCopy + 2;
+        nextSimSet.numChangedIndices = 0;
     }
 
     void copyResultTransforms()
@@ -1409,7 +2224,8 @@ namespace physengine
 
     inline float_t getPhysicsAlpha()
     {
-        return (SDL_GetTicks64() - lastTick) * oneOverPhysicsDeltaTimeInMS * globalState::timescale;
+        static const float_t oneOverPerfFrequency = 1.0f / (float_t)SDL_GetPerformanceFrequency();
+        return (float_t)(SDL_GetPerformanceCounter() - lastTick) * oneOverPerfFrequency / simDeltaTime * globalState::timescale;
     }
 
     void recalcInterpolatedTransformsSet()
@@ -1421,9 +2237,7 @@ namespace physengine
         size_t currentSimSet = (simSetOffsetCopy + 1) % 3;
         float_t physicsAlpha = getPhysicsAlpha();
 
-        for (size_t i = 0; i < registeredSimSetIndices.size(); i++)
-        {
-            size_t index = registeredSimSetIndices[i];
+        auto interpolateIndex = [&](size_t index) {
             glm_vec3_lerp(
                 simSetChain[prevSimSet]->simTransforms[index].position,
                 simSetChain[currentSimSet]->simTransforms[index].position,
@@ -1436,7 +2250,32 @@ namespace physengine
                 physicsAlpha,
                 calcInterpolatedSet->simTransforms[index].rotation
             );
+        };
+
+        if (calcInterpolatedSimSetOffset == (size_t)-1 ||
+            simSetOffsetCopy - calcInterpolatedSimSetOffset > 1)
+        {
+            // Missed a sim set (or first time), so the change lists don't cover everything. Do all of them.
+            for (size_t i = 0; i < registeredSimSetIndices.size(); i++)
+                interpolateIndex(registeredSimSetIndices[i]);
+        }
+        else
+        {
+            if (simSetOffsetCopy != calcInterpolatedSimSetOffset)
+            {
+                // Slots that moved last tick but not this tick get set to where they stopped.
+                const SimulationInterpolationSet& prev = *simSetChain[prevSimSet];
+                uint32_t numPrevChanged = prev.numChangedIndices;
+                for (uint32_t i = 0; i < numPrevChanged; i++)
+                    interpolateIndex(prev.changedIndices[i]);
+            }
+
+            const SimulationInterpolationSet& current = *simSetChain[currentSimSet];
+            uint32_t numCurrentChanged = current.numChangedIndices;
+            for (uint32_t i = 0; i < numCurrentChanged; i++)
+                interpolateIndex(current.changedIndices[i]);
         }
+        calcInterpolatedSimSetOffset = simSetOffsetCopy;
     }
 
     void setWorldGravity(vec3 newGravity)
@@ -1444,6 +2283,16 @@ namespace physengine
         physicsSystem->SetGravity(Vec3(newGravity[0], newGravity[1], newGravity[2]));
     }
 
+    void setCollisionStepsPerTick(int32_t steps)
+    {
+        collisionStepsPerTick = std::max(1, steps);
+    }
+
+    int32_t getCollisionStepsPerTick()
+    {
+        return collisionStepsPerTick;
+    }
+
     void getWorldGravity(vec3& outGravity)
     {
         Vec3 grav = physicsSystem->GetGravity();
@@ -1452,18 +2301,31 @@ namespace physengine
         outGravity[2] = grav.GetZ();
     }
 
-    size_t getCollisionLayer(const std::string& layerName)
+    ObjectLayer getCollisionLayer(const std::string& layerName)
+    {
+        for (ObjectLayer i = 0; i < Layers::NUM_LAYERS; i++)
+            if (layerName == collisionLayerTable[i].name)
+                return i;
+
+        std::cerr << "[GET COLLISION LAYER]" << std::endl
+            << "ERROR: layer \"" << layerName << "\" does not exist." << std::endl;
+        return Layers::NUM_LAYERS;
+    }
+
+    Entity* getEntityOfBody(BodyID bodyId)
     {
-        return 0;  // @INCOMPLETE: for now, just ignore the collision layers and check everything.
+        if (bodyId.IsInvalid())
+            return nullptr;
+        return bodyIdToEntity[bodyId.GetIndex()];
     }
 
-    bool raycast(vec3 origin, vec3 directionAndMagnitude, std::string& outHitGuid)
+    bool raycast(vec3 origin, vec3 directionAndMagnitude, ObjectLayer queryLayer, Entity*& outHitEntity)
     {
         float_t _;
-        return raycast(origin, directionAndMagnitude, outHitGuid, _);
+        return raycast(origin, directionAndMagnitude, queryLayer, outHitEntity, _);
     }
 
-    bool raycast(vec3 origin, vec3 directionAndMagnitude, std::string& outHitGuid, float_t& outFraction)
+    bool raycast(vec3 origin, vec3 directionAndMagnitude, ObjectLayer queryLayer, Entity*& outHitEntity, float_t& outFraction)
     {
 #ifdef _DEVELOP
         if (engine->generateCollisionDebugVisualization)
@@ -1479,25 +2341,169 @@ namespace physengine
             Vec3(directionAndMagnitude[0], directionAndMagnitude[1], directionAndMagnitude[2])
         };
         RayCastResult result;
-        if (physicsSystem->GetNarrowPhaseQuery().CastRay(ray, result, SpecifiedBroadPhaseLayerFilter(BroadPhaseLayers::MOVING), SpecifiedObjectLayerFilter(Layers::MOVING)))
+        if (physicsSystem->GetNarrowPhaseQuery().CastRay(ray, result, DefaultBroadPhaseLayerFilter(objectVsBroadphaseLayerFilter, queryLayer), DefaultObjectLayerFilter(objectVsObjectLayerFilter, queryLayer)))
         {
             outFraction = result.GetEarlyOutFraction();
 
-            const uint32_t bodyIdIdx = result.mBodyID.GetIndex();
-            if (bodyIdToEntityGuidMap.find(bodyIdIdx) == bodyIdToEntityGuidMap.end())
+            outHitEntity = bodyIdToEntity[result.mBodyID.GetIndex()];
+            if (outHitEntity == nullptr)
             {
                 std::cout << "[RAYCAST]" << std::endl
-                    << "WARNING: body ID " << bodyIdIdx << " didn\'t match any entity GUIDs." << std::endl;
-            }
-            else
-            {
-                outHitGuid = bodyIdToEntityGuidMap[bodyIdIdx];
+                    << "WARNING: body ID " << result.mBodyID.GetIndex() << " didn\'t match any entities." << std::endl;
             }
             return true;
         }
         return false;
     }
 
+    void castShapeOne(const Shape& shape, RVec3Arg origin, Vec3Arg direction, ObjectLayer queryLayer, BatchedCastResult& outResult)
+    {
+        RShapeCast shapeCast = RShapeCast::sFromWorldTransform(&shape, Vec3::sReplicate(1.0f), RMat44::sTranslation(origin), direction);
+        ShapeCastSettings settings;
+        ClosestHitCollisionCollector<CastShapeCollector> collector;
+        physicsSystem->GetNarrowPhaseQuery().CastShape(shapeCast, settings, RVec3::sZero(), collector, DefaultBroadPhaseLayerFilter(objectVsBroadphaseLayerFilter, queryLayer), DefaultObjectLayerFilter(objectVsObjectLayerFilter, queryLayer));
+        if (!collector.HadHit())
+            return;
+
+        Vec3 normal = -collector.mHit.mPenetrationAxis.NormalizedOr(Vec3::sAxisY());
+        outResult.hit = true;
+        outResult.bodyId = collector.mHit.mBodyID2;
+        outResult.entity = bodyIdToEntity[collector.mHit.mBodyID2.GetIndex()];
+        outResult.fraction = collector.mHit.mFraction;
+        glm_vec3_copy(vec3{ normal.GetX(), normal.GetY(), normal.GetZ() }, outResult.normal);
+    }
+
+    void castOne(const BatchedCastQuery& query, BatchedCastResult& outResult)
+    {
+        outResult.hit = false;
+        RVec3 origin(query.origin[0], query.origin[1], query.origin[2]);
+        Vec3 direction(query.directionAndMagnitude[0], query.directionAndMagnitude[1], query.directionAndMagnitude[2]);
+
+        switch (query.type)
+        {
+            case BatchedCastQuery::Type::RAY:
+            {
+                RRayCast ray{ origin, direction };
+                RayCastResult result;
+                if (!physicsSystem->GetNarrowPhaseQuery().CastRay(ray, result, DefaultBroadPhaseLayerFilter(objectVsBroadphaseLayerFilter, query.queryLayer), DefaultObjectLayerFilter(objectVsObjectLayerFilter, query.queryLayer)))
+                    return;
+
+                Vec3 normal = Vec3::sAxisY();
+                BodyLockRead lock(physicsSystem->GetBodyLockInterface(), result.mBodyID);
+                if (lock.Succeeded())
+                    normal = lock.GetBody().GetWorldSpaceSurfaceNormal(result.mSubShapeID2, ray.GetPointOnRay(result.mFraction));
+
+                outResult.hit = true;
+                outResult.bodyId = result.mBodyID;
+                outResult.entity = bodyIdToEntity[result.mBodyID.GetIndex()];
+                outResult.fraction = result.mFraction;
+                glm_vec3_copy(vec3{ normal.GetX(), normal.GetY(), normal.GetZ() }, outResult.normal);
+            } return;
+
+            // @NOTE: the cast shapes live on the stack, so no allocations per cast.
+            case BatchedCastQuery::Type::SPHERE:
+            {
+                SphereShape sphere(query.radius);
+                sphere.SetEmbedded();
+                castShapeOne(sphere, origin, direction, query.queryLayer, outResult);
+            } return;
+
+            case BatchedCastQuery::Type::CAPSULE:
+            {
+                CapsuleShape capsule(query.halfHeight, query.radius);
+                capsule.SetEmbedded();
+                castShapeOne(capsule, origin, direction, query.queryLayer, outResult);
+            } return;
+        }
+    }
+
+    constexpr size_t batchedCastsPerJob = 32;
+
+    void castBatched(const BatchedCastQuery* queries, size_t numQueries, BatchedCastResult* outResults)
+    {
+        ZoneScoped;
+
+        std::shared_lock<std::shared_mutex> lock(queryJobSystemMutex, std::defer_lock);
+        JobSystem::Barrier* barrier = nullptr;
+        if (numQueries > batchedCastsPerJob)
+        {
+            lock.lock();
+            if (queryJobSystem != nullptr)
+                barrier = queryJobSystem->CreateBarrier();  // @NOTE: null if all the barriers are taken.
+        }
+
+        if (barrier == nullptr)
+        {
+            // Not worth waking up the job threads (or there are none to wake up).
+            for (size_t i = 0; i < numQueries; i++)
+                castOne(queries[i], outResults[i]);
+            return;
+        }
+
+        for (size_t start = 0; start < numQueries; start += batchedCastsPerJob)
+        {
+            size_t end = std::min(start + batchedCastsPerJob, numQueries);
+            barrier->AddJob(queryJobSystem->CreateJob("Batched Casts", Color::sCyan, [queries, outResults, start, end]() {
+                for (size_t i = start; i < end; i++)
+                    castOne(queries[i], outResults[i]);
+            }));
+        }
+        queryJobSystem->WaitForJobs(barrier);
+        queryJobSystem->DestroyBarrier(barrier);
+    }
+
+    class OverlapBodyCollector : public CollideShapeBodyCollector
+    {
+    public:
+        OverlapBodyCollector(OverlapResult* outResults, size_t maxResults) : outResults(outResults), maxResults(maxResults) { }
+
+        virtual void AddHit(const BodyID& inBodyID) override
+        {
+            if (numResults >= maxResults)
+            {
+                ForceEarlyOut();
+                return;
+            }
+
+            RVec3 centerOfMass = physicsSystem->GetBodyInterface().GetCenterOfMassPosition(inBodyID);
+            OverlapResult& result = outResults[numResults++];
+            result.bodyId = inBodyID;
+            result.entity = bodyIdToEntity[inBodyID.GetIndex()];
+            glm_vec3_copy(vec3{ centerOfMass.GetX(), centerOfMass.GetY(), centerOfMass.GetZ() }, result.centerOfMass);
+        }
+
+        OverlapResult* outResults;
+        size_t maxResults;
+        size_t numResults = 0;
+    };
+
+    size_t overlapSphere(vec3 center, float_t radius, ObjectLayer layer, OverlapResult* outResults, size_t maxResults)
+    {
+        OverlapBodyCollector collector(outResults, maxResults);
+        physicsSystem->GetBroadPhaseQuery().CollideSphere(Vec3(center[0], center[1], center[2]), radius, collector, SpecifiedBroadPhaseLayerFilter(broadphaseLayerInterface.GetBroadPhaseLayer(layer)), SpecifiedObjectLayerFilter(layer));
+        return collector.numResults;
+    }
+
+    size_t overlapBox(vec3 center, vec3 halfExtents, ObjectLayer layer, OverlapResult* outResults, size_t maxResults)
+    {
+        Vec3 centerJolt(center[0], center[1], center[2]);
+        Vec3 halfExtentsJolt(halfExtents[0], halfExtents[1], halfExtents[2]);
+        OverlapBodyCollector collector(outResults, maxResults);
+        physicsSystem->GetBroadPhaseQuery().CollideAABox(AABox(centerJolt - halfExtentsJolt, centerJolt + halfExtentsJolt), collector, SpecifiedBroadPhaseLayerFilter(broadphaseLayerInterface.GetBroadPhaseLayer(layer)), SpecifiedObjectLayerFilter(layer));
+        return collector.numResults;
+    }
+
+    size_t overlapCapsule(vec3 pt1, vec3 pt2, float_t radius, ObjectLayer layer, OverlapResult* outResults, size_t maxResults)
+    {
+        // Bounds of the capsule.
+        Vec3 pt1Jolt(pt1[0], pt1[1], pt1[2]);
+        Vec3 pt2Jolt(pt2[0], pt2[1], pt2[2]);
+        Vec3 radiusJolt = Vec3::sReplicate(radius);
+        OverlapBodyCollector collector(outResults, maxResults);
+        physicsSystem->GetBroadPhaseQuery().CollideAABox(AABox(Vec3::sMin(pt1Jolt, pt2Jolt) - radiusJolt, Vec3::sMax(pt1Jolt, pt2Jolt) + radiusJolt), collector, SpecifiedBroadPhaseLayerFilter(broadphaseLayerInterface.GetBroadPhaseLayer(layer)), SpecifiedObjectLayerFilter(layer));
+        return collector.numResults;
+    }
+
 #ifdef _DEVELOP
     void drawDebugVisLine(vec3 pt1, vec3 pt2, DebugVisLineType type)
     {
@@ -1518,6 +2524,72 @@ namespace physengine
         ImGui::PlotHistogram("##Simulation Times Histogram", perfStats.simTimesUS, (int32_t)perfStats.simTimesUSCount, (int32_t)perfStats.simTimesUSHeadIndex, "", 0.0f, perfStats.highestSimTime, ImVec2(256, 24.0f));
         ImGui::SameLine();
         ImGui::Text(("[0, " + std::format("{:.2f}", perfStats.highestSimTime * perfTimeToMS) + "]").c_str());
+
+        ImGui::Text(std::format("Ticks: {}  Catch-up: {}  Overruns: {}  Dropped: {}", tickStats.numTicks, tickStats.numCatchUpTicks, tickStats.numOverrunLoops, tickStats.numDroppedTicks).c_str());
+        ImGui::Text(std::format("Wake error: {:.3f}ms (max {:.3f}ms)", tickStats.lastWakeErrorMS, tickStats.maxWakeErrorMS).c_str());
+        if (ImGui::Button("Reset Tick Stats"))
+            tickStats = {};
+
+        int32_t steps = collisionStepsPerTick;
+        if (ImGui::InputInt("Collision Steps Per Tick", &steps))
+            setCollisionStepsPerTick(steps);
+    }
+
+    void runBatchedCastBenchmark()
+    {
+        if (numVFsCreated == 0)
+        {
+            debug::pushDebugMessage({
+                .message = "Batched raycast benchmark needs a voxel field in the scene to cast against",
+                .type = 1,
+                });
+            return;
+        }
+
+        // Rays shot straight down onto random spots of the voxel fields in the scene.
+        std::mt19937 rng(1234);
+        std::vector<BatchedCastQuery> queries(4096);
+        std::vector<BatchedCastResult> results(queries.size());
+        for (BatchedCastQuery& query : queries)
+        {
+            VoxelFieldPhysicsData& vfpd = voxelFieldPool[voxelFieldIndices[rng() % numVFsCreated]];
+            vec3 localPosition = {
+                std::uniform_real_distribution<float_t>(0.0f, (float_t)vfpd.sizeX)(rng),
+                (float_t)vfpd.sizeY + 1.0f,
+                std::uniform_real_distribution<float_t>(0.0f, (float_t)vfpd.sizeZ)(rng),
+            };
+            glm_mat4_mulv3(vfpd.transform, localPosition, 1.0f, query.origin);
+            glm_vec3_copy(vec3{ 0.0f, -((float_t)vfpd.sizeY + 2.0f), 0.0f }, query.directionAndMagnitude);
+        }
+
+        static const float_t perfTimeToMS = 1000.0f / (float_t)SDL_GetPerformanceFrequency();
+        for (size_t numRays = 1; numRays <= queries.size(); numRays *= 4)
+        {
+            // One at a time through `raycast()`.
+            uint64_t perfTime = SDL_GetPerformanceCounter();
+            size_t numSingleHits = 0;
+            for (size_t i = 0; i < numRays; i++)
+            {
+                Entity* hitEntity;
+                if (raycast(queries[i].origin, queries[i].directionAndMagnitude, queries[i].queryLayer, hitEntity))
+                    numSingleHits++;
+            }
+            float_t singleMS = (SDL_GetPerformanceCounter() - perfTime) * perfTimeToMS;
+
+            // All at once.
+            perfTime = SDL_GetPerformanceCounter();
+            castBatched(queries.data(), numRays, results.data());
+            float_t batchedMS = (SDL_GetPerformanceCounter() - perfTime) * perfTimeToMS;
+            size_t numBatchedHits = 0;
+            for (size_t i = 0; i < numRays; i++)
+                if (results[i].hit)
+                    numBatchedHits++;
+
+            debug::pushDebugMessage({
+                .message = std::format("Raycasts N={:<5} single: {:8.3f}ms ({} hits)    batched: {:8.3f}ms ({} hits)", numRays, singleMS, numSingleHits, batchedMS, numBatchedHits),
+                .timeUntilDeletion = 15.0f,
+                });
+        }
     }
 
     void renderDebugVisualization(VkCommandBuffer cmd)
@@ -1,6 +1,7 @@
 #pragma once
 
 class EntityManager;
+class Entity;
 struct DeletionQueue;
 namespace JPH { struct Character; }
 
@@ -22,6 +23,11 @@ namespace physengine
     void haltAsyncRunner();
     void cleanup();
 
+    // @NOTE: bodies created/destroyed between these get added/removed all at once when the outermost batch ends.
+    //        Use these around anything that makes lots of bodies (scene loads, prefab spawns, mass deletes). Batches are per thread.
+    void beginBodyBatch();
+    void endBodyBatch();
+
     void requestSetRunPhysicsSimulation(bool flag);
     bool getIsRunPhysicsSimulation();
 
@@ -32,8 +38,49 @@ namespace physengine
     void getInterpSimulationTransformPosition(size_t id, vec3& outPos);
     void getInterpSimulationTransformRotation(size_t id, versor& outRot);
 
+    // Layer that objects can be in, determines which other objects it can collide with
+    // @NOTE: which layers collide with each other (and which broadphase tree each layer lives in) is
+    //        set in the `collisionLayerTable` in PhysicsEngine.cpp. Pairs can be changed with `setLayersCollide()`.
+    namespace Layers
+    {
+        static constexpr JPH::ObjectLayer NON_MOVING = 0;  // Static world (voxel fields).
+        static constexpr JPH::ObjectLayer MOVING = 1;      // Dynamic props.
+        static constexpr JPH::ObjectLayer CHARACTER = 2;
+        static constexpr JPH::ObjectLayer TRIGGER = 3;
+        static constexpr JPH::ObjectLayer GONDOLA = 4;
+        static constexpr JPH::ObjectLayer PROJECTILE = 5;
+        static constexpr JPH::ObjectLayer NUM_LAYERS = 6;
+    };
+
+    void setLayersCollide(JPH::ObjectLayer layer1, JPH::ObjectLayer layer2, bool collide);  // @NOTE: only call this before `start()` or from the simulation thread.
+    bool getLayersCollide(JPH::ObjectLayer layer1, JPH::ObjectLayer layer2);
+
+    constexpr int32_t VOXEL_CHUNK_SIZE = 16;  // Voxels along each side of a chunk.
+
+    struct VoxelChunk
+    {
+        uint8_t  voxels[VOXEL_CHUNK_SIZE * VOXEL_CHUNK_SIZE * VOXEL_CHUNK_SIZE] = {};
+        uint16_t numNonEmpty = 0;  // Chunk gets freed once this hits 0.
+    };
+
+    struct VoxelFieldCollisionShape
+    {
+        vec3   origin;
+        versor rotation;
+        vec3   extent;
+    };
+
+    struct VoxelFieldCollisionChunk
+    {
+        JPH::RefConst<JPH::Shape> shape;                // Cooked boxes of the chunk, in chunk-local space.
+        std::vector<VoxelFieldCollisionShape> shapes;  // Props of those boxes (chunk-local too).
+        ivec3 placedOrigin;                            // Where the chunk sits in the body's shape.
+        bool isPlaced = false;                         // Whether `shape` is what's in the body's shape.
+    };
+
     struct VoxelFieldPhysicsData
     {
+        Entity* entity;
         std::string entityGuid;
 
         //
@@ -60,34 +107,40 @@ namespace physengine
         //        4-step stair space (West  0.5 height, East  1.0 height)
         //
         size_t sizeX, sizeY, sizeZ;
-        uint8_t* voxelData;
+        std::unordered_map<uint64_t, VoxelChunk*> voxelChunks;  // @NOTE: only chunks with something in them get stored, so memory scales with the occupied volume.
+        ivec3 chunkSpaceOffset = { 0, 0, 0 };  // Voxel position + this = position in chunk space. Changing the bounds only changes this, so no data has to move.
         mat4 transform = GLM_MAT4_IDENTITY_INIT;
         mat4 prevTransform = GLM_MAT4_IDENTITY_INIT;
         mat4 interpolTransform = GLM_MAT4_IDENTITY_INIT;
         JPH::BodyID bodyId;
+        JPH::ObjectLayer objectLayer = Layers::NON_MOVING;
         size_t simTransformId;
-    };
 
-    struct VoxelFieldCollisionShape
-    {
-        vec3   origin;
-        versor rotation;
-        vec3   extent;
+        // Collision gets cooked per chunk, so an edit only re-cooks the chunks it touched.
+        std::unordered_set<uint64_t> dirtyCollisionChunks;
+        std::unordered_map<uint64_t, VoxelFieldCollisionChunk> collisionChunks;
+        JPH::Ref<JPH::MutableCompoundShape> collisionShape;
+        std::vector<uint64_t> collisionShapeChunkKeys;  // Chunk key of each sub shape in `collisionShape`.
     };
 
-    VoxelFieldPhysicsData* createVoxelField(const std::string& entityGuid, mat4 transform, const size_t& sizeX, const size_t& sizeY, const size_t& sizeZ, uint8_t* voxelData);
+    VoxelFieldPhysicsData* createVoxelField(Entity* entity, mat4 transform, const size_t& sizeX, const size_t& sizeY, const size_t& sizeZ, uint8_t* voxelData, JPH::ObjectLayer objectLayer);  // @NOTE: takes ownership of the dense `voxelData` array (gets converted into chunks and deleted).
     bool destroyVoxelField(VoxelFieldPhysicsData* vfpd);
     uint8_t getVoxelDataAtPosition(const VoxelFieldPhysicsData& vfpd, const int32_t& x, const int32_t& y, const int32_t& z);
-    bool setVoxelDataAtPosition(const VoxelFieldPhysicsData& vfpd, const int32_t& x, const int32_t& y, const int32_t& z, uint8_t data);
+    bool setVoxelDataAtPosition(VoxelFieldPhysicsData& vfpd, const int32_t& x, const int32_t& y, const int32_t& z, uint8_t data);
+    void getVoxelDataDense(const VoxelFieldPhysicsData& vfpd, std::vector<uint8_t>& outVoxelData);  // Laid out as `[x * sizeY * sizeZ + y * sizeZ + z]`.
+    size_t getVoxelSlopeRunLength(const VoxelFieldPhysicsData& vfpd, const int32_t& x, const int32_t& y, const int32_t& z);  // Length of the slope run starting at this position (going uphill-axis-positive), or 0 if no run starts here.
     void expandVoxelFieldBounds(VoxelFieldPhysicsData& vfpd, ivec3 boundsMin, ivec3 boundsMax, ivec3& outOffset);
     void shrinkVoxelFieldBoundsAuto(VoxelFieldPhysicsData& vfpd, ivec3& outOffset);
-    void cookVoxelDataIntoShape(VoxelFieldPhysicsData& vfpd, const std::string& entityGuid, std::vector<VoxelFieldCollisionShape>& outShapes);
+    void cookVoxelDataIntoShape(VoxelFieldPhysicsData& vfpd, std::vector<VoxelFieldCollisionShape>& outShapes);  // @NOTE: only re-cooks the chunks that got changed since the last cook.
+    uint64_t hashVoxelData(const VoxelFieldPhysicsData& vfpd);
     void setVoxelFieldBodyTransform(VoxelFieldPhysicsData& vfpd, vec3 newPosition, versor newRotation);
     void moveVoxelFieldBodyKinematic(VoxelFieldPhysicsData& vfpd, vec3 newPosition, versor newRotation, float_t simDeltaTime);
     void setVoxelFieldBodyKinematic(VoxelFieldPhysicsData& vfpd, bool isKinematic);  // `false` is dynamic body.
+    void setVoxelFieldObjectLayer(VoxelFieldPhysicsData& vfpd, JPH::ObjectLayer objectLayer);
 
     struct CapsulePhysicsData
     {
+        Entity* entity;
         std::string entityGuid;
 
         float_t radius;
@@ -100,7 +153,7 @@ namespace physengine
         size_t simTransformId;
     };
 
-    CapsulePhysicsData* createCharacter(const std::string& entityGuid, vec3 position, const float_t& radius, const float_t& height, bool enableCCD);
+    CapsulePhysicsData* createCharacter(Entity* entity, vec3 position, const float_t& radius, const float_t& height, bool enableCCD);
     bool destroyCapsule(CapsulePhysicsData* cpd);
     size_t getNumCapsules();
     CapsulePhysicsData* getCapsuleByIndex(size_t index);
@@ -112,19 +165,66 @@ namespace physengine
     bool isGrounded(const CapsulePhysicsData& cpd);
     bool isSlopeTooSteepForCharacter(const CapsulePhysicsData& cpd, JPH::Vec3Arg normal);
 
+    // @NOTE: while a voxel shape cache is loaded, `cookVoxelDataIntoShape()` takes the cooked chunks of any new
+    //        voxel field out of the cache if there's an entry for its `hashVoxelData()`, and only cooks otherwise.
+    void loadVoxelShapeCache(const std::string& fname);         // A missing file just means an empty cache.
+    void requestSaveVoxelShapeCache(const std::string& fname);  // Saves the cooked shapes of all the voxel fields at the start of the next simulation tick.
+    bool clearVoxelShapeCache();                                // Returns whether any voxel field missed the cache since it was loaded (i.e. the cache should get saved again).
+
     void recalcInterpolatedTransformsSet();
 
+    void setCollisionStepsPerTick(int32_t steps);  // Jolt substeps per simulation tick (min 1).
+    int32_t getCollisionStepsPerTick();
     void setWorldGravity(vec3 newGravity);
     void getWorldGravity(vec3& outGravity);
-    size_t getCollisionLayer(const std::string& layerName);
-    bool raycast(vec3 origin, vec3 directionAndMagnitude, std::string& outHitGuid, float_t& outFraction);
-    bool raycast(vec3 origin, vec3 directionAndMagnitude, std::string& outHitGuid);
+    JPH::ObjectLayer getCollisionLayer(const std::string& layerName);  // Returns `Layers::NUM_LAYERS` if there's no layer with that name.
+    Entity* getEntityOfBody(JPH::BodyID bodyId);  // nullptr if the body isn't owned by an entity.
+
+    // @NOTE: casts hit whatever an object in `queryLayer` would collide with, so layers that don't collide
+    //        with `queryLayer` get skipped in the broadphase.
+    bool raycast(vec3 origin, vec3 directionAndMagnitude, JPH::ObjectLayer queryLayer, Entity*& outHitEntity, float_t& outFraction);
+    bool raycast(vec3 origin, vec3 directionAndMagnitude, JPH::ObjectLayer queryLayer, Entity*& outHitEntity);
+
+    struct BatchedCastQuery
+    {
+        enum class Type { RAY, SPHERE, CAPSULE } type = Type::RAY;
+        vec3    origin;
+        vec3    directionAndMagnitude;
+        float_t radius = 0.0f;      // For SPHERE and CAPSULE.
+        float_t halfHeight = 0.0f;  // For CAPSULE (stands upright along Y).
+        JPH::ObjectLayer queryLayer = Layers::PROJECTILE;
+    };
+
+    struct BatchedCastResult
+    {
+        bool        hit;
+        JPH::BodyID bodyId;
+        Entity*     entity;    // Owner of `bodyId` (nullptr if none).
+        float_t     fraction;  // Along `directionAndMagnitude`.
+        vec3        normal;
+    };
+
+    void castBatched(const BatchedCastQuery* queries, size_t numQueries, BatchedCastResult* outResults);  // @NOTE: `outResults` is owned by the caller and needs room for `numQueries` results.
+
+    struct OverlapResult
+    {
+        JPH::BodyID bodyId;
+        Entity*     entity;  // Owner of `bodyId` (nullptr if none).
+        vec3        centerOfMass;
+    };
+
+    // @NOTE: these only go thru the broadphase, so any body whose bounds touch the query volume is returned.
+    //        Only bodies in `layer` get returned. Returns the number of results written (at most `maxResults`).
+    size_t overlapSphere(vec3 center, float_t radius, JPH::ObjectLayer layer, OverlapResult* outResults, size_t maxResults);
+    size_t overlapBox(vec3 center, vec3 halfExtents, JPH::ObjectLayer layer, OverlapResult* outResults, size_t maxResults);  // Axis aligned.
+    size_t overlapCapsule(vec3 pt1, vec3 pt2, float_t radius, JPH::ObjectLayer layer, OverlapResult* outResults, size_t maxResults);
 
 #ifdef _DEVELOP
     enum class DebugVisLineType { PURPTEAL, AUDACITY, SUCCESS, VELOCITY, KIKKOARMY, YUUJUUFUDAN };
     void drawDebugVisLine(vec3 pt1, vec3 pt2, DebugVisLineType type = DebugVisLineType::PURPTEAL);
 
     void renderImguiPerformanceStats();
+    void runBatchedCastBenchmark();  // Times N=1..4096 raycasts one at a time vs. batched, against the voxel fields in the scene.
     void renderDebugVisualization(VkCommandBuffer cmd);
 #endif
 }
\ No newline at end of file
@@ -5,39 +5,31 @@
 #include "VkglTFModel.h"
 #include "MaterialOrganizer.h"
 #include "PhysicsEngine.h"
+#include "VulkanEngine.h"
+#include "Camera.h"
+#include "Debug.h"
 
 
-bool RenderObjectManager::registerRenderObjects(std::vector<RenderObject> inRenderObjectDatas, std::vector<RenderObject**> outRenderObjectDatas)
+bool RenderObjectManager::registerRenderObjects(std::vector<RenderObject> inRenderObjectDatas, std::vector<RenderObjectHandle*> outRenderObjectDatas)
 {
 	// @NOTE: using a pool system bc of pointers losing information when stuff gets deleted.  -Timo 2022/11/06
 	// @NOTE: I think past me is talking about when a std::vector gets to a certain capacity, it
 	//        has to recreate a new array and insert all of the information into the array. Since
 	//        the array contains information that exists on the stack, it has to get moved, breaking
 	//        pointers and breaking my heart along the way.  -Timo 2023/05/27
-	if (_renderObjectsIndices.size() + inRenderObjectDatas.size() > RENDER_OBJECTS_MAX_CAPACITY)
-	{
-		std::cerr << "[REGISTER RENDER OBJECT]" << std::endl
-			<< "ERROR: trying to register render object when capacity will overflow maximum." << std::endl
-			<< "       Current capacity: " << _renderObjectsIndices.size() << std::endl
-			<< "       Maximum capacity: " << _renderObjectPool.size() << std::endl
-			<< "       Amount requesting to register: " << inRenderObjectDatas.size() << std::endl;
-		return false;
-	}
-
+	// @NOTE: the pool is paged now, so it can grow without moving the already registered objects.
 	std::lock_guard<std::mutex> lg(renderObjectIndicesAndPoolMutex);
 
+	while (inRenderObjectDatas.size() > _freePoolIndices.size())
+		growRenderObjectPool();
+
 	// Register each render object in the batch.
+	size_t numIndicesBeforeBatch = _renderObjectsIndices.size();
 	for (size_t i = 0; i < inRenderObjectDatas.size(); i++)
 	{
-		size_t registerIndex = 0;
-		for (size_t i = 0; i < _renderObjectsIsRegistered.size(); i++)
-		{
-			if (!_renderObjectsIsRegistered[i])
-			{
-				registerIndex = i;
-				break;
-			}
-		}
+		// Grab a free slot.
+		size_t registerIndex = _freePoolIndices.back();
+		_freePoolIndices.pop_back();
 
 		// Calculate instance pointers
 		RenderObject& renderObjectData = inRenderObjectDatas[i];
@@ -73,20 +65,27 @@ bool RenderObjectManager::registerRenderObjects(std::vector<RenderObject> inRend
 		}
 
 		// Register object
+		renderObjectData.gpuObjectDataStale = true;
 		_renderObjectPool[registerIndex] = renderObjectData;
 		_renderObjectsIsRegistered[registerIndex] = true;
 		_renderObjectsIndices.push_back(registerIndex);
 
-		*outRenderObjectDatas[i] = &_renderObjectPool[registerIndex];
+		// Only touch the mesh buckets this object uses (if the whole hierarchy is
+		// getting rebuilt anyways, it'll get picked up there).
+		if (!_isMetaMeshListUnoptimized)
+			insertIntoMeshBuckets(registerIndex);
+
+		*outRenderObjectDatas[i] = RenderObjectHandle(&_renderObjectPool[registerIndex], _renderObjectGenerations[registerIndex]);
 	}
 
-	// Sort pool indices so that materials and then models are next to each other (helps with compacting render objects in the rendering stage).
-	std::sort(
+	// Keep pool indices sorted so that iterating thru them walks the pool in order.
+	// @NOTE: grouping by material and model is taken care of by the mesh buckets, so only the
+	//        newly added indices need sorting, then they get merged in.
+	std::sort(_renderObjectsIndices.begin() + numIndicesBeforeBatch, _renderObjectsIndices.end());
+	std::inplace_merge(
 		_renderObjectsIndices.begin(),
-		_renderObjectsIndices.end(),
-		[&](size_t a, size_t b) {
-			return _renderObjectPool[a].model < _renderObjectPool[b].model;
-		}
+		_renderObjectsIndices.begin() + numIndicesBeforeBatch,
+		_renderObjectsIndices.end()
 	);
 
 	for (bool* sendFlag : _sendInstancePtrDataToGPU_refs)
@@ -94,47 +93,80 @@ bool RenderObjectManager::registerRenderObjects(std::vector<RenderObject> inRend
 
 	// Recalculate what indices animated render objects are at
 	recalculateSpecialCaseIndices();
-	_isMetaMeshListUnoptimized = true;
 
 	return true;
 }
 
-void RenderObjectManager::unregisterRenderObjects(std::vector<RenderObject*> objRegistrations)
+void RenderObjectManager::unregisterRenderObjects(std::vector<RenderObjectHandle> objRegistrations)
 {
 	std::lock_guard<std::mutex> lg(renderObjectIndicesAndPoolMutex);
 
-	for (RenderObject* objRegistration : objRegistrations)
+	bool unregisteredAny = false;
+	for (RenderObjectHandle& objRegistration : objRegistrations)
 	{
-		// Iterate thru each object registration, unregistering it.
-		bool found = false;
-		size_t indicesIndex = 0;
-		for (size_t poolIndex : _renderObjectsIndices)
+		// Get pool index straight from the address (bc it's a pool).
+		size_t poolIndex;
+		if (!_renderObjectPool.indexOf(objRegistration.renderObject, poolIndex) ||
+			!_renderObjectsIsRegistered[poolIndex] ||
+			_renderObjectGenerations[poolIndex] != objRegistration.generation)
 		{
-			auto& rod = _renderObjectPool[poolIndex];
-			if (&rod == objRegistration)
-			{
-				// Unregister object
-				_renderObjectsIsRegistered[poolIndex] = false;
-				_renderObjectsIndices.erase(_renderObjectsIndices.begin() + indicesIndex);
-
-				for (bool* sendFlag : _sendInstancePtrDataToGPU_refs)
-					*sendFlag = true;
+			std::cerr << "[UNREGISTER RENDER OBJECT]" << std::endl
+				<< "ERROR: render object " << objRegistration.renderObject << " (generation " << objRegistration.generation << ") was not found or was already unregistered. Nothing unregistered." << std::endl;
+			continue;
+		}
 
-				// Recalculate what indices animated render objects are at
-				recalculateSpecialCaseIndices();
-				_isMetaMeshListUnoptimized = true;
+		// Unregister object
+		_renderObjectsIsRegistered[poolIndex] = false;
+		_renderObjectGenerations[poolIndex]++;
+		_freePoolIndices.push_back(poolIndex);
+		if (!_isMetaMeshListUnoptimized)
+			removeFromMeshBuckets(poolIndex);
+		unregisteredAny = true;
+	}
 
-				found = true;
-				break;
-			}
+	if (!unregisteredAny)
+		return;
 
-			indicesIndex++;
+	// Remove all unregistered indices in one pass.
+	std::erase_if(
+		_renderObjectsIndices,
+		[&](size_t poolIndex) {
+			return !_renderObjectsIsRegistered[poolIndex];
 		}
+	);
 
-		if (!found)
-			std::cerr << "[UNREGISTER RENDER OBJECT]" << std::endl
-				<< "ERROR: render object " << objRegistration << " was not found. Nothing unregistered." << std::endl;
+	for (bool* sendFlag : _sendInstancePtrDataToGPU_refs)
+		*sendFlag = true;
+
+	// Recalculate what indices animated render objects are at
+	recalculateSpecialCaseIndices();
+}
+
+void RenderObjectManager::setRenderLayer(const RenderObjectHandle& handle, RenderLayer renderLayer)
+{
+	std::lock_guard<std::mutex> lg(renderObjectIndicesAndPoolMutex);
+
+	size_t poolIndex;
+	if (!_renderObjectPool.indexOf(handle.renderObject, poolIndex) ||
+		!_renderObjectsIsRegistered[poolIndex] ||
+		_renderObjectGenerations[poolIndex] != handle.generation)
+	{
+		std::cerr << "[SET RENDER LAYER]" << std::endl
+			<< "ERROR: render object " << handle.renderObject << " (generation " << handle.generation << ") was not found or was already unregistered." << std::endl;
+		return;
 	}
+
+	RenderObject& ro = _renderObjectPool[poolIndex];
+	if (ro.renderLayer == renderLayer)
+		return;
+
+	// Move the object into the buckets of its new layer (or out of them if the layer isn't enabled).
+	if (!_isMetaMeshListUnoptimized)
+		removeFromMeshBuckets(poolIndex);
+	ro.renderLayer = renderLayer;
+	if (!_isMetaMeshListUnoptimized)
+		insertIntoMeshBuckets(poolIndex);
+	_drawCommandsGeneration++;
 }
 
 bool RenderObjectManager::checkIsMetaMeshListUnoptimized()
@@ -147,129 +179,286 @@ void RenderObjectManager::flagMetaMeshListAsUnoptimized()
 	_isMetaMeshListUnoptimized = true;
 }
 
+void RenderObjectManager::flagInstanceDataChanged()
+{
+	_drawCommandsGeneration++;
+}
+
 void RenderObjectManager::optimizeMetaMeshList()
 {
 	ZoneScoped;
 
-	// @NOTE: since this is a process-intensive operation, it could be good to compile
-	//        all of the metameshes into a separate list in a separate thread while using
-	//        the stale meta mesh list until this operation finishes. Then, upon finishing,
-	//        just assign the memory address of the finished, new meta mesh list to the pointer
-	//        of the old one. Just a thought, but this would force some renderobjects
-	//        to stay alive but it's not impossible to manage.  -Timo 2023/12/12
+	// @NOTE: this full rebuild is now only for when the whole hierarchy is invalid (i.e. first
+	//        frame, render layers toggled, materials reassigned). Registering and unregistering
+	//        render objects goes thru `insertIntoMeshBuckets()` and `removeFromMeshBuckets()`
+	//        instead, so spawning stuff doesn't cause a hitch that scales with the total
+	//        number of render objects.
+
+	// @NOTE: `renderObjectIndicesAndPoolMutex` is expected to be locked already (runtime models and render objects can get added from other threads).
+
+	// Get bucket sizes.
+	size_t numUmbBuckets = materialorganizer::getNumUniqueMaterialBasesExcludingSpecials();
+	size_t numModelBuckets = _renderObjectModels.size();
+	std::vector<size_t> numMeshBucketsByModelIdx(numModelBuckets, 0);
+	_modelsByModelIdx.resize(numModelBuckets);
+	_freeModelIdxs.clear();
+	size_t idx = 0;
+	for (auto it = _renderObjectModels.begin(); it != _renderObjectModels.end(); it++)
+	{
+		auto model = it->second;
+		model->assignedModelIdx = idx;
+		_modelsByModelIdx[idx] = model;
+		numMeshBucketsByModelIdx[idx] =
+			model->getAllPrimitivesInOrder().size();
+		idx++;
+	}
 
-	// Delete existing bucket hierarchy using previously fetched volumes.
-	if (_umbBuckets != nullptr)
+	bool reallocateHierarchy =
+		(_umbBuckets == nullptr ||
+		numUmbBuckets != _numUmbBuckets ||
+		numMeshBucketsByModelIdx != _numMeshBucketsByModelIdx);
+	if (reallocateHierarchy)
 	{
+		// Delete existing bucket hierarchy using previously fetched volumes.
+		if (_umbBuckets != nullptr)
+		{
+			for (size_t i = 0; i < _numUmbBuckets; i++)
+			{
+				UniqueMaterialBaseBucket& umbBucket = _umbBuckets[i];
+				for (size_t j = 0; j < 2; j++)
+				{
+					for (size_t k = 0; k < _numModelBuckets; k++)
+					{
+						ModelBucket& modelBucket = umbBucket.modelBucketSets[j].modelBuckets[k];
+						delete[] modelBucket.meshBuckets;
+					}
+					delete[] umbBucket.modelBucketSets[j].modelBuckets;
+				}
+			}
+			delete[] _umbBuckets;
+		}
+
+		_numUmbBuckets = numUmbBuckets;
+		_numModelBuckets = numModelBuckets;
+		_numMeshBucketsByModelIdx = numMeshBucketsByModelIdx;
+
+		// Create bucket hierarchy.
+		_umbBuckets = new UniqueMaterialBaseBucket[_numUmbBuckets];
 		for (size_t i = 0; i < _numUmbBuckets; i++)
 		{
 			UniqueMaterialBaseBucket& umbBucket = _umbBuckets[i];
 			for (size_t j = 0; j < 2; j++)
 			{
+				umbBucket.modelBucketSets[j].modelBuckets = new ModelBucket[_numModelBuckets];
 				for (size_t k = 0; k < _numModelBuckets; k++)
 				{
 					ModelBucket& modelBucket = umbBucket.modelBucketSets[j].modelBuckets[k];
-					delete[] modelBucket.meshBuckets;
+					modelBucket.meshBuckets = new MeshBucket[_numMeshBucketsByModelIdx[k]];
 				}
-				delete[] umbBucket.modelBucketSets[j].modelBuckets;
 			}
 		}
-		delete[] _umbBuckets;
+		{
+			// @DEBUG show the total size of the allocated bucket hierarchy (of just the containers).
+			size_t totalSize = 0;
+			for (size_t numMeshBuckets : _numMeshBucketsByModelIdx)
+				totalSize += numMeshBuckets * sizeof(MeshBucket);
+			totalSize *= 2;
+			totalSize *= _numUmbBuckets;
+			std::cout << "Allocated bucket hierarchy is " << totalSize << " bytes without data." << std::endl;
+		}
+	}
+	else
+	{
+		// Same shape, so just empty out the existing buckets (keeps their capacity around too).
+		for (size_t i = 0; i < _numUmbBuckets; i++)
+			for (size_t j = 0; j < 2; j++)
+				for (size_t k = 0; k < _numModelBuckets; k++)
+					for (size_t l = 0; l < _numMeshBucketsByModelIdx[k]; l++)
+					{
+						MeshBucket& meshBucket = _umbBuckets[i].modelBucketSets[j].modelBuckets[k].meshBuckets[l];
+						meshBucket.renderObjectIndices.clear();
+						meshBucket.pendingRemovals.clear();
+					}
 	}
+	_staleMeshBuckets.clear();
 
-	// Get bucket sizes.
-	_numUmbBuckets = materialorganizer::getNumUniqueMaterialBasesExcludingSpecials();
-	_numModelBuckets = _renderObjectModels.size();
-	_numMeshBucketsByModelIdx.clear();
-	_numMeshBucketsByModelIdx.resize(_numModelBuckets, 0);
-	size_t idx = 0;
+	// Insert render objects into bucket hierarchy.
+	_numSkinnedMeshBucketEntries = 0;
+	std::fill(_renderObjectsIsInMeshBuckets.begin(), _renderObjectsIsInMeshBuckets.end(), false);
+	for (size_t poolIndex : _renderObjectsIndices)
+		insertIntoMeshBuckets(poolIndex);
+	_skinnedMeshBucketsChanged = false;
+
+	// Add mesh draws into data structure.
+	_modelMeshDraws.clear();
+	_modelMeshDraws.resize(_renderObjectModels.size(), {});
+	size_t mmdIdx = 0;
 	for (auto it = _renderObjectModels.begin(); it != _renderObjectModels.end(); it++)
 	{
-		auto model = it->second;
-		model->assignedModelIdx = idx;
-		_numMeshBucketsByModelIdx[idx] =
-			model->getAllPrimitivesInOrder().size();
-		idx++;
+		uint32_t _ = 0;
+		it->second->appendPrimitiveDraws(_modelMeshDraws[mmdIdx], _);
+		mmdIdx++;
 	}
 
-	// Create bucket hierarchy.
-	_umbBuckets = new UniqueMaterialBaseBucket[_numUmbBuckets];
-	for (size_t i = 0; i < _numUmbBuckets; i++)
-	{
-		UniqueMaterialBaseBucket& umbBucket = _umbBuckets[i];
-		for (size_t j = 0; j < 2; j++)
+	_isMetaMeshListUnoptimized = false;
+	_drawCommandsGeneration++;
+}
+
+void RenderObjectManager::addModelBuckets(vkglTF::Model* model)
+{
+	// @NOTE: `renderObjectIndicesAndPoolMutex` is expected to be locked already.
+	if (_isMetaMeshListUnoptimized || _umbBuckets == nullptr)
+		return;  // The full rebuild will pick up this model.
+
+	// Reuse a slot freed by a destroyed runtime model if it has the same amount of meshes.
+	size_t numMeshBuckets = model->getAllPrimitivesInOrder().size();
+	size_t modelIdx = _numModelBuckets;
+	for (auto it = _freeModelIdxs.begin(); it != _freeModelIdxs.end(); it++)
+		if (_numMeshBucketsByModelIdx[*it] == numMeshBuckets)
 		{
-			umbBucket.modelBucketSets[j].modelBuckets = new ModelBucket[_numModelBuckets];
-			for (size_t k = 0; k < _numModelBuckets; k++)
+			modelIdx = *it;
+			_freeModelIdxs.erase(it);
+			break;
+		}
+
+	if (modelIdx == _numModelBuckets)
+	{
+		// Grow every model bucket array by one slot.
+		// @NOTE: the existing mesh bucket arrays just get their pointers copied over, so `_staleMeshBuckets` stays valid.
+		for (size_t i = 0; i < _numUmbBuckets; i++)
+			for (size_t j = 0; j < 2; j++)
 			{
-				ModelBucket& modelBucket = umbBucket.modelBucketSets[j].modelBuckets[k];
-				modelBucket.meshBuckets = new MeshBucket[_numMeshBucketsByModelIdx[k]];
+				ModelBucket*& modelBuckets = _umbBuckets[i].modelBucketSets[j].modelBuckets;
+				ModelBucket* grownModelBuckets = new ModelBucket[_numModelBuckets + 1];
+				std::copy(modelBuckets, modelBuckets + _numModelBuckets, grownModelBuckets);
+				grownModelBuckets[_numModelBuckets].meshBuckets = new MeshBucket[numMeshBuckets];
+				delete[] modelBuckets;
+				modelBuckets = grownModelBuckets;
 			}
-		}
+		_numModelBuckets++;
+		_numMeshBucketsByModelIdx.push_back(numMeshBuckets);
+		_modelsByModelIdx.push_back(nullptr);
+		_modelMeshDraws.emplace_back();
 	}
+
+	model->assignedModelIdx = modelIdx;
+	_modelsByModelIdx[modelIdx] = model;
+	_modelMeshDraws[modelIdx].clear();
+	uint32_t _ = 0;
+	model->appendPrimitiveDraws(_modelMeshDraws[modelIdx], _);
+	_drawCommandsGeneration++;
+}
+
+void RenderObjectManager::freeModelBuckets(vkglTF::Model* model)
+{
+	// @NOTE: `renderObjectIndicesAndPoolMutex` is expected to be locked already.
+	if (_isMetaMeshListUnoptimized || _umbBuckets == nullptr)
+		return;
+
+	// The render objects using this model are already unregistered, so its mesh buckets
+	// are (or will be after compacting) empty. Blank the draws so nothing points at the model.
+	size_t modelIdx = model->assignedModelIdx;
+	_modelsByModelIdx[modelIdx] = nullptr;
+	_modelMeshDraws[modelIdx].assign(_numMeshBucketsByModelIdx[modelIdx], {});
+	_freeModelIdxs.push_back(modelIdx);
+	_drawCommandsGeneration++;
+}
+
+bool RenderObjectManager::compactStaleMeshBuckets()
+{
+	ZoneScoped;
+
+	// @NOTE: `renderObjectIndicesAndPoolMutex` is expected to be locked already.
+
+	for (MeshBucket* meshBucket : _staleMeshBuckets)
 	{
-		// @DEBUG show the total size of the allocated bucket hierarchy (of just the containers).
-		size_t totalSize = 0;
-		for (size_t numMeshBuckets : _numMeshBucketsByModelIdx)
-			totalSize += numMeshBuckets * 24;  // 24 is the bytes to create std::vector container.
-		totalSize *= 2;
-		totalSize *= _numUmbBuckets;
-		std::cout << "Allocated bucket hierarchy is " << totalSize << " bytes without data." << std::endl;
+		// @NOTE: a pool index can show up twice in a bucket if its slot got reused before
+		//        compacting, so only remove as many entries as there were removals.
+		std::unordered_map<size_t, size_t> removalCounts;
+		for (size_t poolIndex : meshBucket->pendingRemovals)
+			removalCounts[poolIndex]++;
+
+		std::erase_if(
+			meshBucket->renderObjectIndices,
+			[&](size_t poolIndex) {
+				auto it = removalCounts.find(poolIndex);
+				if (it == removalCounts.end() || it->second == 0)
+					return false;
+				it->second--;
+				return true;
+			}
+		);
+		meshBucket->pendingRemovals.clear();
 	}
+	_staleMeshBuckets.clear();
 
-	std::lock_guard<std::mutex> lg(renderObjectIndicesAndPoolMutex);
+	bool skinnedMeshBucketsChanged = _skinnedMeshBucketsChanged;
+	_skinnedMeshBucketsChanged = false;
+	return skinnedMeshBucketsChanged;
+}
 
-	//
-	// Cull out render object indices that are not marked as visible
-	//
-	std::vector<size_t> visibleIndices;
-	for (size_t i = 0; i < _renderObjectsIndices.size(); i++)
-	{
-		size_t poolIndex = _renderObjectsIndices[i];
-		RenderObject& object = _renderObjectPool[poolIndex];
+void RenderObjectManager::insertIntoMeshBuckets(size_t poolIndex)
+{
+	// @NOTE: `renderObjectIndicesAndPoolMutex` is expected to be locked already.
+	RenderObject& ro = _renderObjectPool[poolIndex];
 
-		// See if render object itself is visible
-		if (!_renderObjectLayersEnabled[(size_t)object.renderLayer])
-			continue;
-		if (object.model == nullptr)
-			continue;
+	// See if render object itself is visible
+	if (!_renderObjectLayersEnabled[(size_t)ro.renderLayer])
+		return;
+	if (ro.model == nullptr)
+		return;
 
-		// It's visible!!!!
-		visibleIndices.push_back(poolIndex);
+	// It's visible!!!!
+	size_t skinnedIdx = (ro.animator != nullptr ? 0 : 1);
+	size_t modelIdx = ro.model->assignedModelIdx;
+	for (size_t mi = 0; mi < ro.perPrimitiveUniqueMaterialBaseIndices.size(); mi++)
+	{
+		size_t umbIdx = ro.perPrimitiveUniqueMaterialBaseIndices[mi];
+		_umbBuckets[umbIdx]
+			.modelBucketSets[skinnedIdx]
+			.modelBuckets[modelIdx]
+			.meshBuckets[mi]
+			.renderObjectIndices.push_back(poolIndex);
 	}
 
-	// Insert render objects into bucket hierarchy.
-	_skinnedMeshEntriesExist = false;
-	for (size_t roIdx = 0; roIdx < visibleIndices.size(); roIdx++)
+	if (ro.animator != nullptr)
 	{
-		RenderObject& ro = _renderObjectPool[visibleIndices[roIdx]];
-		for (size_t mi = 0; mi < ro.perPrimitiveUniqueMaterialBaseIndices.size(); mi++)
-		{
-			if (ro.animator != nullptr)
-				_skinnedMeshEntriesExist = true;
-			size_t umbIdx = ro.perPrimitiveUniqueMaterialBaseIndices[mi];
-			size_t skinnedIdx = (ro.animator != nullptr ? 0 : 1);
-			size_t modelIdx = ro.model->assignedModelIdx;
+		_numSkinnedMeshBucketEntries++;
+		_skinnedMeshBucketsChanged = true;
+	}
+	_renderObjectsIsInMeshBuckets[poolIndex] = true;
+	_drawCommandsGeneration++;
+}
+
+void RenderObjectManager::removeFromMeshBuckets(size_t poolIndex)
+{
+	// @NOTE: `renderObjectIndicesAndPoolMutex` is expected to be locked already.
+	if (!_renderObjectsIsInMeshBuckets[poolIndex])
+		return;
+
+	RenderObject& ro = _renderObjectPool[poolIndex];
+	size_t skinnedIdx = (ro.animator != nullptr ? 0 : 1);
+	size_t modelIdx = ro.model->assignedModelIdx;
+	for (size_t mi = 0; mi < ro.perPrimitiveUniqueMaterialBaseIndices.size(); mi++)
+	{
+		size_t umbIdx = ro.perPrimitiveUniqueMaterialBaseIndices[mi];
+		MeshBucket& meshBucket =
 			_umbBuckets[umbIdx]
 				.modelBucketSets[skinnedIdx]
 				.modelBuckets[modelIdx]
-				.meshBuckets[mi]
-				.renderObjectIndices.push_back(visibleIndices[roIdx]);
-		}
+				.meshBuckets[mi];
+		if (meshBucket.pendingRemovals.empty())
+			_staleMeshBuckets.push_back(&meshBucket);
+		meshBucket.pendingRemovals.push_back(poolIndex);
 	}
 
-	// Add mesh draws into data structure.
-	_modelMeshDraws.clear();
-	_modelMeshDraws.resize(_renderObjectModels.size(), {});
-	size_t mmdIdx = 0;
-	for (auto it = _renderObjectModels.begin(); it != _renderObjectModels.end(); it++)
+	if (ro.animator != nullptr)
 	{
-		uint32_t _ = 0;
-		it->second->appendPrimitiveDraws(_modelMeshDraws[mmdIdx], _);
-		mmdIdx++;
+		_numSkinnedMeshBucketEntries--;
+		_skinnedMeshBucketsChanged = true;
 	}
-
-	_isMetaMeshListUnoptimized = false;
+	_renderObjectsIsInMeshBuckets[poolIndex] = false;
+	_drawCommandsGeneration++;
 }
 
 #ifdef _DEVELOP
@@ -328,6 +517,15 @@ void RenderObjectManager::reloadModelAndTriggerCallbacks(VulkanEngine* engine, c
 	model->destroy(_allocator);
 	model->loadHthrobwoaFromFile(engine, modelPath, pathStringHenema);
 
+	// Bounding sphere and primitive count could've changed, so recalculate object data and bucket hierarchy.
+	flagMetaMeshListAsUnoptimized();
+	{
+		std::lock_guard<std::mutex> lg(renderObjectIndicesAndPoolMutex);
+		for (size_t poolIndex : _renderObjectsIndices)
+			if (_renderObjectPool[poolIndex].model == model)
+				_renderObjectPool[poolIndex].gpuObjectDataStale = true;
+	}
+
 	// Trigger Model Callbacks
 	for (auto& rc : _renderObjectModelCallbacks[name])
 		rc.callback();
@@ -336,15 +534,45 @@ void RenderObjectManager::reloadModelAndTriggerCallbacks(VulkanEngine* engine, c
 
 RenderObjectManager::RenderObjectManager(VmaAllocator& allocator) : _allocator(allocator)
 {
+	growRenderObjectPool();
 }
 
 RenderObjectManager::~RenderObjectManager()
 {
     for (auto it = _renderObjectModels.begin(); it != _renderObjectModels.end(); it++)
 		it->second->destroy(_allocator);
+	for (vkglTF::Model* model : _runtimeModelsToDestroy)
+	{
+		model->destroy(_allocator);
+		delete model;
+	}
+	for (auto& retired : _retiredRuntimeModelResources)
+	{
+		for (AllocatedBuffer& buffer : retired.buffers)
+			vmaDestroyBuffer(_allocator, buffer._buffer, buffer._allocation);
+		for (vkglTF::Model* model : retired.models)
+		{
+			model->destroy(_allocator);
+			delete model;
+		}
+	}
 	delete[] _renderObjectLayersEnabled;
 }
 
+void RenderObjectManager::growRenderObjectPool()
+{
+	size_t firstNewIndex = _renderObjectPool.capacity();
+	_renderObjectPool.addPage();
+	size_t newCapacity = _renderObjectPool.capacity();
+	_renderObjectsIsRegistered.resize(newCapacity, false);
+	_renderObjectGenerations.resize(newCapacity, 0);
+	_renderObjectsIsInMeshBuckets.resize(newCapacity, false);
+
+	// Fill free list backwards so that the lowest pool indices get handed out first.
+	for (size_t i = newCapacity; i > firstNewIndex; i--)
+		_freePoolIndices.push_back(i - 1);
+}
+
 void RenderObjectManager::recalculateSpecialCaseIndices()
 {
 	_renderObjectsWithAnimatorIndices.clear();
@@ -379,13 +607,194 @@ void RenderObjectManager::updateSimTransforms()
 	}
 }
 
-void RenderObjectManager::updateAnimators(float_t deltaTime)
+// Animation LOD.
+// @NOTE: a farther away (smaller on screen) animator gets posed less often and
+//        with less of its skeleton. Off screen ones still get posed now and then,
+//        since they can cast a shadow into view. Ones on a disabled render layer
+//        aren't drawn at all (not even into the shadow cascades), so those hold
+//        their last pose until the layer gets enabled again.
+// @NOTE: the skeleton gets trimmed from the bottom, counted from each animator's
+//        own deepest bone, so that a rig with a longer spine chain doesn't lose its
+//        head or face bones. The trim amounts assume a humanoid rig like SlimeGirl's
+//        (root > hips > spine > chest > shoulder > upper arm > forearm > hand > 3 finger bones).
+constexpr uint32_t ANIMATOR_LOD_REDUCED_TRIMMED_BONE_LEVELS = 2;  // Drops the finger tips (and toes).
+constexpr uint32_t ANIMATOR_LOD_LOW_TRIMMED_BONE_LEVELS     = 4;  // Drops the fingers and hands.
+struct AnimatorLOD
+{
+	uint32_t updateInterval;     // Pose every nth frame. 0 is frozen.
+	uint32_t trimmedBoneLevels;  // Bone levels skipped from the bottom of the skeleton.
+};
+constexpr AnimatorLOD ANIMATOR_LOD_FULL       = { 1, 0 };
+constexpr AnimatorLOD ANIMATOR_LOD_REDUCED    = { 2, ANIMATOR_LOD_REDUCED_TRIMMED_BONE_LEVELS };
+constexpr AnimatorLOD ANIMATOR_LOD_LOW        = { 4, ANIMATOR_LOD_LOW_TRIMMED_BONE_LEVELS };
+constexpr AnimatorLOD ANIMATOR_LOD_OFF_SCREEN = { 4, ANIMATOR_LOD_REDUCED_TRIMMED_BONE_LEVELS };  // Only seen thru its shadow.
+constexpr AnimatorLOD ANIMATOR_LOD_FROZEN     = { 0, 0 };
+constexpr float_t ANIMATOR_LOD_REDUCED_SCREEN_SIZE = 0.1f;   // Bounding sphere radius as a fraction of half the screen height.
+constexpr float_t ANIMATOR_LOD_LOW_SCREEN_SIZE     = 0.03f;
+
+AnimatorLOD calculateAnimatorLOD(const RenderObject& ro, bool layerEnabled, const GPUCameraData& camera, vec4* frustumPlanes)
+{
+	if (!layerEnabled)
+		return ANIMATOR_LOD_FROZEN;
+
+	const vec4& sphere = ro.gpuCachedBoundingSphere;
+	if (sphere[3] <= 0.0f)
+		return ANIMATOR_LOD_FULL;  // Bounding sphere hasn't been calculated yet.
+
+	for (size_t i = 0; i < 6; i++)
+		if (glm_vec3_dot(frustumPlanes[i], (float_t*)sphere) + frustumPlanes[i][3] < -sphere[3])
+			return ANIMATOR_LOD_OFF_SCREEN;
+
+	// @NOTE: clip space w is the view depth for perspective and 1 for ortho.
+	const mat4& pv = camera.projectionView;
+	float_t clipW = pv[0][3] * sphere[0] + pv[1][3] * sphere[1] + pv[2][3] * sphere[2] + pv[3][3];
+	float_t screenSize = sphere[3] * std::abs(camera.projection[1][1]) / std::max(clipW, 0.0001f);
+	if (screenSize >= ANIMATOR_LOD_REDUCED_SCREEN_SIZE)
+		return ANIMATOR_LOD_FULL;
+	if (screenSize >= ANIMATOR_LOD_LOW_SCREEN_SIZE)
+		return ANIMATOR_LOD_REDUCED;
+	return ANIMATOR_LOD_LOW;
+}
+
+void RenderObjectManager::updateAnimators(float_t deltaTime, const GPUCameraData& camera, uint32_t frameNumber)
+{
+	ZoneScoped;
+
+	// State machines run the event callbacks, so they stay singlethreaded.
+	// @NOTE: these run every frame no matter the LOD so events and triggers don't get missed.
+	for (size_t& i : _renderObjectsWithAnimatorIndices)
+		_renderObjectPool[i].animator->updateStateMachine(deltaTime);
+
+	vec4 frustumPlanes[6];
+	glm_frustum_planes((vec4*)camera.projectionView, frustumPlanes);
+
+	// @NOTE: each animator poses its own nodes and writes only its own reserved
+	//        nodes of the node collection buffer, so the posing can go wide.
+	auto updateAnimator = [&](size_t poolIndex) {
+		RenderObject& ro = _renderObjectPool[poolIndex];
+		AnimatorLOD lod = calculateAnimatorLOD(ro, _renderObjectLayersEnabled[(size_t)ro.renderLayer], camera, frustumPlanes);
+
+		// Stagger by pool index so throttled animators don't all pose on the same frame.
+		if (lod.updateInterval > 0 && (frameNumber + poolIndex) % lod.updateInterval == 0)
+		{
+			uint32_t deepestBoneDepth = ro.animator->getDeepestBoneDepth();
+			uint32_t maxBoneDepth =
+				(lod.trimmedBoneLevels == 0 ?
+				(uint32_t)-1 :
+				deepestBoneDepth - std::min(lod.trimmedBoneLevels, deepestBoneDepth));
+			ro.animator->updateAnimation(maxBoneDepth);
+		}
+	};
+
+	constexpr size_t MIN_ANIMATORS_FOR_MULTITHREADING = 4;
+	if (_renderObjectsWithAnimatorIndices.size() < MIN_ANIMATORS_FOR_MULTITHREADING)
+	{
+		for (size_t& i : _renderObjectsWithAnimatorIndices)
+			updateAnimator(i);
+	}
+	else
+	{
+		tf::Taskflow taskflow;
+		taskflow.for_each_index((size_t)0, _renderObjectsWithAnimatorIndices.size(), (size_t)1, [&](size_t i) {
+			updateAnimator(_renderObjectsWithAnimatorIndices[i]);
+		});
+		_jobExecutor.run(taskflow).wait();
+	}
+}
+
+#ifdef _DEVELOP
+void RenderObjectManager::runAnimatorBenchmark()
+{
+	// Any loaded model with animations works, but the player model is the one that matters.
+	vkglTF::Model* model = nullptr;
+	{
+		std::lock_guard<std::mutex> lg(renderObjectIndicesAndPoolMutex);
+		for (auto& [name, m] : _renderObjectModels)
+			if (!m->animations.empty())
+			{
+				model = m;
+				if (name == "SlimeGirl")
+					break;
+			}
+	}
+	if (model == nullptr)
+	{
+		debug::pushDebugMessage({
+			.message = "Animator benchmark needs a loaded model with animations",
+			.type = 1,
+			});
+		return;
+	}
+
+	// @NOTE: standalone animators (no render objects), posed at full detail like an unthrottled `updateAnimators()`.
+	//        Every animator reserves nodes in the global node collection (and the gpu buffers grow to fit), so only a
+	//        small pool gets created and each one stands in for several of the N animators. The pool gets destroyed
+	//        after each N, so pressing the button doesn't keep node collection slots reserved for the rest of the session.
+	constexpr size_t NUM_FRAMES = 20;
+	constexpr size_t MAX_POOLED_ANIMATORS = 32;
+	constexpr float_t deltaTime = 1.0f / 60.0f;
+	std::vector<vkglTF::Animator::AnimatorCallback> noCallbacks;
+	for (size_t numAnimators : { 1, 10, 100, 1000 })
+	{
+		std::vector<vkglTF::Animator*> animators(std::min(numAnimators, MAX_POOLED_ANIMATORS));
+		for (auto& animator : animators)
+			animator = new vkglTF::Animator(model, noCallbacks);
+
+		// Pooled animator `i` does the work of animators `i`, `i + poolSize`, `i + 2 * poolSize`, ...
+		auto numUpdatesForPooled = [&](size_t i) {
+			return numAnimators / animators.size() + (i < numAnimators % animators.size() ? 1 : 0);
+		};
+
+		// One at a time.
+		auto timer = std::chrono::high_resolution_clock::now();
+		for (size_t frame = 0; frame < NUM_FRAMES; frame++)
+			for (size_t i = 0; i < animators.size(); i++)
+				for (size_t update = numUpdatesForPooled(i); update > 0; update--)
+				{
+					animators[i]->updateStateMachine(deltaTime);
+					animators[i]->updateAnimation();
+				}
+		double_t singlethreadedMS = std::chrono::duration<double_t, std::milli>(std::chrono::high_resolution_clock::now() - timer).count() / NUM_FRAMES;
+
+		// Same split as `updateAnimators()`.
+		// @NOTE: each task only touches its own pooled animator, so they don't wait on each other's `updateAnimation()`.
+		timer = std::chrono::high_resolution_clock::now();
+		for (size_t frame = 0; frame < NUM_FRAMES; frame++)
+		{
+			for (size_t i = 0; i < animators.size(); i++)
+				for (size_t update = numUpdatesForPooled(i); update > 0; update--)
+					animators[i]->updateStateMachine(deltaTime);
+
+			tf::Taskflow taskflow;
+			taskflow.for_each_index((size_t)0, animators.size(), (size_t)1, [&](size_t i) {
+				for (size_t update = numUpdatesForPooled(i); update > 0; update--)
+					animators[i]->updateAnimation();
+			});
+			_jobExecutor.run(taskflow).wait();
+		}
+		double_t multithreadedMS = std::chrono::duration<double_t, std::milli>(std::chrono::high_resolution_clock::now() - timer).count() / NUM_FRAMES;
+
+		for (auto animator : animators)
+			delete animator;
+
+		debug::pushDebugMessage({
+			.message = std::format("Animators N={:<5} singlethreaded: {:8.3f}ms  multithreaded: {:8.3f}ms  (per frame)", numAnimators, singlethreadedMS, multithreadedMS),
+			.timeUntilDeletion = 15.0f,
+			});
+	}
+}
+#endif
+
+bool RenderObjectManager::uploadAnimatorNodesToGPU(size_t frameIndex)
 {
 	ZoneScoped;
 
-	// @TODO: make this multithreaded....
+	// @NOTE: also picks up poses from earlier frames that this frame's buffer doesn't have yet.
+	bool anyNodesUploaded = false;
 	for (size_t& i : _renderObjectsWithAnimatorIndices)
-		_renderObjectPool[i].animator->update(deltaTime);
+		if (_renderObjectPool[i].animator->uploadDirtyNodesToGPU(frameIndex))
+			anyNodesUploaded = true;
+	return anyNodesUploaded;
 }
 
 vkglTF::Model* RenderObjectManager::createModel(vkglTF::Model* model, const std::string& name)
@@ -397,3 +806,119 @@ vkglTF::Model* RenderObjectManager::createModel(vkglTF::Model* model, const std:
 	_renderObjectModels[name] = model;
 	return _renderObjectModels[name];  // Ehhh, we could've just sent back the original model pointer
 }
+
+vkglTF::Model* RenderObjectManager::createRuntimeModel(VulkanEngine* engine, const std::string& name, const std::vector<vkglTF::PBRMaterial>& materials)
+{
+	if (_renderObjectModels.find(name) != _renderObjectModels.end())
+	{
+		std::cerr << "[CREATE RUNTIME MODEL]" << std::endl
+			<< "ERROR: model with name \"" << name << "\" already exists. Returning nullptr" << std::endl;
+		return nullptr;
+	}
+
+	vkglTF::Model* model = new vkglTF::Model();
+	model->initRuntimeMesh(engine, materials);
+
+	// @NOTE: the model gets its own slot appended to the bucket hierarchy instead of rebuilding it.
+	std::lock_guard<std::mutex> lg(renderObjectIndicesAndPoolMutex);
+	createModel(model, name);
+	addModelBuckets(model);
+	return model;
+}
+
+void RenderObjectManager::requestRuntimeModelMesh(vkglTF::Model* model, vkglTF::RuntimeMeshData&& meshData)
+{
+	std::lock_guard<std::mutex> lg(_runtimeModelRequestsMutex);
+
+	// Only the newest mesh matters if the model already has one waiting.
+	for (size_t i = 0; i < _runtimeModelMeshRequestModels.size(); i++)
+		if (_runtimeModelMeshRequestModels[i] == model)
+		{
+			_runtimeModelMeshRequestDatas[i] = std::move(meshData);
+			return;
+		}
+
+	_runtimeModelMeshRequestModels.push_back(model);
+	_runtimeModelMeshRequestDatas.push_back(std::move(meshData));
+}
+
+void RenderObjectManager::destroyRuntimeModel(const std::string& name)
+{
+	vkglTF::Model* model;
+	{
+		std::lock_guard<std::mutex> lg(renderObjectIndicesAndPoolMutex);
+		auto it = _renderObjectModels.find(name);
+		if (it == _renderObjectModels.end())
+		{
+			std::cerr << "[DESTROY RUNTIME MODEL]" << std::endl
+				<< "ERROR: model with name \"" << name << "\" not found." << std::endl;
+			return;
+		}
+		model = it->second;
+		_renderObjectModels.erase(it);
+		freeModelBuckets(model);
+	}
+
+	// Buffers could still be in use by frames in flight, so retire with the next batch of requests.
+	std::lock_guard<std::mutex> lg(_runtimeModelRequestsMutex);
+	for (int64_t i = (int64_t)_runtimeModelMeshRequestModels.size() - 1; i >= 0; i--)
+		if (_runtimeModelMeshRequestModels[i] == model)
+		{
+			_runtimeModelMeshRequestModels.erase(_runtimeModelMeshRequestModels.begin() + i);
+			_runtimeModelMeshRequestDatas.erase(_runtimeModelMeshRequestDatas.begin() + i);
+		}
+	_runtimeModelsToDestroy.push_back(model);
+}
+
+void RenderObjectManager::processRuntimeModelRequests(VulkanEngine* engine, size_t frameIndex)
+{
+	ZoneScoped;
+
+	// Whatever got retired the last time this frame index came around isn't in use by the GPU
+	// anymore (its fence was just waited on), so it's safe to destroy now.
+	RetiredRuntimeModelResources& retired = _retiredRuntimeModelResources[frameIndex];
+	for (AllocatedBuffer& buffer : retired.buffers)
+		vmaDestroyBuffer(_allocator, buffer._buffer, buffer._allocation);
+	retired.buffers.clear();
+	for (vkglTF::Model* model : retired.models)
+	{
+		model->destroy(_allocator);
+		delete model;
+	}
+	retired.models.clear();
+
+	std::vector<vkglTF::Model*> meshRequestModels;
+	std::vector<vkglTF::RuntimeMeshData> meshRequestDatas;
+	{
+		std::lock_guard<std::mutex> lg(_runtimeModelRequestsMutex);
+		if (_runtimeModelMeshRequestModels.empty() && _runtimeModelsToDestroy.empty())
+			return;
+		meshRequestModels.swap(_runtimeModelMeshRequestModels);
+		meshRequestDatas.swap(_runtimeModelMeshRequestDatas);
+		retired.models.swap(_runtimeModelsToDestroy);
+	}
+
+	// @NOTE: the other frame in flight could still be reading from the buffers that are getting
+	//        replaced, so they get retired instead of destroyed right away.
+	for (size_t i = 0; i < meshRequestModels.size(); i++)
+		meshRequestModels[i]->uploadRuntimeMesh(meshRequestDatas[i], retired.buffers);
+
+	// Index counts and bounding spheres changed, so only recalculate the remeshed models' draws and object data.
+	{
+		std::lock_guard<std::mutex> lg(renderObjectIndicesAndPoolMutex);
+		if (!_isMetaMeshListUnoptimized)
+			for (vkglTF::Model* model : meshRequestModels)
+			{
+				size_t modelIdx = model->assignedModelIdx;
+				if (modelIdx >= _modelsByModelIdx.size() || _modelsByModelIdx[modelIdx] != model)
+					continue;
+				_modelMeshDraws[modelIdx].clear();
+				uint32_t _ = 0;
+				model->appendPrimitiveDraws(_modelMeshDraws[modelIdx], _);
+			}
+		for (size_t poolIndex : _renderObjectsIndices)
+			if (std::find(meshRequestModels.begin(), meshRequestModels.end(), _renderObjectPool[poolIndex].model) != meshRequestModels.end())
+				_renderObjectPool[poolIndex].gpuObjectDataStale = true;
+		_drawCommandsGeneration++;
+	}
+}
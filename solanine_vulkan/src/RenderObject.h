@@ -3,11 +3,10 @@
 #include "Settings.h"
 #include "VkDataStructures.h"
 
-namespace vkglTF { struct Model; struct Animator; }
+namespace vkglTF { struct Model; struct Animator; struct PBRMaterial; struct RuntimeMeshData; }
 
-#ifdef _DEVELOP
 class VulkanEngine;
-#endif
+struct GPUCameraData;
 
 
 struct GPUInstancePointer
@@ -35,17 +34,76 @@ struct RenderObject
 	std::string attachedEntityGuid;  // @NOTE: this is just for @DEBUG purposes for the imgui property panel
 	std::vector<GPUInstancePointer> calculatedModelInstances;
 	std::vector<size_t> perPrimitiveUniqueMaterialBaseIndices;
+
+	// Cached GPU object data. Only gets recalculated when `transformMatrix` changes.
+	mat4 gpuCachedTransformMatrix  = GLM_MAT4_ZERO_INIT;
+	vec4 gpuCachedBoundingSphere   = GLM_VEC4_ZERO_INIT;
+	bool gpuObjectDataStale        = true;  // Forces a recalculation (i.e. newly registered or model reloaded).
+	uint8_t gpuObjectDataDirtyBits = 0;     // One bit per `FRAME_OVERLAP` frame that still needs the cached data uploaded.
+};
+
+// What `registerRenderObjects()` hands back. The generation gets bumped every time the pool slot is freed,
+// so a stale handle to a slot that's since been reused by another render object gets caught.
+struct RenderObjectHandle
+{
+	RenderObject* renderObject = nullptr;
+	uint32_t      generation   = 0;
+
+	RenderObjectHandle() = default;
+	RenderObjectHandle(std::nullptr_t) {}
+	RenderObjectHandle(RenderObject* renderObject, uint32_t generation) : renderObject(renderObject), generation(generation) {}
+
+	RenderObject* operator->() const { return renderObject; }
+	RenderObject& operator*() const  { return *renderObject; }
+	operator RenderObject*() const   { return renderObject; }
+};
+
+// Pool that grows one page at a time, so pointers to its elements never go stale.
+template<typename T, size_t PageSize>
+class PagedPool
+{
+public:
+	PagedPool() = default;
+	PagedPool(const PagedPool&) = delete;
+	PagedPool& operator=(const PagedPool&) = delete;
+	~PagedPool()
+	{
+		for (T* page : pages)
+			delete[] page;
+	}
+
+	T& operator[](size_t index) { return pages[index / PageSize][index % PageSize]; }
+	const T& operator[](size_t index) const { return pages[index / PageSize][index % PageSize]; }
+	size_t capacity() const { return pages.size() * PageSize; }
+	void addPage() { pages.push_back(new T[PageSize]); }
+
+	bool indexOf(const T* element, size_t& outIndex) const
+	{
+		for (size_t i = 0; i < pages.size(); i++)
+			if (element >= pages[i] && element < pages[i] + PageSize)
+			{
+				outIndex = i * PageSize + (size_t)(element - pages[i]);
+				return true;
+			}
+		return false;
+	}
+
+private:
+	std::vector<T*> pages;
 };
 
 class RenderObjectManager
 {
 public:
-	bool registerRenderObjects(std::vector<RenderObject> inRenderObjectDatas, std::vector<RenderObject**> outRenderObjectDatas);
-	void unregisterRenderObjects(std::vector<RenderObject*> objRegistrations);
+	bool registerRenderObjects(std::vector<RenderObject> inRenderObjectDatas, std::vector<RenderObjectHandle*> outRenderObjectDatas);
+	void unregisterRenderObjects(std::vector<RenderObjectHandle> objRegistrations);
+	void setRenderLayer(const RenderObjectHandle& handle, RenderLayer renderLayer);  // @NOTE: use this instead of writing `renderLayer` directly, so the mesh buckets follow along.
 
 	bool checkIsMetaMeshListUnoptimized();
 	void flagMetaMeshListAsUnoptimized();
-	void optimizeMetaMeshList();
+	void optimizeMetaMeshList();     // @NOTE: lock `renderObjectIndicesAndPoolMutex` before calling.
+	bool compactStaleMeshBuckets();  // @NOTE: lock `renderObjectIndicesAndPoolMutex` before calling.
+	void flagInstanceDataChanged();  // Call after changing `calculatedModelInstances` of a registered render object.
 
 #ifdef _DEVELOP
 	vkglTF::Model* getModel(const std::string& name, void* owner, std::function<void()>&& reloadCallback);  // This is to support model hot-reloading via a callback lambda
@@ -55,6 +113,11 @@ public:
 	vkglTF::Model* getModel(const std::string& name);
 #endif
 
+	// Models whose mesh gets generated at runtime (i.e. meshed voxel fields).
+	vkglTF::Model* createRuntimeModel(VulkanEngine* engine, const std::string& name, const std::vector<vkglTF::PBRMaterial>& materials);
+	void           requestRuntimeModelMesh(vkglTF::Model* model, vkglTF::RuntimeMeshData&& meshData);  // Gets swapped in at the start of the next rendered frame.
+	void           destroyRuntimeModel(const std::string& name);  // Unregister all render objects using the model first.
+
 private:
 	RenderObjectManager(VmaAllocator& allocator);
 	~RenderObjectManager();
@@ -67,12 +130,21 @@ private:
 	std::vector<size_t> _renderObjectsWithAnimatorIndices;
 	void recalculateSpecialCaseIndices();
 	void updateSimTransforms();
-	void updateAnimators(float_t deltaTime);
+	void updateAnimators(float_t deltaTime, const GPUCameraData& camera, uint32_t frameNumber);
+	bool uploadAnimatorNodesToGPU(size_t frameIndex);  // @NOTE: render thread only, after waiting on the frame's fence. Returns whether any animator's nodes got uploaded.
+#ifdef _DEVELOP
+	void runAnimatorBenchmark();  // Times posing 1-1000 animators of a loaded model one at a time vs. on `_jobExecutor`.
+#endif
+
+	tf::Executor _jobExecutor{ std::max(2u, std::thread::hardware_concurrency()) - 1 };
 
-	std::vector<size_t>                                   _renderObjectsIndices;
-    std::array<bool,         RENDER_OBJECTS_MAX_CAPACITY> _renderObjectsIsRegistered;  // @NOTE: this will be filled with `false` on init  (https://stackoverflow.com/questions/67648693/safely-initializing-a-stdarray-of-bools)
-    std::array<RenderObject, RENDER_OBJECTS_MAX_CAPACITY> _renderObjectPool;
+	std::vector<size_t>                                   _renderObjectsIndices;  // @NOTE: kept sorted by pool index.
+	std::vector<size_t>                                   _freePoolIndices;       // Stack of unregistered pool indices, so grabbing a slot is O(1).
+	std::vector<bool>                                     _renderObjectsIsRegistered;
+	std::vector<uint32_t>                                 _renderObjectGenerations;  // Bumped when the slot gets freed.
+	PagedPool<RenderObject, RENDER_OBJECTS_PAGE_SIZE>     _renderObjectPool;
 	bool*                                                 _renderObjectLayersEnabled = new bool[] { true, false, true };
+	void growRenderObjectPool();
 
 	std::unordered_map<std::string, vkglTF::Model*>       _renderObjectModels;
 #ifdef _DEVELOP
@@ -85,15 +157,34 @@ private:
 #endif
 	vkglTF::Model* createModel(vkglTF::Model* model, const std::string& name);
 
+	std::mutex                            _runtimeModelRequestsMutex;
+	std::vector<vkglTF::Model*>           _runtimeModelMeshRequestModels;
+	std::vector<vkglTF::RuntimeMeshData>  _runtimeModelMeshRequestDatas;  // @NOTE: parallel with `_runtimeModelMeshRequestModels`.
+	std::vector<vkglTF::Model*>           _runtimeModelsToDestroy;
+	struct RetiredRuntimeModelResources
+	{
+		std::vector<AllocatedBuffer> buffers;
+		std::vector<vkglTF::Model*>  models;
+	};
+	RetiredRuntimeModelResources _retiredRuntimeModelResources[FRAME_OVERLAP];  // Destroyed the next time the same frame index comes around, since its fence has been waited on by then.
+	void processRuntimeModelRequests(VulkanEngine* engine, size_t frameIndex);
+
 	std::vector<std::vector<MeshCapturedInfo>> _modelMeshDraws;
-	bool _skinnedMeshEntriesExist = false;
+	std::vector<vkglTF::Model*> _modelsByModelIdx;  // @NOTE: nullptr for slots freed by destroyed runtime models.
+	std::vector<size_t> _freeModelIdxs;
+	void addModelBuckets(vkglTF::Model* model);   // Gives a runtime model its own slot without rebuilding the hierarchy.
+	void freeModelBuckets(vkglTF::Model* model);
+	size_t _numSkinnedMeshBucketEntries = 0;
+	bool _skinnedMeshBucketsChanged = false;
 	uint8_t _skinnedMeshModelMemAddr;
 
 	bool _isMetaMeshListUnoptimized = true;
+	std::atomic<uint64_t> _drawCommandsGeneration = 1;  // Bumped whenever the compacted draw commands would come out different.
 
 	struct MeshBucket
 	{
 		std::vector<size_t> renderObjectIndices;
+		std::vector<size_t> pendingRemovals;  // @NOTE: removed lazily in `compactStaleMeshBuckets()`, so that many unregistrations only cost one pass over the bucket.
 	};
 	struct ModelBucket
 	{
@@ -112,6 +203,11 @@ private:
 	size_t _numModelBuckets = 0;
 	std::vector<size_t> _numMeshBucketsByModelIdx;
 
+	std::vector<bool> _renderObjectsIsInMeshBuckets;  // Whether the object got inserted (i.e. was visible at the time), so that removal doesn't depend on the current render layer.
+	std::vector<MeshBucket*> _staleMeshBuckets;
+	void insertIntoMeshBuckets(size_t poolIndex);
+	void removeFromMeshBuckets(size_t poolIndex);
+
 	VmaAllocator& _allocator;
 
 	friend class VulkanEngine;
@@ -13,7 +13,7 @@
 struct ScannableItem_XData
 {
     RenderObjectManager* rom;
-    RenderObject* renderObj;
+    RenderObjectHandle renderObj;
     vec3 position = GLM_VEC3_ZERO_INIT;
     size_t scannableItemId = 0;
 #ifdef _DEVELOP
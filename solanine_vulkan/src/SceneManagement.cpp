@@ -159,6 +159,7 @@ namespace scene
     bool loadSerializationFull(const std::string& fullFname, const std::string& fileTag, bool ownEntities, std::vector<Entity*>& outEntityPtrs)
     {
         bool success = true;
+        physengine::beginBodyBatch();  // All the bodies of the loaded entities go into the world at once.
 
         DataSerializer ds;
         std::string newObjectType = "";
@@ -197,6 +198,7 @@ namespace scene
                     // File type is discerned to be incorrect.
                     std::cerr << "[SCENE MANAGEMENT]" << std::endl
                         << "ERROR: File must start with proper file marker. File is discerned to be corrupt. Abort." << std::endl;
+                    physengine::endBodyBatch();
                     return false;
                 }
             }
@@ -247,6 +249,7 @@ namespace scene
             success &= (newEntity != nullptr);
         }
 
+        physengine::endBodyBatch();
         return success;
     }
 
@@ -276,11 +279,24 @@ namespace scene
             return loadSceneImmediate(name);
     }
 
+    std::string getVoxelShapeCachePath(const std::string& sceneName)
+    {
+        // @NOTE: sits right next to the scene file.
+        return std::filesystem::path(SCENE_DIRECTORY_PATH + sceneName).replace_extension(".vfcache").string();
+    }
+
     bool loadSceneImmediate(const std::string& name)
     {
+        // @NOTE: reloading a scene takes the cooked voxel field shapes out of
+        //        the shape cache instead of cooking them all over again.
+        physengine::loadVoxelShapeCache(getVoxelShapeCachePath(name));
+
         std::vector<Entity*> _;
         bool ret = loadSerializationFull(SCENE_DIRECTORY_PATH + name, std::string(FILE_SCENE_TAG), false, _);
 
+        if (physengine::clearVoxelShapeCache())
+            physengine::requestSaveVoxelShapeCache(getVoxelShapeCachePath(name));  // Something had to get cooked, so save it for next time.
+
         if (ret)
             debug::pushDebugMessage({
 			    .message = "Successfully loaded scene \"" + name + "\"",
@@ -334,6 +350,8 @@ namespace scene
         }
         outfile.close();
 
+        physengine::requestSaveVoxelShapeCache(getVoxelShapeCachePath(name));
+
         debug::pushDebugMessage({
 			.message = "Successfully saved scene \"" + name + "\"",
 			});
@@ -15,8 +15,12 @@ constexpr uint32_t SHADOWMAP_JITTERMAP_DIMENSION_Z = 4 / 2;  // 2x2 samples (??m
 
 constexpr unsigned int FRAME_OVERLAP = 2;
 
-constexpr size_t RENDER_OBJECTS_MAX_CAPACITY = 10000;
-constexpr size_t INSTANCE_PTR_MAX_CAPACITY   = 100000;
+// @NOTE: these pools grow on demand instead of having a hard maximum. The numbers are how
+//        many entries get added each time the pool (and its gpu side buffers) run out of room.
+constexpr size_t RENDER_OBJECTS_PAGE_SIZE     = 1024;
+constexpr size_t INSTANCE_PTR_CHUNK_SIZE      = 4096;
+constexpr size_t ANIMATOR_NODES_CHUNK_SIZE    = 32;  // @NOTE: each node is ~8kb (bc of `MAX_NUM_JOINTS`).
+constexpr size_t TEXTMESHES_MAX_CAPACITY      = 10000;
 
 constexpr size_t MAX_NUM_MAPS = 128;
 constexpr size_t MAX_NUM_VOXEL_FIELD_LIGHTMAPS = 8;
@@ -32,10 +32,10 @@ struct SimulationCharacter_XData
 
     RenderObjectManager*     rom;
     Camera*                  camera;
-    RenderObject*            characterRenderObj;
-    RenderObject*            handleRenderObj;
-    RenderObject*            weaponRenderObj;
-    std::string              weaponAttachmentJointName;
+    RenderObjectHandle       characterRenderObj;
+    RenderObjectHandle       handleRenderObj;
+    RenderObjectHandle       weaponRenderObj;
+    int32_t                  weaponAttachmentJointIndex = -1;  // @NOTE: looked up once per attachment change with `lookupJointIndex()`.
 
     physengine::CapsulePhysicsData* cpd;
 
@@ -221,6 +221,7 @@ struct SimulationCharacter_XData
         vec2 bladeDistanceStartEnd = { 1.0f, 5.0f };
         std::string bladeBoneName = "Hand Attachment";
         std::string bladeBoneName_dirty = bladeBoneName;
+        int32_t bladeBoneIndex = -1;
 
         std::string hitscanLaunchVelocityExportString = "";
         std::string hitscanSetExportString = "";
@@ -304,6 +305,15 @@ struct SimulationCharacter_XData
 
 inline bool isPlayer(SimulationCharacter_XData* d) { return d->characterType == CHARACTER_TYPE_PLAYER; }
 
+int32_t lookupJointIndex(SimulationCharacter_XData* d, const std::string& jointName)
+{
+    int32_t jointIndex = d->characterRenderObj->animator->getJointIndex(jointName);
+    if (jointIndex < 0)
+        std::cerr << "[LOOKUP JOINT INDEX]" << std::endl
+            << "WARNING: joint \"" << jointName << "\" not found in character model." << std::endl;
+    return jointIndex;
+}
+
 void processOutOfHealth(EntityManager* em, Entity* e, SimulationCharacter_XData* d)
 {
     // Drop off items and then destroy self.
@@ -456,7 +466,7 @@ void processAttack(SimulationCharacter_XData* d)
                 // Attempt to eat.
                 globalState::savedPlayerHealth += 5;
                 d->materializedItem = nullptr;  // Ate the item off the handle.
-                d->weaponRenderObj->renderLayer = RenderLayer::INVISIBLE;
+                d->rom->setRenderLayer(d->weaponRenderObj, RenderLayer::INVISIBLE);
                 AudioEngine::getInstance().playSound("res/sfx/wip_Pl_Eating_S00.wav");
                 AudioEngine::getInstance().playSound("res/sfx/wip_Sys_ExtraHeartUp_01.wav");
                 d->characterRenderObj->animator->setTrigger("goto_sheath_weapon");  // @TODO: figure out how to prevent ice breaking sfx in hokasu event.  @REPLY: you need to make another animation that has character eating the item and then put away the weapon, and then goto that animation instead of the "break off" animation.
@@ -1175,7 +1185,7 @@ void processWazaUpdate(SimulationCharacter_XData* d, EntityManager* em, float_t
     //
     // Execute all hitscans that need to be executed in the timeline.
     //
-    size_t hitscanLayer = physengine::getCollisionLayer("HitscanInteractible");
+    JPH::ObjectLayer hitscanLayer = physengine::Layers::PROJECTILE;
     vec3 offset(0.0f, -physengine::getLengthOffsetToBase(*d->cpd), 0.0f);
     assert(d->currentWaza->hitscanNodes.size() != 1);
 
@@ -1215,8 +1225,8 @@ void processWazaUpdate(SimulationCharacter_XData* d, EntityManager* em, float_t
                 vec3 directionAndMagnitude;  // https://www.youtube.com/watch?v=A05n32Bl0aY
                 glm_vec3_sub(pt2, pt1, directionAndMagnitude);
 
-                std::string hitGuid;
-                if (physengine::raycast(pt1, directionAndMagnitude, hitGuid))
+                Entity* hitEntity;
+                if (physengine::raycast(pt1, directionAndMagnitude, hitscanLayer, hitEntity))
                 {
                     // Successful hitscan!
                     float_t attackLvl =
@@ -1224,7 +1234,7 @@ void processWazaUpdate(SimulationCharacter_XData* d, EntityManager* em, float_t
                             d->materializedItem->weaponStats.attackPower :
                             d->materializedItem->weaponStats.attackPowerWhenDulled);
 
-                    if (hitGuid == myGuid)
+                    if (hitEntity == nullptr || hitEntity == d->cpd->entity)
                         continue;  // Ignore if hitscan to self
 
                     DataSerializer ds;
@@ -1247,7 +1257,7 @@ void processWazaUpdate(SimulationCharacter_XData* d, EntityManager* em, float_t
                     ds.dumpFloat(ignoreYF);
 
                     DataSerialized dsd = ds.getSerializedData();
-                    if (em->sendMessage(hitGuid, dsd))
+                    if (hitEntity->processMessage(dsd))
                     {
                         playWazaHitSfx = true;
 
@@ -1295,19 +1305,23 @@ void processWazaUpdate(SimulationCharacter_XData* d, EntityManager* em, float_t
             glm_vec3_add(forceZoneOriginWS, d->position, forceZoneOriginWS);
         }
 
-        // @COPYPASTA
-        for (size_t i = 0; i < physengine::getNumCapsules(); i++)
-        {
-            physengine::CapsulePhysicsData* otherCPD = physengine::getCapsuleByIndex(i);
-            if (otherCPD->entityGuid == myGuid)
-                continue;  // Don't vacuum/force self!
+        // Only the characters around the vacuum/force zone get looked at.
+        constexpr size_t maxOverlaps = 64;
+        physengine::OverlapResult overlaps[maxOverlaps];
 
-            // Vacuum suck in.
-            if (d->currentWaza->vacuumSuckIn.enabled)
+        // Vacuum suck in.
+        if (d->currentWaza->vacuumSuckIn.enabled)
+        {
+            float_t radius = d->currentWaza->vacuumSuckIn.radius;
+            size_t numOverlaps = physengine::overlapSphere(suckPositionWS, radius, physengine::Layers::CHARACTER, overlaps, maxOverlaps);
+            for (size_t i = 0; i < numOverlaps; i++)
             {
+                Entity* other = overlaps[i].entity;
+                if (other == d->cpd->entity)
+                    continue;  // Don't vacuum self!
+
                 vec3 deltaPosition;
-                glm_vec3_sub(suckPositionWS, otherCPD->currentCOMPosition, deltaPosition);
-                float_t radius = d->currentWaza->vacuumSuckIn.radius;
+                glm_vec3_sub(suckPositionWS, overlaps[i].centerOfMass, deltaPosition);
                 if (glm_vec3_norm2(deltaPosition) < radius * radius)
                 {
                     DataSerializer ds;
@@ -1318,34 +1332,40 @@ void processWazaUpdate(SimulationCharacter_XData* d, EntityManager* em, float_t
                     ds.dumpFloat(d->currentWaza->vacuumSuckIn.strength);
 
                     DataSerialized dsd = ds.getSerializedData();
-                    em->sendMessage(otherCPD->entityGuid, dsd);
+                    other->processMessage(dsd);
                 }
 
                 // @DEBUG: visualization that shows how far away vacuum radius is.
                 vec3 midpt;
                 float_t t = radius / glm_vec3_norm(deltaPosition);
-                glm_vec3_lerp(suckPositionWS, otherCPD->currentCOMPosition, t, midpt);
+                glm_vec3_lerp(suckPositionWS, overlaps[i].centerOfMass, t, midpt);
                 if (glm_vec3_norm2(deltaPosition) < radius * radius)
                 {
-                    physengine::drawDebugVisLine(suckPositionWS, otherCPD->currentCOMPosition, physengine::DebugVisLineType::SUCCESS);
-                    physengine::drawDebugVisLine(otherCPD->currentCOMPosition, midpt, physengine::DebugVisLineType::KIKKOARMY);
+                    physengine::drawDebugVisLine(suckPositionWS, overlaps[i].centerOfMass, physengine::DebugVisLineType::SUCCESS);
+                    physengine::drawDebugVisLine(overlaps[i].centerOfMass, midpt, physengine::DebugVisLineType::KIKKOARMY);
                 }
                 else
                 {
                     physengine::drawDebugVisLine(suckPositionWS, midpt, physengine::DebugVisLineType::AUDACITY);
-                    physengine::drawDebugVisLine(midpt, otherCPD->currentCOMPosition, physengine::DebugVisLineType::VELOCITY);
+                    physengine::drawDebugVisLine(midpt, overlaps[i].centerOfMass, physengine::DebugVisLineType::VELOCITY);
                 }
             }
+        }
 
-            // Force zone.
-            if (forceZoneEnabled)
+        // Force zone.
+        if (forceZoneEnabled)
+        {
+            size_t numOverlaps = physengine::overlapBox(forceZoneOriginWS, d->currentWaza->forceZone.bounds, physengine::Layers::CHARACTER, overlaps, maxOverlaps);
+            for (size_t i = 0; i < numOverlaps; i++)
             {
+                Entity* other = overlaps[i].entity;
+                if (other == d->cpd->entity)
+                    continue;  // Don't force self!
+
                 vec3 deltaPosition;
-                glm_vec3_sub(forceZoneOriginWS, otherCPD->currentCOMPosition, deltaPosition);
+                glm_vec3_sub(forceZoneOriginWS, overlaps[i].centerOfMass, deltaPosition);
                 vec3 deltaPositionAbs;
                 glm_vec3_abs(deltaPosition, deltaPositionAbs);
-                vec3 boundsComparison;
-                glm_vec3_sub(d->currentWaza->forceZone.bounds, deltaPositionAbs, boundsComparison);
                 if (deltaPositionAbs[0] < d->currentWaza->forceZone.bounds[0] &&
                     deltaPositionAbs[1] < d->currentWaza->forceZone.bounds[1] &&
                     deltaPositionAbs[2] < d->currentWaza->forceZone.bounds[2])
@@ -1356,7 +1376,7 @@ void processWazaUpdate(SimulationCharacter_XData* d, EntityManager* em, float_t
                     ds.dumpVec3(d->currentWaza->forceZone.forceVelocity);
 
                     DataSerialized dsd = ds.getSerializedData();
-                    em->sendMessage(otherCPD->entityGuid, dsd);
+                    other->processMessage(dsd);
                 }
             }
         }
@@ -1401,7 +1421,7 @@ SimulationCharacter::SimulationCharacter(EntityManager* em, RenderObjectManager*
 
     // Create physics character.
     bool useCCD = (isPlayer(_data));
-    _data->cpd = physengine::createCharacter(getGUID(), _data->position, 0.375f, 1.25f, useCCD);  // Total height is 2, but r*2 is subtracted to get the capsule height (i.e. the line segment length that the capsule rides along)
+    _data->cpd = physengine::createCharacter(this, _data->position, 0.375f, 1.25f, useCCD);  // Total height is 2, but r*2 is subtracted to get the capsule height (i.e. the line segment length that the capsule rides along)
 
     if (isPlayer(_data))
     {
@@ -1429,7 +1449,6 @@ SimulationCharacter::SimulationCharacter(EntityManager* em, RenderObjectManager*
     }
 
     // Create render objects.
-    _data->weaponAttachmentJointName = "Back Attachment";
     std::vector<vkglTF::Animator::AnimatorCallback> animatorCallbacks = {
         {
             "EventEnableMCM", [&]() {
@@ -1444,19 +1463,19 @@ SimulationCharacter::SimulationCharacter(EntityManager* em, RenderObjectManager*
         {
             "EventSetAttachmentToHand", [&]() {
                 std::cout << "TO HAND" << std::endl;
-                _data->weaponAttachmentJointName = "Hand Attachment";
+                _data->weaponAttachmentJointIndex = lookupJointIndex(_data, "Hand Attachment");
             }
         },
         {
             "EventSetAttachmentToBack", [&]() {
                 std::cout << "TO BACK" << std::endl;
-                _data->weaponAttachmentJointName = "Back Attachment";
+                _data->weaponAttachmentJointIndex = lookupJointIndex(_data, "Back Attachment");
             }
         },
         {
             "EventMaterializeBlade", [&]() {
                 std::cout << "MATERIALIZE BLADE" << std::endl;
-                _data->weaponRenderObj->renderLayer = RenderLayer::VISIBLE;  // @TODO: in the future will have model switching.
+                _data->rom->setRenderLayer(_data->weaponRenderObj, RenderLayer::VISIBLE);  // @TODO: in the future will have model switching.
                 // AudioEngine::getInstance().playSound("res/sfx/wip_Pl_Kago_Ready.wav");
                 AudioEngine::getInstance().playSound("res/sfx/wip_Weapon_Lsword_035_Blur01.wav");
             }
@@ -1464,7 +1483,7 @@ SimulationCharacter::SimulationCharacter(EntityManager* em, RenderObjectManager*
         {
             "EventHokasuBlade", [&]() {
                 std::cout << "HOKASU BLADE" << std::endl;
-                _data->weaponRenderObj->renderLayer = RenderLayer::INVISIBLE;  // @TODO: in the future will have model switching.
+                _data->rom->setRenderLayer(_data->weaponRenderObj, RenderLayer::INVISIBLE);  // @TODO: in the future will have model switching.
                 // @TODO: leave the item on the ground if you wanna reattach or use or litter.
                 AudioEngine::getInstance().playSoundFromList({
                     "res/sfx/wip_Pl_IceBreaking00.wav",
@@ -1583,6 +1602,8 @@ SimulationCharacter::SimulationCharacter(EntityManager* em, RenderObjectManager*
         },
         { &_data->characterRenderObj, &_data->handleRenderObj, &_data->weaponRenderObj }
     );
+    _data->weaponAttachmentJointIndex = lookupJointIndex(_data, "Back Attachment");
+    _data->attackWazaEditor.bladeBoneIndex = lookupJointIndex(_data, _data->attackWazaEditor.bladeBoneName);
 
     glm_mat4_identity(_data->characterRenderObj->simTransformOffset);
     glm_translate(_data->characterRenderObj->simTransformOffset, vec3{ 0.0f, -physengine::getLengthOffsetToBase(*_data->cpd), 0.0f });
@@ -1595,6 +1616,7 @@ SimulationCharacter::SimulationCharacter(EntityManager* em, RenderObjectManager*
         inst.voxelFieldLightingGridID = 1;
     for (auto& inst : _data->weaponRenderObj->calculatedModelInstances)
         inst.voxelFieldLightingGridID = 1;
+    _data->rom->flagInstanceDataChanged();
 }
 
 SimulationCharacter::~SimulationCharacter()
@@ -2116,8 +2138,8 @@ void calculateBladeStartEndFromHandAttachment(SimulationCharacter_XData* d, vec3
     mat4 offsetMat = GLM_MAT4_IDENTITY_INIT;
     glm_translate(offsetMat, vec3{ 0.0f, -physengine::getLengthOffsetToBase(*d->cpd) / d->modelSize, 0.0f });
 
-    mat4 attachmentJointMat;
-    d->characterRenderObj->animator->getJointMatrix(d->attackWazaEditor.bladeBoneName, attachmentJointMat);
+    mat4 attachmentJointMat = GLM_MAT4_IDENTITY_INIT;
+    d->characterRenderObj->animator->getJointMatrix(d->attackWazaEditor.bladeBoneIndex, attachmentJointMat);
     glm_mat4_mul(offsetMat, attachmentJointMat, attachmentJointMat);
 
     glm_mat4_mulv3(attachmentJointMat, vec3{ 0.0f, d->attackWazaEditor.bladeDistanceStartEnd[0], 0.0f }, 1.0f, bladeStart);
@@ -2482,8 +2504,8 @@ void SimulationCharacter::lateUpdate(float_t deltaTime)
     glm_scale(transform, vec3{ _data->modelSize, _data->modelSize, _data->modelSize });
     glm_mat4_copy(transform, _data->characterRenderObj->transformMatrix);
 
-    mat4 attachmentJointMat;
-    _data->characterRenderObj->animator->getJointMatrix(_data->weaponAttachmentJointName, attachmentJointMat);
+    mat4 attachmentJointMat = GLM_MAT4_IDENTITY_INIT;
+    _data->characterRenderObj->animator->getJointMatrix(_data->weaponAttachmentJointIndex, attachmentJointMat);
     glm_mat4_mul(_data->characterRenderObj->transformMatrix, attachmentJointMat, _data->weaponRenderObj->transformMatrix);
     glm_mat4_copy(_data->weaponRenderObj->transformMatrix, _data->handleRenderObj->transformMatrix);
 }
@@ -2936,6 +2958,7 @@ void attackWazaEditorRenderImGui(SimulationCharacter_XData* d)
         if (ImGui::Button("Change!##Hitscan-based bone name"))
         {
             d->attackWazaEditor.bladeBoneName = d->attackWazaEditor.bladeBoneName_dirty;
+            d->attackWazaEditor.bladeBoneIndex = lookupJointIndex(d, d->attackWazaEditor.bladeBoneName);
         }
     }
     if (ImGui::Button("Set baking hitscan range start"))
@@ -43,7 +43,7 @@ namespace textmesh
 	void init(VulkanEngine* engineRef)
 	{
 		engine = engineRef;
-		textmeshes.reserve(RENDER_OBJECTS_MAX_CAPACITY);  // @NOTE: this protects pointers from going stale if new space needs to be reallocated.
+		textmeshes.reserve(TEXTMESHES_MAX_CAPACITY);  // @NOTE: this protects pointers from going stale if new space needs to be reallocated.
 
 		// Create descriptor for ui camera data
 		gpuUICameraBuffer = engine->createBuffer(sizeof(GPUUICamera), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
@@ -465,9 +465,9 @@ namespace textmesh
 
 	TextMesh* createAndRegisterTextMesh(std::string fontName, HorizontalAlignment halign, VerticalAlignment valign, std::string text)
 	{
-		if (textmeshes.size() >= RENDER_OBJECTS_MAX_CAPACITY)
+		if (textmeshes.size() >= TEXTMESHES_MAX_CAPACITY)
 		{
-			std::cerr << "ERROR: New text mesh cannot be created because textmesh list is at capacity (" << RENDER_OBJECTS_MAX_CAPACITY << ")" << std::endl;
+			std::cerr << "ERROR: New text mesh cannot be created because textmesh list is at capacity (" << TEXTMESHES_MAX_CAPACITY << ")" << std::endl;
 			return nullptr;
 		}
 		textmeshes.push_back(TextMesh());
@@ -19,6 +19,7 @@ struct AllocatedBuffer
 {
 	VkBuffer _buffer;
 	VmaAllocation _allocation;
+	void* _mappedData = nullptr;  // @NOTE: only set if the buffer was created persistently mapped.
 };
 
 struct AllocatedImage
@@ -420,4 +420,17 @@ namespace vkutil
         VkDescriptorSetLayout layout;
         return build(set, layout);
     }
+
+    bool DescriptorBuilder::buildOrUpdate(VkDescriptorSet& set, VkDescriptorSetLayout& layout)
+    {
+        if (set == VK_NULL_HANDLE)
+            return build(set, layout);
+
+        // Reuse the set instead of allocating another one out of the pool.
+        for (VkWriteDescriptorSet& w : writes)
+            w.dstSet = set;
+
+        vkUpdateDescriptorSets(vkutil::descriptorallocator::device, (uint32_t)writes.size(), writes.data(), 0, nullptr);
+        return true;
+    }
 }
\ No newline at end of file
@@ -48,6 +48,7 @@ namespace vkutil
 
         bool build(VkDescriptorSet& set, VkDescriptorSetLayout& layout);
         bool build(VkDescriptorSet& set);
+        bool buildOrUpdate(VkDescriptorSet& set, VkDescriptorSetLayout& layout);  // Only allocates if `set` is VK_NULL_HANDLE. Otherwise rewrites `set` in place (so it must not be in use by the gpu).
     private:
         DescriptorBuilder() { }
 
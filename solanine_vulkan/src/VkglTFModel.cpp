@@ -15,6 +15,7 @@
 #include "VkTextures.h"
 #include "VkInitializers.h"
 #include "StringHelper.h"
+#include "Debug.h"
 
 
 namespace vkglTF
@@ -1606,6 +1607,8 @@ namespace vkglTF
 		animStateMachine.loaded = true;
 	}
 
+	bool isHenemaFileCurrentVersion(const std::filesystem::path& path);
+
 	bool Model::checkGlTFCookNeeded(const std::filesystem::path& path)
 	{
 		std::filesystem::path cooked3dModelFname = "res/models_cooked/" + path.stem().string() + ".hthrobwoa";
@@ -1616,7 +1619,8 @@ namespace vkglTF
 			return true;
 
 		if (!std::filesystem::exists(cookedAnimsFname) ||
-			std::filesystem::last_write_time(cookedAnimsFname) <= std::filesystem::last_write_time(path))
+			std::filesystem::last_write_time(cookedAnimsFname) <= std::filesystem::last_write_time(path) ||
+			!isHenemaFileCurrentVersion(cookedAnimsFname))
 			return true;
 
 		return false;
@@ -1626,19 +1630,51 @@ namespace vkglTF
 		'\xAB', 'H', 'a', 'w', 's', 'o', 'o', ' ', 'E', 'x', 't', 'r', 'a', 'c', 't', 'e', 'd', ' ', 's', 'k', 'e', 'l', 'e', 't', 'a', 'l', ' ', 'a', 'N', 'i', 'm', 'a', 't', 'i', 'o', 'n', 's', ' ', 'f', 'r', 'o', 'm', ' ', 'a', ' ', 't', 'h', 'r', 'E', 'e', ' ', 'd', 'i', 'M', 'e', 'n', 's', 'i', 'o', 'n', 'A', 'l', ' ', 'g', 'l', 't', 'f', ' ', 'm', 'o', 'd', 'e', 'l', '.', '\xBB', '\r', '\n', '\x1A', '\n'
 	};
 
+	//
+	// .henema file format
+	//
+	// identifier, version, then each animation:
+	//   name, start, end, samplers, channels
+	// Each sampler:
+	//   interpolation, output encoding, key count, key times (floats), then the key outputs:
+	//   - RAW:                vec4 floats.
+	//   - QUANTIZED_VEC3:     min and max (vec3 floats), then 3 uint16 per key normalized into that range.
+	//   - QUANTIZED_ROTATION: 3 uint16 per key (smallest three). The top 15 bits are the three smallest
+	//                         components, the low bits of the 1st/2nd word are the index of the dropped
+	//                         (largest) component and the 3rd word's low bit is its sign.
+	// Linear samplers only keep the keys that interpolation can't already get to within the max error.
+	//
+	// @NOTE: the first (unversioned) .henema files had the animation count right after the identifier,
+	//        so the version has a marker in its upper bits to never be mistaken for one.
+	constexpr uint32_t HENEMA_FILE_VERSION = 0x484E0000 | 2;
+	constexpr float_t  HENEMA_MAX_VEC3_ERROR = 0.0005f;      // Units of translation/scale.
+	constexpr float_t  HENEMA_MAX_ROTATION_ERROR = 0.0005f;  // Radians.
+
+	enum class HenemaOutputEncoding : uint8_t
+	{
+		RAW = 0,
+		QUANTIZED_VEC3,
+		QUANTIZED_ROTATION,
+	};
+
 	inline void writeUintBinary(std::ofstream& file, uint32_t val)
 	{
 		file.write((char*)&val, sizeof(uint32_t));
 	}
 
-	inline void writeIntBinary(std::ofstream& file, int32_t val)
+	inline void writeUint16Binary(std::ofstream& file, uint16_t val)
 	{
-		file.write((char*)&val, sizeof(int32_t));
+		file.write((char*)&val, sizeof(uint16_t));
+	}
+
+	inline void writeUint8Binary(std::ofstream& file, uint8_t val)
+	{
+		file.write((char*)&val, sizeof(uint8_t));
 	}
 
-	inline void writeBoolBinary(std::ofstream& file, bool val)
+	inline void writeIntBinary(std::ofstream& file, int32_t val)
 	{
-		file.write((char*)&val, sizeof(bool));
+		file.write((char*)&val, sizeof(int32_t));
 	}
 
 	inline void writeFloatBinary(std::ofstream& file, float_t val)
@@ -1659,7 +1695,205 @@ namespace vkglTF
 		writeUintBinary(file, (uint32_t)str.length());
 		file.write(str.c_str(), str.length());
 	}
-	
+
+	inline float_t rotationErrorRadians(versor q0, versor q1)
+	{
+		// @NOTE: from the distance between the quaternions, since `acos()` of their dot product is way too imprecise this close to 1.
+		versor n0, n1, diff;
+		glm_quat_normalize_to(q0, n0);
+		glm_quat_normalize_to(q1, n1);
+		if (glm_vec4_dot(n0, n1) < 0.0f)
+			glm_vec4_negate(n1);
+		glm_vec4_sub(n0, n1, diff);
+		return 4.0f * std::asin(std::min(glm_vec4_norm(diff) * 0.5f, 1.0f));
+	}
+
+	// Whether the keys between `keyA` and `keyB` (and the halfway points between them) are within
+	// the max error of interpolating straight from `keyA` to `keyB`.
+	bool henemaKeySpanWithinError(const AnimationSampler& sampler, bool isRotation, size_t keyA, size_t keyB)
+	{
+		float_t spanDuration = sampler.inputs[keyB] - sampler.inputs[keyA];
+		for (size_t k = keyA + 1; k <= keyB; k++)
+		for (size_t half = 0; half < 2; half++)
+		{
+			if (k == keyB && half == 1)
+				break;  // `keyB` itself is kept.
+
+			// @NOTE: same interpolation as in `Animator::updateAnimation()`.
+			float_t prevTime = sampler.inputs[k - 1];
+			float_t time = (half == 0) ? (prevTime + sampler.inputs[k]) * 0.5f : sampler.inputs[k];
+			float_t originalU = (half == 0) ? 0.5f : 1.0f;
+			float_t u = (time - sampler.inputs[keyA]) / spanDuration;
+			vec4 original, interpolated;
+			if (isRotation)
+			{
+				glm_quat_nlerp((float_t*)sampler.outputsVec4[k - 1].raw, (float_t*)sampler.outputsVec4[k].raw, originalU, original);
+				glm_quat_nlerp((float_t*)sampler.outputsVec4[keyA].raw, (float_t*)sampler.outputsVec4[keyB].raw, u, interpolated);
+				if (glm_vec4_dot(original, interpolated) < 0.0f ||  // Keep sign flips, since twitching (adding to w) isn't the same for q and -q.
+					rotationErrorRadians(original, interpolated) > HENEMA_MAX_ROTATION_ERROR)
+					return false;
+			}
+			else
+			{
+				glm_vec4_lerp((float_t*)sampler.outputsVec4[k - 1].raw, (float_t*)sampler.outputsVec4[k].raw, originalU, original);
+				glm_vec4_lerp((float_t*)sampler.outputsVec4[keyA].raw, (float_t*)sampler.outputsVec4[keyB].raw, u, interpolated);
+				if (glm_vec3_distance(original, interpolated) > HENEMA_MAX_VEC3_ERROR)
+					return false;
+			}
+		}
+		return true;
+	}
+
+	// Keeps the first and last keys, and whichever keys in between linear interpolation can't reproduce.
+	void reduceHenemaKeys(const AnimationSampler& sampler, bool isRotation, std::vector<size_t>& outKeptKeys)
+	{
+		outKeptKeys.clear();
+		outKeptKeys.push_back(0);
+		size_t keyA = 0;
+		for (size_t keyB = 2; keyB < sampler.inputs.size(); keyB++)
+			if (sampler.inputs[keyB] <= sampler.inputs[keyA] ||
+				!henemaKeySpanWithinError(sampler, isRotation, keyA, keyB))
+			{
+				keyA = keyB - 1;
+				outKeptKeys.push_back(keyA);
+			}
+		outKeptKeys.push_back(sampler.inputs.size() - 1);
+	}
+
+	inline uint16_t quantizeUnorm16(float_t val)
+	{
+		return (uint16_t)std::round(std::clamp(val, 0.0f, 1.0f) * 65535.0f);
+	}
+
+	inline float_t dequantizeUnorm16(uint16_t val)
+	{
+		return (float_t)val / 65535.0f;
+	}
+
+	void quantizeRotation(versor q, uint16_t out[3])
+	{
+		versor qn;
+		glm_quat_normalize_to(q, qn);
+		uint16_t largestIndex = 0;
+		for (uint16_t i = 1; i < 4; i++)
+			if (std::abs(qn[i]) > std::abs(qn[largestIndex]))
+				largestIndex = i;
+
+		// The three smallest components are all in [-1/sqrt(2), 1/sqrt(2)].
+		for (uint16_t i = 0, j = 0; i < 4; i++)
+			if (i != largestIndex)
+			{
+				float_t normalized = qn[i] * GLM_SQRT2f * 0.5f + 0.5f;
+				out[j++] = (uint16_t)(std::round(std::clamp(normalized, 0.0f, 1.0f) * 32767.0f)) << 1;
+			}
+		out[0] |= (largestIndex & 1);
+		out[1] |= (largestIndex >> 1) & 1;
+		out[2] |= (qn[largestIndex] < 0.0f ? 1 : 0);  // @NOTE: the sign is kept since twitching (adding to w) isn't the same for q and -q.
+	}
+
+	void dequantizeRotation(const uint16_t in[3], vec4s& out)
+	{
+		uint16_t largestIndex = (in[0] & 1) | ((in[1] & 1) << 1);
+		float_t sumOfSquares = 0.0f;
+		for (uint16_t i = 0, j = 0; i < 4; i++)
+			if (i != largestIndex)
+			{
+				float_t normalized = (float_t)(in[j++] >> 1) / 32767.0f;
+				out.raw[i] = (normalized - 0.5f) * 2.0f / GLM_SQRT2f;
+				sumOfSquares += out.raw[i] * out.raw[i];
+			}
+		out.raw[largestIndex] = std::sqrt(std::max(0.0f, 1.0f - sumOfSquares)) * ((in[2] & 1) ? -1.0f : 1.0f);
+	}
+
+	HenemaOutputEncoding getHenemaOutputEncoding(const Animation& anim, size_t samplerIndex)
+	{
+		const AnimationSampler& sampler = anim.samplers[samplerIndex];
+		if (sampler.interpolation == AnimationSampler::InterpolationType::CUBICSPLINE ||
+			sampler.inputs.size() != sampler.outputsVec4.size())
+			return HenemaOutputEncoding::RAW;  // Tangents are packed in with the outputs.
+
+		// Encode with what the channels use the sampler for.
+		bool usedAsRotation = false;
+		bool usedAsVec3 = false;
+		for (auto& channel : anim.channels)
+			if (channel.samplerIndex == samplerIndex)
+			{
+				if (channel.path == AnimationChannel::PathType::ROTATION)
+					usedAsRotation = true;
+				else
+					usedAsVec3 = true;
+			}
+
+		if (usedAsRotation == usedAsVec3)
+			return HenemaOutputEncoding::RAW;  // Unused or used for both (can't quantize for both).
+		return usedAsRotation ? HenemaOutputEncoding::QUANTIZED_ROTATION : HenemaOutputEncoding::QUANTIZED_VEC3;
+	}
+
+	void writeHenemaSampler(std::ofstream& file, const AnimationSampler& sampler, HenemaOutputEncoding encoding)
+	{
+		writeIntBinary(file, (int32_t)sampler.interpolation);
+		writeUint8Binary(file, (uint8_t)encoding);
+
+		std::vector<size_t> keys;
+		if (sampler.interpolation == AnimationSampler::InterpolationType::LINEAR &&
+			encoding != HenemaOutputEncoding::RAW &&
+			sampler.inputs.size() > 2)
+			reduceHenemaKeys(sampler, (encoding == HenemaOutputEncoding::QUANTIZED_ROTATION), keys);
+		else
+			for (size_t i = 0; i < sampler.inputs.size(); i++)
+				keys.push_back(i);
+
+		writeUintBinary(file, (uint32_t)keys.size());
+		for (size_t key : keys)
+			writeFloatBinary(file, sampler.inputs[key]);
+
+		switch (encoding)
+		{
+			case HenemaOutputEncoding::RAW:
+			{
+				writeUintBinary(file, (uint32_t)sampler.outputsVec4.size());
+				for (auto& ov4 : sampler.outputsVec4)
+					writeVec4Binary(file, ov4);
+				break;
+			}
+
+			case HenemaOutputEncoding::QUANTIZED_VEC3:
+			{
+				vec3 min = { FLT_MAX, FLT_MAX, FLT_MAX };
+				vec3 max = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+				for (size_t key : keys)
+				{
+					glm_vec3_minv(min, (float_t*)sampler.outputsVec4[key].raw, min);
+					glm_vec3_maxv(max, (float_t*)sampler.outputsVec4[key].raw, max);
+				}
+				for (size_t i = 0; i < 3; i++)
+					writeFloatBinary(file, min[i]);
+				for (size_t i = 0; i < 3; i++)
+					writeFloatBinary(file, max[i]);
+
+				for (size_t key : keys)
+					for (size_t i = 0; i < 3; i++)
+					{
+						float_t range = max[i] - min[i];
+						writeUint16Binary(file, range > 0.0f ? quantizeUnorm16((sampler.outputsVec4[key].raw[i] - min[i]) / range) : 0);
+					}
+				break;
+			}
+
+			case HenemaOutputEncoding::QUANTIZED_ROTATION:
+			{
+				for (size_t key : keys)
+				{
+					uint16_t quantized[3];
+					quantizeRotation((float_t*)sampler.outputsVec4[key].raw, quantized);
+					for (size_t i = 0; i < 3; i++)
+						writeUint16Binary(file, quantized[i]);
+				}
+				break;
+			}
+		}
+	}
+
 	bool writeAnimationsFile(const std::filesystem::path& path, const std::vector<vkglTF::Animation>& anims)
 	{
 		if (std::filesystem::exists(path))
@@ -1670,26 +1904,19 @@ namespace vkglTF
 
 		// Write header.
 		file.write((char*)henemaFileIdentifier.data(), henemaFileIdentifier.size());
+		writeUintBinary(file, HENEMA_FILE_VERSION);
 
 		// Write data.
 		writeUintBinary(file, (uint32_t)anims.size());
 		for (auto& anim : anims)
 		{
 			writeStringBinary(file, anim.name);
+			writeFloatBinary(file, anim.start);
+			writeFloatBinary(file, anim.end);
 
 			writeUintBinary(file, (uint32_t)anim.samplers.size());
-			for (auto& sampler : anim.samplers)
-			{
-				writeIntBinary(file, (int32_t)sampler.interpolation);
-
-				writeUintBinary(file, (uint32_t)sampler.inputs.size());
-				for (auto& input : sampler.inputs)
-					writeFloatBinary(file, input);
-
-				writeUintBinary(file, (uint32_t)sampler.outputsVec4.size());
-				for (auto& ov4 : sampler.outputsVec4)
-					writeVec4Binary(file, ov4);
-			}
+			for (size_t i = 0; i < anim.samplers.size(); i++)
+				writeHenemaSampler(file, anim.samplers[i], getHenemaOutputEncoding(anim, i));
 
 			writeUintBinary(file, (uint32_t)anim.channels.size());
 			for (auto& channel : anim.channels)
@@ -1698,130 +1925,211 @@ namespace vkglTF
 				writeIntBinary(file, channel.nodeIdx);
 				writeUintBinary(file, channel.samplerIndex);
 			}
-
-			writeFloatBinary(file, anim.start);
-			writeFloatBinary(file, anim.end);
 		}
 
 		return true;
 	}
 
-	inline void loadUintBinary(std::ifstream& file, uint32_t& out)
+	// Reads out of the .henema file, which gets loaded into memory all at once.
+	struct HenemaReader
 	{
-		file.read((char*)&out, sizeof(uint32_t));
-	}
+		const char* cursor;
+		const char* end;
+		bool        failed = false;
 
-	inline void loadIntBinary(std::ifstream& file, int32_t& out)
-	{
-		file.read((char*)&out, sizeof(int32_t));
-	}
+		template<typename T>
+		void read(T& out)
+		{
+			readBytes(&out, sizeof(T));
+		}
 
-	inline void loadBoolBinary(std::ifstream& file, bool& out)
-	{
-		file.read((char*)&out, sizeof(bool));
-	}
+		void readBytes(void* out, size_t size)
+		{
+			if (failed || (size_t)(end - cursor) < size)
+			{
+				failed = true;
+				memset(out, 0, size);
+				return;
+			}
+			memcpy(out, cursor, size);
+			cursor += size;
+		}
 
-	inline void loadFloatBinary(std::ifstream& file, float_t& out)
-	{
-		file.read((char*)&out, sizeof(float_t));
-	}
+		void readString(std::string& out)
+		{
+			uint32_t strLength;
+			read(strLength);
+			if (failed || (size_t)(end - cursor) < strLength)
+			{
+				failed = true;
+				return;
+			}
+			out = std::string(cursor, strLength);
+			cursor += strLength;
+		}
+	};
 
-	inline void loadVec4Binary(std::ifstream& file, vec4s& out)
+	void readHenemaSampler(HenemaReader& reader, AnimationSampler& sampler)
 	{
-		loadFloatBinary(file, out.x);
-		loadFloatBinary(file, out.y);
-		loadFloatBinary(file, out.z);
-		loadFloatBinary(file, out.w);
-	}
+		int32_t interpolationInt;
+		uint8_t encodingInt;
+		reader.read(interpolationInt);
+		reader.read(encodingInt);
+		sampler.interpolation = vkglTF::AnimationSampler::InterpolationType(interpolationInt);
 
-	inline void loadStringBinary(std::ifstream& file, std::string& out)
-	{
-		uint32_t strLength;
-		loadUintBinary(file, strLength);
-		std::vector<char> cStr;
-		cStr.resize(strLength);
-		file.read(cStr.data(), strLength);
-		out = std::string(cStr.data(), cStr.size());
+		uint32_t numKeys;
+		reader.read(numKeys);
+		if (reader.failed || (size_t)(reader.end - reader.cursor) < numKeys * sizeof(float_t))
+		{
+			reader.failed = true;
+			return;
+		}
+		sampler.inputs.resize(numKeys);
+		reader.readBytes(sampler.inputs.data(), numKeys * sizeof(float_t));
+
+		switch (HenemaOutputEncoding(encodingInt))
+		{
+			case HenemaOutputEncoding::RAW:
+			{
+				uint32_t numOutputs;
+				reader.read(numOutputs);
+				if (reader.failed || (size_t)(reader.end - reader.cursor) < numOutputs * sizeof(vec4s))
+				{
+					reader.failed = true;
+					return;
+				}
+				sampler.outputsVec4.resize(numOutputs);
+				reader.readBytes(sampler.outputsVec4.data(), numOutputs * sizeof(vec4s));
+				break;
+			}
+
+			case HenemaOutputEncoding::QUANTIZED_VEC3:
+			{
+				vec3 min, max;
+				reader.read(min);
+				reader.read(max);
+				sampler.outputsVec4.resize(numKeys);
+				for (auto& ov4 : sampler.outputsVec4)
+				{
+					for (size_t i = 0; i < 3; i++)
+					{
+						uint16_t quantized;
+						reader.read(quantized);
+						ov4.raw[i] = min[i] + dequantizeUnorm16(quantized) * (max[i] - min[i]);
+					}
+					ov4.raw[3] = 0.0f;
+				}
+				break;
+			}
+
+			case HenemaOutputEncoding::QUANTIZED_ROTATION:
+			{
+				sampler.outputsVec4.resize(numKeys);
+				for (auto& ov4 : sampler.outputsVec4)
+				{
+					uint16_t quantized[3];
+					reader.read(quantized);
+					dequantizeRotation(quantized, ov4);
+				}
+				break;
+			}
+
+			default:
+				reader.failed = true;
+				break;
+		}
 	}
 
 	bool loadHenemaAnimationsFile(const std::filesystem::path& path, std::vector<vkglTF::Animation>& outAnims)
 	{
 		if (!std::filesystem::exists(path))
 			return false;
-        std::ifstream file(path, std::ios::binary);
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
         if (!file.is_open())
 			return false;
 
+		// Read in the whole file at once.
+		std::vector<char> data((size_t)file.tellg());
+		file.seekg(0);
+		file.read(data.data(), data.size());
+		HenemaReader reader = {
+			.cursor = data.data(),
+			.end = data.data() + data.size(),
+		};
+
 		// Check header.
 		{
 			std::vector<int8_t> identifierCheck(henemaFileIdentifier.size());
-			file.read((char*)identifierCheck.data(), henemaFileIdentifier.size());
-			bool correct = true;
-			for (size_t i = 0; i < henemaFileIdentifier.size(); i++)
-				if (identifierCheck[i] != henemaFileIdentifier[i])
-				{
-					correct = false;
-					break;
-				}
-			if (!correct)
+			reader.readBytes(identifierCheck.data(), henemaFileIdentifier.size());
+			uint32_t version;
+			reader.read(version);
+			if (reader.failed || identifierCheck != henemaFileIdentifier)
 				return false;
+			if (version != HENEMA_FILE_VERSION)
+			{
+				std::cerr << "[LOAD HENEMA FILE]" << std::endl
+					<< "ERROR: \"" << path.string() << "\" is an old version. Recook the model." << std::endl;
+				return false;
+			}
 		}
 
 		// Load data.
 		uint32_t animsSize;
-		loadUintBinary(file, animsSize);
-		outAnims.resize(animsSize);
+		reader.read(animsSize);
+		outAnims.resize(reader.failed ? 0 : animsSize);
 
 		for (auto& anim : outAnims)
 		{
-			loadStringBinary(file, anim.name);
+			reader.readString(anim.name);
+			reader.read(anim.start);
+			reader.read(anim.end);
 
 			uint32_t animSamplersSize;
-			loadUintBinary(file, animSamplersSize);
-			anim.samplers.resize(animSamplersSize);
-
+			reader.read(animSamplersSize);
+			anim.samplers.resize(reader.failed ? 0 : animSamplersSize);
 			for (auto& sampler : anim.samplers)
-			{
-				int32_t interpolationInt;
-				loadIntBinary(file, interpolationInt);
-				sampler.interpolation = vkglTF::AnimationSampler::InterpolationType(interpolationInt);
-
-				uint32_t samplerInputsSize;
-				loadUintBinary(file, samplerInputsSize);
-				sampler.inputs.resize(samplerInputsSize);
-
-				for (auto& input : sampler.inputs)
-					loadFloatBinary(file, input);
-
-				uint32_t samplerOutputsVec4Size;
-				loadUintBinary(file, samplerOutputsVec4Size);
-				sampler.outputsVec4.resize(samplerOutputsVec4Size);
-
-				for (auto& ov4 : sampler.outputsVec4)
-					loadVec4Binary(file, ov4);
-			}
+				readHenemaSampler(reader, sampler);
 
 			uint32_t animChannelsSize;
-			loadUintBinary(file, animChannelsSize);
-			anim.channels.resize(animChannelsSize);
-
+			reader.read(animChannelsSize);
+			anim.channels.resize(reader.failed ? 0 : animChannelsSize);
 			for (auto& channel : anim.channels)
 			{
 				int32_t channelPathInt;
-				loadIntBinary(file, channelPathInt);
+				reader.read(channelPathInt);
 				channel.path = vkglTF::AnimationChannel::PathType(channelPathInt);
 
-				loadIntBinary(file, channel.nodeIdx);
-				loadUintBinary(file, channel.samplerIndex);
+				reader.read(channel.nodeIdx);
+				reader.read(channel.samplerIndex);
 			}
 
-			loadFloatBinary(file, anim.start);
-			loadFloatBinary(file, anim.end);
+			if (reader.failed)
+				break;
 		}
 
+		if (reader.failed)
+		{
+			std::cerr << "[LOAD HENEMA FILE]" << std::endl
+				<< "ERROR: \"" << path.string() << "\" ended early." << std::endl;
+			outAnims.clear();
+			return false;
+		}
 		return true;
 	}
 
+	bool isHenemaFileCurrentVersion(const std::filesystem::path& path)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if (!file.is_open())
+			return false;
+
+		std::vector<int8_t> identifierCheck(henemaFileIdentifier.size());
+		uint32_t version = 0;
+		file.read((char*)identifierCheck.data(), identifierCheck.size());
+		file.read((char*)&version, sizeof(uint32_t));
+		return (file.good() && identifierCheck == henemaFileIdentifier && version == HENEMA_FILE_VERSION);
+	}
+
 	bool Model::cookGlTFModel(const std::filesystem::path& path)
 	{
 		std::filesystem::path cooked3dModelFname = "res/models_cooked/" + path.stem().string() + ".hthrobwoa";
@@ -2208,6 +2516,127 @@ namespace vkglTF
 			<< std::endl;
 	}
 
+	void Model::initRuntimeMesh(VulkanEngine* engine, const std::vector<PBRMaterial>& materials)
+	{
+		this->engine = engine;
+		this->materials = materials;
+
+		// Empty until `uploadRuntimeMesh()`, but the primitive has to exist already so that
+		// render objects registered with this model get their instance pointer.
+		Node* newNode = new Node{};
+		newNode->index = 0;
+		newNode->parent = nullptr;
+		newNode->name = "runtime_mesh";
+		glm_mat4_identity(newNode->matrix);
+		newNode->mesh = new Mesh();
+		newNode->mesh->primitives.push_back(new Primitive(0, 0, 0, 0));
+		nodes.push_back(newNode);
+		linearNodes.push_back(newNode);
+
+		indices.count = 0;
+		getSceneDimensions();
+	}
+
+	void Model::uploadRuntimeMesh(const RuntimeMeshData& meshData, std::vector<AllocatedBuffer>& outRetiredBuffers)
+	{
+		ZoneScoped;
+
+		const std::vector<Vertex>& vertices = meshData.vertices;
+		const std::vector<uint32_t>& indices = meshData.indices;
+
+		// Replace buffers. The old ones get handed back, since frames in flight could still be reading them.
+		if (this->vertices.buffer != VK_NULL_HANDLE)
+		{
+			outRetiredBuffers.push_back({ ._buffer = this->vertices.buffer, ._allocation = this->vertices.allocation });
+			this->vertices.buffer = VK_NULL_HANDLE;
+		}
+		if (this->indices.buffer != VK_NULL_HANDLE)
+		{
+			outRetiredBuffers.push_back({ ._buffer = this->indices.buffer, ._allocation = this->indices.allocation });
+			this->indices.buffer = VK_NULL_HANDLE;
+		}
+
+		// @NOTE: an empty mesh still gets a one element buffer so that binding this model is valid.
+		size_t vertexDataSize = vertices.size() * sizeof(Vertex);
+		size_t indexDataSize = indices.size() * sizeof(uint32_t);
+		size_t vertexBufferSize = std::max(vertexDataSize, sizeof(Vertex));
+		size_t indexBufferSize = std::max(indexDataSize, sizeof(uint32_t));
+		this->indices.count = static_cast<int32_t>(indices.size());
+
+		AllocatedBuffer staging =
+			engine->createBuffer(
+				vertexBufferSize + indexBufferSize,
+				VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+				VMA_MEMORY_USAGE_CPU_ONLY
+			);
+		void* data;
+		vmaMapMemory(engine->_allocator, staging._allocation, &data);
+		memset(data, 0, vertexBufferSize + indexBufferSize);
+		if (vertexDataSize > 0)
+			memcpy(data, vertices.data(), vertexDataSize);
+		if (indexDataSize > 0)
+			memcpy((char*)data + vertexBufferSize, indices.data(), indexDataSize);
+		vmaUnmapMemory(engine->_allocator, staging._allocation);
+
+		AllocatedBuffer vertexGPUSide =
+			engine->createBuffer(
+				vertexBufferSize,
+				VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+				VMA_MEMORY_USAGE_GPU_ONLY
+			);
+		this->vertices.buffer = vertexGPUSide._buffer;
+		this->vertices.allocation = vertexGPUSide._allocation;
+
+		AllocatedBuffer indexGPUSide =
+			engine->createBuffer(
+				indexBufferSize,
+				VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+				VMA_MEMORY_USAGE_GPU_ONLY
+			);
+		this->indices.buffer = indexGPUSide._buffer;
+		this->indices.allocation = indexGPUSide._allocation;
+
+		engine->immediateSubmit([&](VkCommandBuffer cmd)
+			{
+				VkBufferCopy copyRegion = {
+					.srcOffset = 0,
+					.dstOffset = 0,
+					.size = vertexBufferSize,
+				};
+				vkCmdCopyBuffer(cmd, staging._buffer, this->vertices.buffer, 1, &copyRegion);
+
+				copyRegion.srcOffset = vertexBufferSize;
+				copyRegion.size = indexBufferSize;
+				vkCmdCopyBuffer(cmd, staging._buffer, this->indices.buffer, 1, &copyRegion);
+			});
+		vmaDestroyBuffer(engine->_allocator, staging._buffer, staging._allocation);
+
+		// Update primitive and bounds.
+		vec3 posMin = GLM_VEC3_ZERO_INIT;
+		vec3 posMax = GLM_VEC3_ZERO_INIT;
+		if (!vertices.empty())
+		{
+			glm_vec3_copy((float_t*)vertices[0].pos, posMin);
+			glm_vec3_copy((float_t*)vertices[0].pos, posMax);
+			for (const Vertex& vertex : vertices)
+			{
+				glm_vec3_minv(posMin, (float_t*)vertex.pos, posMin);
+				glm_vec3_maxv(posMax, (float_t*)vertex.pos, posMax);
+			}
+		}
+
+		Mesh* mesh = nodes[0]->mesh;
+		Primitive* primitive = mesh->primitives[0];
+		primitive->firstIndex = 0;
+		primitive->indexCount = static_cast<uint32_t>(indices.size());
+		primitive->vertexCount = static_cast<uint32_t>(vertices.size());
+		primitive->hasIndices = (primitive->indexCount > 0);
+		primitive->setBoundingBox(posMin, posMax);
+		mesh->setBoundingBox(posMin, posMax);
+
+		getSceneDimensions();
+	}
+
 	void Model::bind(VkCommandBuffer commandBuffer)
 	{
 		const VkDeviceSize offsets[1] = { 0 };
@@ -2411,7 +2840,8 @@ namespace vkglTF
 	// Animator
 	//
 	VulkanEngine* Animator::engine = nullptr;
-	Animator::GPUAnimatorNode Animator::uniformBlocks[RENDER_OBJECTS_MAX_CAPACITY];
+	std::vector<Animator::GPUAnimatorNode> Animator::uniformBlocks;
+	std::shared_mutex Animator::nodeCollectionMutex;
 	Animator::AnimatorNodeCollectionBuffer Animator::nodeCollectionBuffers[FRAME_OVERLAP];
 	std::vector<size_t> Animator::reservedNodeCollectionIndices;
 
@@ -2424,31 +2854,114 @@ namespace vkglTF
 		engine               = model->engine;
 		animStateMachineCopy = StateMachine(model->animStateMachine);  // Make a copy to play with here
 
+		keyframeCursors.resize(animStateMachineCopy.masks.size());
+
+		// Start off in the model's rest pose.
+		uint32_t maxNodeIndex = 0;
+		for (auto& node : model->linearNodes)
+			maxNodeIndex = std::max(maxNodeIndex, node->index);
+		nodePoses.resize(model->linearNodes.empty() ? 0 : maxNodeIndex + 1);
+		for (auto& node : model->linearNodes)
+		{
+			NodePose& pose = nodePoses[node->index];
+			glm_vec3_copy(node->translation, pose.translation);
+			glm_vec3_copy(node->scale, pose.scale);
+			glm_quat_copy(node->rotation, pose.rotation);
+		}
+
+		// Bone depths for `updateAnimation(maxBoneDepth)`.
+		std::set<Node*> jointNodes;
+		for (auto skin : model->skins)
+			jointNodes.insert(skin->joints.begin(), skin->joints.end());
+		nodeBoneDepths.resize(nodePoses.size(), 0);
+		for (auto& node : model->linearNodes)
+			for (Node* n = node; n != nullptr; n = n->parent)
+				if (jointNodes.find(n) != jointNodes.end())
+					nodeBoneDepths[node->index]++;
+		for (uint32_t depth : nodeBoneDepths)
+			deepestBoneDepth = std::max(deepestBoneDepth, depth);
+
+		// Flatten the nodes the skins need.
+		std::vector<bool> nodeNeeded(nodePoses.size(), false);
+		for (auto skin : model->skins)
+		{
+			std::vector<Node*> skinNodes = skin->joints;
+			if (skin->skeletonRoot)
+				skinNodes.push_back(skin->skeletonRoot);
+			for (Node* node : skinNodes)
+				for (Node* n = node; n != nullptr && !nodeNeeded[n->index]; n = n->parent)
+					nodeNeeded[n->index] = true;
+		}
+
+		std::vector<int32_t> nodeFlatIndices(nodePoses.size(), -1);  // Indexed by `Node::index`.
+		for (auto& node : model->linearNodes)
+			if (node->parent == nullptr && nodeNeeded[node->index])
+			{
+				nodeFlatIndices[node->index] = (int32_t)flatNodes.size();
+				flatNodes.push_back(node);
+				flatNodeParents.push_back(-1);
+			}
+		for (size_t i = 0; i < flatNodes.size(); i++)
+			for (Node* child : flatNodes[i]->children)
+				if (nodeNeeded[child->index])
+				{
+					nodeFlatIndices[child->index] = (int32_t)flatNodes.size();
+					flatNodes.push_back(child);
+					flatNodeParents.push_back((int32_t)i);
+				}
+		flatNodeWorldMatrices.resize(flatNodes.size(), glms_mat4_identity());
+
+		for (auto skin : model->skins)
+		{
+			std::vector<uint32_t> jointFlatIndices;
+			for (Node* joint : skin->joints)
+			{
+				jointFlatIndices.push_back((uint32_t)nodeFlatIndices[joint->index]);
+				jointNameToFlatIndex[joint->name] = (uint32_t)nodeFlatIndices[joint->index];
+			}
+			skinJointFlatIndices.push_back(jointFlatIndices);
+			skinRootFlatIndices.push_back(skin->skeletonRoot ? nodeFlatIndices[skin->skeletonRoot->index] : -1);
+		}
+		updateNodeWorldMatrices();
+
 		for (auto& node : model->linearNodes)
 			if (node->mesh)
 				node->mesh->animatorSkinIndex = 0;  // Reset all mesh nodes to be assigned to the empty animator skin by default (@NOTE later mesh nodes will be assigned the correct skin, but this line is to prevent danglers).
 
-		for (auto skin : model->skins)
+		for (size_t skinIndex = 0; skinIndex < model->skins.size(); skinIndex++)
 		{
+			auto skin = model->skins[skinIndex];
 			GPUAnimatorNode newAnimatorNode = {};
-			if (skin->skeletonRoot)
-				skin->skeletonRoot->getMatrix(newAnimatorNode.matrix);
+			if (skinRootFlatIndices[skinIndex] >= 0)
+				glm_mat4_copy(flatNodeWorldMatrices[skinRootFlatIndices[skinIndex]].raw, newAnimatorNode.matrix);
 
 			// Reserve new node index
-			size_t reserveIndexCandidate = (reservedNodeCollectionIndices.back() + 1) % RENDER_OBJECTS_MAX_CAPACITY;
-			while (true)
+			std::unique_lock<std::shared_mutex> nodeCollectionLock(nodeCollectionMutex);
+			size_t reserveIndexCandidate;
+			if (reservedNodeCollectionIndices.size() >= uniformBlocks.size())
 			{
-				bool unreserved = true;
-				for (auto index : reservedNodeCollectionIndices)
-					if (reserveIndexCandidate == index)
-					{
-						unreserved = false;
-						reserveIndexCandidate = (reserveIndexCandidate + 1) % RENDER_OBJECTS_MAX_CAPACITY;
-						break;
-					}
+				// Every node is taken, so grow and use the first new one.
+				// @NOTE: the gpu buffers catch up on the render thread (see `growNodeCollectionBufferIfNeeded()`).
+				reserveIndexCandidate = uniformBlocks.size();
+				uniformBlocks.resize(uniformBlocks.size() + ANIMATOR_NODES_CHUNK_SIZE);
+			}
+			else
+			{
+				reserveIndexCandidate = (reservedNodeCollectionIndices.back() + 1) % uniformBlocks.size();
+				while (true)
+				{
+					bool unreserved = true;
+					for (auto index : reservedNodeCollectionIndices)
+						if (reserveIndexCandidate == index)
+						{
+							unreserved = false;
+							reserveIndexCandidate = (reserveIndexCandidate + 1) % uniformBlocks.size();
+							break;
+						}
 
-				if (unreserved)
-					break;  // Success! Found an empty node index
+					if (unreserved)
+						break;  // Success! Found an empty node index
+				}
 			}
 
 			reservedNodeCollectionIndices.push_back(reserveIndexCandidate);
@@ -2457,10 +2970,8 @@ namespace vkglTF
 				if (node->mesh && node->skin == skin)
 					node->mesh->animatorSkinIndex = myReservedNodeCollectionIndices.size() - 1;
 			uniformBlocks[reserveIndexCandidate] = newAnimatorNode;
-
-			for (size_t i = 0; i < FRAME_OVERLAP; i++)
-				memcpy(nodeCollectionBuffers[i].mapped + reserveIndexCandidate, &newAnimatorNode, sizeof(GPUAnimatorNode));
 		}
+		nodeCollectionDirtyBits = (uint8_t)((1 << FRAME_OVERLAP) - 1);  // Gets uploaded with `uploadDirtyNodesToGPU()`.
 
 		// Calculate Initial Pose
 		if (animStateMachineCopy.loaded)
@@ -2500,6 +3011,7 @@ namespace vkglTF
 	Animator::~Animator()
 	{
 		// Unreserve all reserved collection indices
+		std::unique_lock<std::shared_mutex> nodeCollectionLock(nodeCollectionMutex);
 		for (auto index : myReservedNodeCollectionIndices)
 		{
 			for (int32_t i = (int32_t)reservedNodeCollectionIndices.size() - 1; i >= 0; i--)
@@ -2513,31 +3025,13 @@ namespace vkglTF
 
 	void Animator::initializeEmpty(VulkanEngine* engine)  // @TODO: rename this to "initialize animator descriptor set/buffer"
 	{
-		for (size_t i = 0; i < FRAME_OVERLAP; i++)
-		{
-			nodeCollectionBuffers[i].buffer = engine->createBuffer(sizeof(GPUAnimatorNode) * RENDER_OBJECTS_MAX_CAPACITY, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
-
-			VkDescriptorBufferInfo nodeCollectionBufferInfo = {
-				.buffer = nodeCollectionBuffers[i].buffer._buffer,
-				.offset = 0,
-				.range = sizeof(GPUAnimatorNode) * RENDER_OBJECTS_MAX_CAPACITY,
-			};
+		Animator::engine = engine;
 
-			vkutil::DescriptorBuilder::begin()
-				.bindBuffer(0, &nodeCollectionBufferInfo, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
-				.build(nodeCollectionBuffers[i].descriptorSet, engine->_skeletalAnimationSetLayout);
-
-			// Copy non-skinned default animator
-			GPUAnimatorNode defaultAnimatorNode = {};
-			glm_mat4_identity(defaultAnimatorNode.matrix);
-
-			reservedNodeCollectionIndices.push_back(0);
-
-			void* mappedMem;
-			vmaMapMemory(engine->_allocator, nodeCollectionBuffers[i].buffer._allocation, &mappedMem);
-			nodeCollectionBuffers[i].mapped = (GPUAnimatorNode*)mappedMem;
-			memcpy(nodeCollectionBuffers[i].mapped, &defaultAnimatorNode, sizeof(GPUAnimatorNode));  // Insert non-skinned default animator into gpu memory.
-		}
+		// Insert non-skinned default animator (@NOTE: default `GPUAnimatorNode` is the identity).
+		reservedNodeCollectionIndices.push_back(0);
+		uniformBlocks.resize(ANIMATOR_NODES_CHUNK_SIZE);
+		for (size_t i = 0; i < FRAME_OVERLAP; i++)
+			createNodeCollectionBuffer(i, ANIMATOR_NODES_CHUNK_SIZE);
 	}
 
 	void Animator::destroyEmpty(VulkanEngine* engine)
@@ -2549,6 +3043,62 @@ namespace vkglTF
 		}
 	}
 
+	void Animator::createNodeCollectionBuffer(size_t frameIndex, size_t capacity)
+	{
+		// @NOTE: `nodeCollectionMutex` is expected to be locked (shared is enough) if any animators exist.
+		AnimatorNodeCollectionBuffer& ncb = nodeCollectionBuffers[frameIndex];
+		ncb.buffer = engine->createBuffer(sizeof(GPUAnimatorNode) * capacity, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
+
+		VkDescriptorBufferInfo nodeCollectionBufferInfo = {
+			.buffer = ncb.buffer._buffer,
+			.offset = 0,
+			.range = sizeof(GPUAnimatorNode) * capacity,
+		};
+		if (ncb.capacity == 0)
+		{
+			vkutil::DescriptorBuilder::begin()
+				.bindBuffer(0, &nodeCollectionBufferInfo, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+				.build(ncb.descriptorSet, engine->_skeletalAnimationSetLayout);
+		}
+		else
+		{
+			// Reuse the descriptor set instead of allocating a new one every time the buffer grows.
+			VkWriteDescriptorSet writeDescriptorSet = {
+				.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+				.dstSet = ncb.descriptorSet,
+				.dstBinding = 0,
+				.descriptorCount = 1,
+				.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+				.pBufferInfo = &nodeCollectionBufferInfo,
+			};
+			vkUpdateDescriptorSets(engine->_device, 1, &writeDescriptorSet, 0, nullptr);
+		}
+
+		// Copy over the already calculated nodes.
+		void* mappedMem;
+		vmaMapMemory(engine->_allocator, ncb.buffer._allocation, &mappedMem);
+		ncb.mapped = (GPUAnimatorNode*)mappedMem;
+		memcpy(ncb.mapped, uniformBlocks.data(), sizeof(GPUAnimatorNode) * std::min(capacity, uniformBlocks.size()));
+		ncb.capacity = capacity;
+	}
+
+	bool Animator::growNodeCollectionBufferIfNeeded(size_t frameIndex)
+	{
+		ZoneScoped;
+
+		std::shared_lock<std::shared_mutex> nodeCollectionLock(nodeCollectionMutex);
+		AnimatorNodeCollectionBuffer& ncb = nodeCollectionBuffers[frameIndex];
+		if (ncb.capacity >= uniformBlocks.size())
+			return false;
+
+		// @NOTE: the frame's fence was already waited on, so nothing in flight uses this frame's buffer
+		//        or descriptor set anymore. The other frames' buffers grow when it's their turn.
+		vmaUnmapMemory(engine->_allocator, ncb.buffer._allocation);
+		vmaDestroyBuffer(engine->_allocator, ncb.buffer._buffer, ncb.buffer._allocation);
+		createNodeCollectionBuffer(frameIndex, uniformBlocks.size());
+		return true;
+	}
+
 	VkDescriptorSet* Animator::getGlobalAnimatorNodeCollectionDescriptorSet(VulkanEngine* engine)
 	{
 		return &nodeCollectionBuffers[engine->_frameNumber % FRAME_OVERLAP].descriptorSet;
@@ -2580,6 +3130,12 @@ namespace vkglTF
 	}
 
 	void Animator::update(float_t deltaTime)
+	{
+		updateStateMachine(deltaTime);
+		updateAnimation();
+	}
+
+	void Animator::updateStateMachine(float_t deltaTime)
 	{
 		for (auto& mp : animStateMachineCopy.maskPlayers)
 		{
@@ -2780,9 +3336,6 @@ namespace vkglTF
 			for (auto& trigger : animStateMachineCopy.triggers)
 				trigger.activated = false;
 		}
-
-		// Process animation
-		updateAnimation();
 	}
 
 	void Animator::runEvent(const std::string& eventName)
@@ -2873,9 +3426,48 @@ namespace vkglTF
 		return speedMultiplier;
 	}
 
-	void Animator::updateAnimation()
+	// Largest index where `inputs[index] <= time`, or -1 if `time` is before the first key.
+	// @NOTE: `cursor` is the last result for the channel. Playing forward only moves a key or two each
+	//        frame so that gets walked. Loops, seeks and big jumps fall back to a binary search.
+	inline int64_t findKeyframe(const std::vector<float>& inputs, float_t time, int64_t cursor)
+	{
+		constexpr int64_t MAX_WALK_STEPS = 4;
+		int64_t numInputs = (int64_t)inputs.size();
+		if (cursor >= 0 && cursor < numInputs && inputs[cursor] <= time)
+			for (int64_t steps = 0; steps < MAX_WALK_STEPS; steps++)
+			{
+				if (cursor + 1 >= numInputs || inputs[cursor + 1] > time)
+					return cursor;
+				cursor++;
+			}
+
+		return (int64_t)(std::upper_bound(inputs.begin(), inputs.end(), time) - inputs.begin()) - 1;
+	}
+
+	// Keyframe interval `[i, i + 1]` that `time` is in, or -1 if `time` is outside of the keys. Moves `inoutCursor` along.
+	// @NOTE: if `time` lands right on a key, the later interval is the one that's used.
+	inline int64_t findKeyframeInterval(const std::vector<float>& inputs, float_t time, int64_t& inoutCursor)
+	{
+		int64_t keyframe = findKeyframe(inputs, time, inoutCursor);
+		if (keyframe < 0)
+			return -1;  // Before the first key.
+		inoutCursor = keyframe;
+
+		int64_t interval = std::min(keyframe, (int64_t)inputs.size() - 2);
+		if (time > inputs[interval + 1])
+			return -1;  // Past the last key.
+		return interval;
+	}
+
+	uint32_t Animator::getDeepestBoneDepth()
 	{
-		std::lock_guard<std::mutex> lg(model->skinNodeDSMutex); // @NOTE: since multiple animators use the same model to temporarily store the skinned channels, there needs to be some kind of guard to prevent overwriting. It feels stupid though, this solution. -Timo 2023/09/26
+		return deepestBoneDepth;
+	}
+
+	void Animator::updateAnimation(uint32_t maxBoneDepth)
+	{
+		ZoneScoped;
+		std::lock_guard<std::mutex> lg(updateAnimationMutex);  // @NOTE: only for `setState(..., forceImmediateUpdate=true)` and `getJointMatrix()` from another thread. Barely contended otherwise.
 
 		bool updated = false;
 		for (size_t i = 0; i < animStateMachineCopy.masks.size(); i++)
@@ -2887,8 +3479,13 @@ namespace vkglTF
 			if (!mask.enabled)
 				continue;
 
-			for (auto& channel : animation.channels)
+			std::vector<int64_t>& cursors = keyframeCursors[i];
+			if (cursors.size() != animation.channels.size())
+				cursors.assign(animation.channels.size(), 0);
+
+			for (size_t channelIndex = 0; channelIndex < animation.channels.size(); channelIndex++)
 			{
+				auto& channel = animation.channels[channelIndex];
 				if (!mask.boneRefList.empty())
 				{
 					// Check to make sure the channel node is applicable to the mask
@@ -2904,78 +3501,94 @@ namespace vkglTF
 						continue;
 				}
 
+				if (nodeBoneDepths[channel.node->index] > maxBoneDepth)
+					continue;
+
 				vkglTF::AnimationSampler& sampler = animation.samplers[channel.samplerIndex];
 				if (sampler.inputs.size() > sampler.outputsVec4.size())
 				{
 					// @CHECK: What is this ignoring/continuing?
 					continue;
 				}
+				if (sampler.inputs.size() < 2)
+					continue;
 
-				for (size_t i = 0, inputsSizeSub1 = sampler.inputs.size() - 1; i < inputsSizeSub1; i++)
+				int64_t interval = findKeyframeInterval(sampler.inputs, mp.time, cursors[channelIndex]);
+				if (interval < 0)
+					continue;
+				size_t i = (size_t)interval;
+
+				float_t u = std::max(0.0f, mp.time - sampler.inputs[i]) / (sampler.inputs[i + 1] - sampler.inputs[i]);
+				switch (channel.path)
 				{
-					if (mp.time >= sampler.inputs[i] && mp.time <= sampler.inputs[i + 1])
+					case vkglTF::AnimationChannel::PathType::TRANSLATION:
 					{
-						float_t u = std::max(0.0f, mp.time - sampler.inputs[i]) / (sampler.inputs[i + 1] - sampler.inputs[i]);
-						switch (channel.path)
-						{
-							case vkglTF::AnimationChannel::PathType::TRANSLATION:
-							{
-								vec4 translation;
-								glm_vec4_lerp(sampler.outputsVec4[i].raw, sampler.outputsVec4[i + 1].raw, u, translation);
-								glm_vec4_copy3(translation, channel.node->translation);
-								break;
-							}
-							case vkglTF::AnimationChannel::PathType::SCALE:
-							{
-								vec4 scale;
-								glm_vec4_lerp(sampler.outputsVec4[i].raw, sampler.outputsVec4[i + 1].raw, u, scale);
-								glm_vec4_copy3(scale, channel.node->scale);
-								break;
-							}
-							case vkglTF::AnimationChannel::PathType::ROTATION:
-							{
-								versor r0, r1;
-								glm_quat_copy(sampler.outputsVec4[i].raw, r0);
-								glm_quat_copy(sampler.outputsVec4[i + 1].raw, r1);
-								r0[3] += twitchAngle;
-								r1[3] += twitchAngle;
-								glm_quat_nlerp(r0, r1, u, channel.node->rotation);
-								break;
-							}
-						}
-						updated = true;
+						vec4 translation;
+						glm_vec4_lerp(sampler.outputsVec4[i].raw, sampler.outputsVec4[i + 1].raw, u, translation);
+						glm_vec4_copy3(translation, nodePoses[channel.node->index].translation);
+						break;
+					}
+					case vkglTF::AnimationChannel::PathType::SCALE:
+					{
+						vec4 scale;
+						glm_vec4_lerp(sampler.outputsVec4[i].raw, sampler.outputsVec4[i + 1].raw, u, scale);
+						glm_vec4_copy3(scale, nodePoses[channel.node->index].scale);
+						break;
+					}
+					case vkglTF::AnimationChannel::PathType::ROTATION:
+					{
+						versor r0, r1;
+						glm_quat_copy(sampler.outputsVec4[i].raw, r0);
+						glm_quat_copy(sampler.outputsVec4[i + 1].raw, r1);
+						r0[3] += twitchAngle;
+						r1[3] += twitchAngle;
+						glm_quat_nlerp(r0, r1, u, nodePoses[channel.node->index].rotation);
+						break;
 					}
 				}
+				updated = true;
 			}
 		}
 		if (updated)
 		{
-			// Update the joint matrices.
+			std::shared_lock<std::shared_mutex> nodeCollectionLock(nodeCollectionMutex);
+			updateNodeWorldMatrices();
 			for (size_t i = 0; i < model->skins.size(); i++)
-			{
-				auto& skin = model->skins[i];
-				mat4 m = GLM_MAT4_IDENTITY_INIT;
-				if (skin->skeletonRoot)
-					skin->skeletonRoot->getMatrix(m);
-				updateJointMatrices(skinIndexToGlobalReservedNodeIndex(i), skin, m);
-			}
+				updateJointMatrices(skinIndexToGlobalReservedNodeIndex(i), i);
+		}
+	}
 
-			// Insert in the joint matrices into list in animator.
-			for (auto& skins : model->skins)
-			{
-				for (size_t i = 0; i < skins->joints.size(); i++)
-				{
-					auto& joint = skins->joints[i];
-					mat4s jointMatrix;
-					joint->getMatrix(jointMatrix.raw);
-					jointNameToMatrix[joint->name] = jointMatrix;
-				}
-			}
+	void Animator::localNodeMatrix(Node* node, mat4& out)
+	{
+		// @NOTE: same as translate * rotate * scale, but without the matrix multiplies.
+		NodePose& pose = nodePoses[node->index];
+		glm_quat_mat4(pose.rotation, out);
+		glm_vec4_scale(out[0], pose.scale[0], out[0]);
+		glm_vec4_scale(out[1], pose.scale[1], out[1]);
+		glm_vec4_scale(out[2], pose.scale[2], out[2]);
+		glm_vec3_copy(pose.translation, out[3]);
+	}
+
+	void Animator::updateNodeWorldMatrices()
+	{
+		// @NOTE: parents are always earlier in `flatNodes` than their children, so the parent's world matrix is already done.
+		for (size_t i = 0; i < flatNodes.size(); i++)
+		{
+			mat4& world = flatNodeWorldMatrices[i].raw;
+			localNodeMatrix(flatNodes[i], world);
+			if (flatNodeParents[i] >= 0)
+				glm_mat4_mul(flatNodeWorldMatrices[flatNodeParents[i]].raw, world, world);
 		}
 	}
 
-	void Animator::updateJointMatrices(size_t globalNodeReservedIndex, vkglTF::Skin* skin, mat4& m)
+	void Animator::updateJointMatrices(size_t globalNodeReservedIndex, size_t skinIndex)
 	{
+		vkglTF::Skin* skin = model->skins[skinIndex];
+		std::vector<uint32_t>& jointFlatIndices = skinJointFlatIndices[skinIndex];
+		mat4 m = GLM_MAT4_IDENTITY_INIT;
+		if (skinRootFlatIndices[skinIndex] >= 0)
+			glm_mat4_copy(flatNodeWorldMatrices[skinRootFlatIndices[skinIndex]].raw, m);
+
 		auto& uniformBlock = uniformBlocks[globalNodeReservedIndex];
 		glm_mat4_copy(m, uniformBlock.matrix);
 
@@ -3009,10 +3622,8 @@ namespace vkglTF
 		for (size_t i = 0; i < numJoints; i++)
 		{
 #endif
-			vkglTF::Node* jointNode = skin->joints[i];
 			mat4 jointMat;
-			jointNode->getMatrix(jointMat);
-			glm_mat4_mul(jointMat, skin->inverseBindMatrices[i].raw, jointMat);
+			glm_mat4_mul(flatNodeWorldMatrices[jointFlatIndices[i]].raw, skin->inverseBindMatrices[i].raw, jointMat);
 			glm_mat4_mul(inverseTransform, jointMat, uniformBlock.jointMatrix[i]);
 #if MULTITHREADED_JOINT_MATRICES
 		});
@@ -3034,17 +3645,50 @@ namespace vkglTF
 #endif
 
 		uniformBlock.jointcount = (float)numJoints;
-		memcpy(nodeCollectionBuffers[engine->_frameNumber % FRAME_OVERLAP].mapped + globalNodeReservedIndex, &uniformBlock, sizeof(GPUAnimatorNode));
+		nodeCollectionDirtyBits = (uint8_t)((1 << FRAME_OVERLAP) - 1);
+	}
+
+	bool Animator::uploadDirtyNodesToGPU(size_t frameIndex)
+	{
+		std::lock_guard<std::mutex> lg(updateAnimationMutex);
+
+		uint8_t frameBit = (uint8_t)(1 << frameIndex);
+		if (!(nodeCollectionDirtyBits & frameBit))
+			return false;
+
+		std::shared_lock<std::shared_mutex> nodeCollectionLock(nodeCollectionMutex);
+		AnimatorNodeCollectionBuffer& ncb = nodeCollectionBuffers[frameIndex];
+		for (size_t index : myReservedNodeCollectionIndices)
+			if (index >= ncb.capacity)
+				return false;  // Reserved after this frame's buffer grew. Try again next time.
+		for (size_t index : myReservedNodeCollectionIndices)
+			memcpy(ncb.mapped + index, &uniformBlocks[index], sizeof(GPUAnimatorNode));
+		nodeCollectionDirtyBits &= ~frameBit;
+		return true;
+	}
+
+	int32_t Animator::getJointIndex(const std::string& jointName)
+	{
+		auto it = jointNameToFlatIndex.find(jointName);
+		if (it == jointNameToFlatIndex.end())
+			return -1;
+		return (int32_t)it->second;
+	}
+
+	bool Animator::getJointMatrix(int32_t jointIndex, mat4& out)
+	{
+		if (jointIndex < 0 || jointIndex >= (int32_t)flatNodeWorldMatrices.size())
+			return false;
+
+		std::lock_guard<std::mutex> lg(updateAnimationMutex);
+		glm_mat4_copy(flatNodeWorldMatrices[jointIndex].raw, out);
+		return true;
 	}
 
 	bool Animator::getJointMatrix(const std::string& jointName, mat4& out)
 	{
-		// Find the joint with this name
-		if (jointNameToMatrix.find(jointName) != jointNameToMatrix.end())
-		{
-			glm_mat4_copy(jointNameToMatrix[jointName].raw, out);
+		if (getJointMatrix(getJointIndex(jointName), out))
 			return true;
-		}
 
 		std::cerr << "[GET JOINT MATRIX]" << std::endl
 			<< "WARNING: joint matrix \"" << jointName << "\" not found. Returning identity matrix" << std::endl;
@@ -3055,4 +3699,107 @@ namespace vkglTF
 	{
 		return myReservedNodeCollectionIndices[skinIndex];
 	}
+
+#ifdef _DEVELOP
+	// What `updateAnimation()` did before keyframe cursors: check every interval, last match wins.
+	int64_t findKeyframeIntervalLinear(const std::vector<float>& inputs, float_t time)
+	{
+		int64_t interval = -1;
+		for (size_t i = 0, inputsSizeSub1 = inputs.size() - 1; i < inputsSizeSub1; i++)
+			if (time >= inputs[i] && time <= inputs[i + 1])
+				interval = (int64_t)i;
+		return interval;
+	}
+
+	void runKeyframeCursorBenchmark()
+	{
+		std::mt19937 rng(1234);
+		constexpr size_t NUM_SAMPLES = 20000;
+		static const float_t perfTimeToNS = 1000000000.0f / (float_t)SDL_GetPerformanceFrequency();
+
+		size_t numMismatches = 0;
+		for (size_t numKeys : { 30, 300, 3000 })
+		{
+			// Clip with uneven key spacing and the occasional duplicate key time.
+			std::vector<float> inputs(numKeys);
+			float_t keyTime = 0.0f;
+			for (float& input : inputs)
+			{
+				input = keyTime;
+				if (rng() % 16 != 0)
+					keyTime += std::uniform_real_distribution<float_t>(1.0f / 120.0f, 1.0f / 15.0f)(rng);
+			}
+			float_t duration = inputs.back();
+
+			// Time sequences to sample the clip with.
+			std::vector<float_t> randomTimes(NUM_SAMPLES), backwardTimes(NUM_SAMPLES), loopingTimes(NUM_SAMPLES);
+			std::uniform_real_distribution<float_t> anyTime(-0.1f * duration, 1.1f * duration);  // Some land before/after the keys.
+			for (float_t& time : randomTimes)
+				time = (rng() % 8 == 0 ? inputs[rng() % numKeys] : anyTime(rng));  // Some land right on a key.
+
+			float_t time = duration;
+			for (float_t& t : backwardTimes)
+			{
+				time -= 1.0f / 60.0f;
+				if (time < 0.0f || rng() % 64 == 0)
+					time = anyTime(rng);  // Seek.
+				t = time;
+			}
+
+			time = 0.0f;
+			for (float_t& t : loopingTimes)
+			{
+				time += 1.0f / 60.0f;
+				if (time > duration)
+					time = std::fmod(time, duration);
+				t = time;
+			}
+
+			std::pair<const char*, const std::vector<float_t>*> sequences[] = {
+				{ "random", &randomTimes },
+				{ "backward", &backwardTimes },
+				{ "looping", &loopingTimes },
+			};
+			for (auto& [sequenceName, times] : sequences)
+			{
+				std::vector<int64_t> linearIntervals(times->size()), scratchIntervals(times->size()), cursorIntervals(times->size());
+
+				uint64_t perfTime = SDL_GetPerformanceCounter();
+				for (size_t i = 0; i < times->size(); i++)
+					linearIntervals[i] = findKeyframeIntervalLinear(inputs, (*times)[i]);
+				float_t linearNS = (SDL_GetPerformanceCounter() - perfTime) * perfTimeToNS / times->size();
+
+				perfTime = SDL_GetPerformanceCounter();
+				for (size_t i = 0; i < times->size(); i++)
+				{
+					int64_t cursor = -1;  // From scratch every time.
+					scratchIntervals[i] = findKeyframeInterval(inputs, (*times)[i], cursor);
+				}
+				float_t scratchNS = (SDL_GetPerformanceCounter() - perfTime) * perfTimeToNS / times->size();
+
+				perfTime = SDL_GetPerformanceCounter();
+				int64_t cursor = 0;
+				for (size_t i = 0; i < times->size(); i++)
+					cursorIntervals[i] = findKeyframeInterval(inputs, (*times)[i], cursor);
+				float_t cursorNS = (SDL_GetPerformanceCounter() - perfTime) * perfTimeToNS / times->size();
+
+				size_t numSequenceMismatches = 0;
+				for (size_t i = 0; i < times->size(); i++)
+					if (cursorIntervals[i] != linearIntervals[i] || cursorIntervals[i] != scratchIntervals[i])
+						numSequenceMismatches++;
+				numMismatches += numSequenceMismatches;
+
+				debug::pushDebugMessage({
+					.message = std::format("Keyframes={:<5} {:<8} linear: {:8.1f}ns  scratch: {:6.1f}ns  cursor: {:6.1f}ns  ({} mismatches)", numKeys, sequenceName, linearNS, scratchNS, cursorNS, numSequenceMismatches),
+					.type = (numSequenceMismatches == 0 ? 0u : 2u),
+					.timeUntilDeletion = 15.0f,
+					});
+			}
+		}
+
+		if (numMismatches > 0)
+			std::cerr << "[KEYFRAME CURSOR BENCHMARK]" << std::endl
+				<< "ERROR: keyframe cursor picked a different interval than the linear search " << numMismatches << " times." << std::endl;
+	}
+#endif
 }
\ No newline at end of file
@@ -278,6 +278,8 @@ namespace vkglTF
 		std::map<std::string, size_t> triggerNameToIndex;  // @NOTE: at the very most, the entity owning the animator should be using this, not the internal animator code!
 	};
 
+	struct RuntimeMeshData;
+
 	struct Model
 	{
 		size_t assignedModelIdx;
@@ -381,6 +383,8 @@ namespace vkglTF
 		static bool checkGlTFCookNeeded(const std::filesystem::path& path);
 		static bool cookGlTFModel(const std::filesystem::path& path);
 		void loadHthrobwoaFromFile(VulkanEngine* engine, std::string filenameHthrobwoa, std::string filenameHenema, float_t scale = 1.0f);
+		void initRuntimeMesh(VulkanEngine* engine, const std::vector<PBRMaterial>& materials);  // Single node, single primitive (using material 0) model whose mesh gets generated at runtime.
+		void uploadRuntimeMesh(const RuntimeMeshData& meshData, std::vector<AllocatedBuffer>& outRetiredBuffers);  // @NOTE: the previous buffers get pushed into `outRetiredBuffers` for the caller to destroy once the GPU is done with them.
 		void bind(VkCommandBuffer commandBuffer);
 		void draw(VkCommandBuffer commandBuffer);
 		void draw(VkCommandBuffer commandBuffer, uint32_t& inOutInstanceID);
@@ -401,11 +405,17 @@ namespace vkglTF
 	private:
 		VulkanEngine* engine;
 		StateMachine  animStateMachine;
-		std::mutex    skinNodeDSMutex;
 
 		friend struct Animator;
 	};
 
+	// Mesh that gets generated at runtime and uploaded into a model with `Model::uploadRuntimeMesh()`.
+	struct RuntimeMeshData
+	{
+		std::vector<Model::Vertex> vertices;
+		std::vector<uint32_t>      indices;
+	};
+
 	struct Animator
 	{
 		struct AnimatorCallback
@@ -420,9 +430,14 @@ namespace vkglTF
 		static void initializeEmpty(VulkanEngine* engine);
 		static void destroyEmpty(VulkanEngine* engine);
 		static VkDescriptorSet* getGlobalAnimatorNodeCollectionDescriptorSet(VulkanEngine* engine);  // For binding to represent a non-skinned mesh
+		static bool growNodeCollectionBufferIfNeeded(size_t frameIndex);  // @NOTE: render thread only, after waiting on the frame's fence. Returns whether the buffer got recreated.
 
 		void playAnimation(size_t maskIndex, uint32_t animationIndex, bool loop, float_t time = 0.0f);  // This is for direct control of the animation index
-		void update(float_t deltaTime);
+		void update(float_t deltaTime);              // `updateStateMachine()` then `updateAnimation()`.
+		void updateStateMachine(float_t deltaTime);  // @NOTE: this runs the event callbacks, so keep it on one thread.
+		void updateAnimation(uint32_t maxBoneDepth = (uint32_t)-1);  // @NOTE: different animators can run this in parallel (even ones sharing a model). Bones deeper than `maxBoneDepth` (counted in joints from the skeleton root) keep their last pose.
+		uint32_t getDeepestBoneDepth();                              // Deepest `maxBoneDepth` that still poses every bone of this animator's skeleton.
+		bool uploadDirtyNodesToGPU(size_t frameIndex);               // Copies this animator's posed nodes into the node collection buffer of `frameIndex` if they changed since that buffer was last written. Returns whether anything was copied.
 
 		void runEvent(const std::string& eventName);  // @NOTE: this is really naive btw
 		void setState(const std::string& stateName, float_t time = 0.0f, bool forceImmediateUpdate = false);
@@ -439,11 +454,35 @@ namespace vkglTF
 		std::vector<AnimatorCallback> eventCallbacks;
 		float_t                       twitchAngle;
 		float_t                       speedMultiplier = 1.0f;
-		std::map<std::string, mat4s>  jointNameToMatrix;
 
-		void updateAnimation();
-		void updateJointMatrices(size_t globalNodeReservedIndex, vkglTF::Skin* skin, mat4& m);
+		// Each animator poses its own copy of the model's nodes, so animators don't fight over the shared model.
+		struct NodePose
+		{
+			vec3   translation;
+			vec3   scale;
+			versor rotation;
+		};
+		std::vector<NodePose> nodePoses;  // Indexed by `Node::index`.
+		std::vector<uint32_t> nodeBoneDepths;  // Indexed by `Node::index`. Number of joints from the skeleton root down to and including the node.
+		uint32_t              deepestBoneDepth = 0;
+		std::vector<std::vector<int64_t>> keyframeCursors;  // Last keyframe found for each channel of each mask's animation.
+		std::mutex            updateAnimationMutex;
+		void localNodeMatrix(Node* node, mat4& out);
+
+		// Only the nodes the skins need (joints, skeleton roots and their ancestors), sorted so that
+		// parents come before their children. That way the world matrices get posed in one pass.
+		std::vector<Node*>                        flatNodes;
+		std::vector<int32_t>                      flatNodeParents;        // Index into `flatNodes`. -1 is a root.
+		std::vector<mat4s>                        flatNodeWorldMatrices;  // Same order as `flatNodes`.
+		std::vector<std::vector<uint32_t>>        skinJointFlatIndices;   // [skin][joint]
+		std::vector<int32_t>                      skinRootFlatIndices;    // -1 if the skin has no skeleton root.
+		std::unordered_map<std::string, uint32_t> jointNameToFlatIndex;
+		void updateNodeWorldMatrices();
+
+		void updateJointMatrices(size_t globalNodeReservedIndex, size_t skinIndex);
 	public:
+		int32_t getJointIndex(const std::string& jointName);  // -1 if not found. Stays the same for the life of the animator.
+		bool getJointMatrix(int32_t jointIndex, mat4& out);
 		bool getJointMatrix(const std::string& jointName, mat4& out);
 		size_t skinIndexToGlobalReservedNodeIndex(size_t skinIndex);
 	private:
@@ -454,20 +493,28 @@ namespace vkglTF
 			mat4 jointMatrix[MAX_NUM_JOINTS]{};
 			float_t jointcount{ 0 };
 		};
-		static GPUAnimatorNode uniformBlocks[];
+		static std::vector<GPUAnimatorNode> uniformBlocks;
 
 		struct AnimatorNodeCollectionBuffer
 		{
 			AllocatedBuffer buffer;
 			VkDescriptorSet descriptorSet;
 			GPUAnimatorNode* mapped;
+			size_t capacity = 0;
 		};
-		static AnimatorNodeCollectionBuffer nodeCollectionBuffers[FRAME_OVERLAP];  // @NOTE: The buffer size created in this is 78mb per AnimatorNodeCollectionBuffer... pretty big. Especially since very few render objects are animator attached ones.
+		static AnimatorNodeCollectionBuffer nodeCollectionBuffers[FRAME_OVERLAP];  // @NOTE: these start at `ANIMATOR_NODES_CHUNK_SIZE` nodes and grow in chunks, since very few render objects are animator attached ones.
 		static std::vector<size_t> reservedNodeCollectionIndices;
+		static std::shared_mutex   nodeCollectionMutex;  // Exclusive for growing `uniformBlocks` and (un)reserving nodes. Shared for writing/reading an animator's own nodes.
+		static void createNodeCollectionBuffer(size_t frameIndex, size_t capacity);
 
 		std::vector<size_t> myReservedNodeCollectionIndices;
+		uint8_t             nodeCollectionDirtyBits = 0;  // Bit per frame in flight whose node collection buffer is out of date.
 
 	public:
 		friend struct Node;
 	};
+
+#ifdef _DEVELOP
+	void runKeyframeCursorBenchmark();  // Checks keyframe cursor sampling against the old linear search and times both, over random, backward seeking and looping times.
+#endif
 }
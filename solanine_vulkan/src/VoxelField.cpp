@@ -19,9 +19,8 @@ struct VoxelField_XData
 {
     VulkanEngine* engine;
     RenderObjectManager* rom;
-    vkglTF::Model* voxelModel;
-    std::vector<RenderObject*> voxelRenderObjs;
-    std::vector<mat4s> voxelRenderObjLocalTransforms;
+    vkglTF::Model* voxelModel;  // Runtime generated mesh of the whole voxel field.
+    RenderObjectHandle voxelRenderObj = nullptr;
 
     int32_t disableSimFollowTimer = 0;
 
@@ -39,14 +38,14 @@ struct VoxelField_XData
         ivec3 flatAxis = { 0, 0, 0 };
         ivec3 editStartPosition = { 0, 0, 0 };
         ivec3 editEndPosition = { 0, 0, 0 };
-        std::mutex* editingVoxelRenderObjsMutex;  // Making this not a pointer deletes the struct's default constructor for some reason. I guess mutexes don't want to be double-referenced.
     } editorState;
     bool isLightingDirty = true;  // True unless built lighting was loaded in automatically.
 };
 
-inline void buildDefaultVoxelData(VoxelField_XData& data, const std::string& myGuid);
-inline void assembleVoxelRenderObjects(VoxelField_XData& data, const std::string& attachedEntityGuid, std::vector<physengine::VoxelFieldCollisionShape>& inCollisionShapes);
-inline void deleteVoxelRenderObjects(VoxelField_XData& data);
+inline void buildDefaultVoxelData(VoxelField_XData& data, Entity* myEntity);
+inline void remeshVoxelField(VoxelField_XData& data);
+inline void createVoxelRenderObject(VoxelField_XData& data, const std::string& attachedEntityGuid);
+inline void deleteVoxelRenderObject(VoxelField_XData& data);
 void triggerLoadLightingIfExists(VoxelField_XData& d, const std::string& guid);
 
 
@@ -56,7 +55,6 @@ VoxelField::VoxelField(VulkanEngine* engine, EntityManager* em, RenderObjectMana
 
     _data->engine = engine;
     _data->rom = rom;
-    _data->editorState.editingVoxelRenderObjsMutex = new std::mutex;
 
     if (ds)
         load(*ds);
@@ -65,19 +63,21 @@ VoxelField::VoxelField(VulkanEngine* engine, EntityManager* em, RenderObjectMana
     // Initialization
     //
     if (_data->vfpd == nullptr)
-        buildDefaultVoxelData(*_data, getGUID());
+        buildDefaultVoxelData(*_data, this);
 
-    _data->voxelModel = _data->rom->getModel("DevCollisionBox", this, [](){});
+    vkglTF::Model* materialModel = _data->rom->getModel("DevCollisionBox", this, [](){});  // @NOTE: just for borrowing the materials.
+    _data->voxelModel = _data->rom->createRuntimeModel(engine, "vf_" + getGUID(), materialModel->materials);
     std::vector<physengine::VoxelFieldCollisionShape> shapes;
-    physengine::cookVoxelDataIntoShape(*_data->vfpd, getGUID(), shapes);
-    assembleVoxelRenderObjects(*_data, getGUID(), shapes);
+    physengine::cookVoxelDataIntoShape(*_data->vfpd, shapes);
+    remeshVoxelField(*_data);
+    createVoxelRenderObject(*_data, getGUID());
     triggerLoadLightingIfExists(*_data, getGUID());
 }
 
 VoxelField::~VoxelField()
 {
-    delete _data->editorState.editingVoxelRenderObjsMutex;
-    deleteVoxelRenderObjects(*_data);
+    deleteVoxelRenderObject(*_data);
+    _data->rom->destroyRuntimeModel("vf_" + getGUID());
     physengine::destroyVoxelField(_data->vfpd);
     delete _data;
 }
@@ -146,9 +146,9 @@ void triggerLoadLightingIfExists(VoxelField_XData& d, const std::string& guid)
         d.engine->_voxelFieldLightingGridTextureSet.textures.push_back(lightgridTexture);
         d.engine->_voxelFieldLightingGridTextureSet.transforms.resize(d.engine->_voxelFieldLightingGridTextureSet.textures.size());
 
-        for (auto& ro : d.voxelRenderObjs)
-            for (auto& inst : ro->calculatedModelInstances)
-                inst.voxelFieldLightingGridID = d.lightgridId;
+        for (auto& inst : d.voxelRenderObj->calculatedModelInstances)
+            inst.voxelFieldLightingGridID = d.lightgridId;
+        d.rom->flagInstanceDataChanged();
     }
     else
         d.engine->_voxelFieldLightingGridTextureSet.textures[d.lightgridId] = lightgridTexture;
@@ -396,8 +396,7 @@ void VoxelField::simulationUpdate(float_t simDeltaTime)
     if (_data->disableSimFollowTimer >= 0)
     {
         if (_data->disableSimFollowTimer == 0)
-            for (auto& ro : _data->voxelRenderObjs)
-                ro->simTransformEnabled = true;
+            _data->voxelRenderObj->simTransformEnabled = true;
         _data->disableSimFollowTimer--;
     }
 
@@ -559,8 +558,8 @@ void VoxelField::simulationUpdate(float_t simDeltaTime)
                 if (rebuildRenderObjs)
                 {
                     std::vector<physengine::VoxelFieldCollisionShape> shapes;
-                    physengine::cookVoxelDataIntoShape(*_data->vfpd, getGUID(), shapes);
-                    assembleVoxelRenderObjects(*_data, getGUID(), shapes);
+                    physengine::cookVoxelDataIntoShape(*_data->vfpd, shapes);
+                    remeshVoxelField(*_data);
                     _data->isLightingDirty = true;
                 }
             }
@@ -633,10 +632,12 @@ void VoxelField::dump(DataSerializer& ds)
         int8_t count;
         int8_t voxelType;
     } chunk;
+    std::vector<uint8_t> voxelData;
+    physengine::getVoxelDataDense(*_data->vfpd, voxelData);
     std::string voxelDataStringified;
     for (size_t i = 0; i < totalSize; i++)
     {
-        int8_t currentVoxelType = (int8_t)_data->vfpd->voxelData[i];
+        int8_t currentVoxelType = (int8_t)voxelData[i];
         if (i == 0)
         {
             // Start new chunk.
@@ -704,7 +705,7 @@ void VoxelField::load(DataSerialized& ds)
     }
 
     // Create Voxel Field Physics Data
-    _data->vfpd = physengine::createVoxelField(getGUID(), load_transform, load_size[0], load_size[1], load_size[2], load_voxelData);
+    _data->vfpd = physengine::createVoxelField(this, load_transform, load_size[0], load_size[1], load_size[2], load_voxelData, physengine::Layers::NON_MOVING);  // @NOTE: owners that move the field (i.e. gondolas) switch the layer with `setCollisionLayer()`.
 }
 
 void VoxelField::teleportToPosition(vec3 position)
@@ -720,15 +721,8 @@ void VoxelField::teleportToPosition(vec3 position)
 
 void VoxelField::reportMoved(mat4* matrixMoved)
 {
-    // Search for which block was moved.
-    size_t i = 0;
-    for (; i < _data->voxelRenderObjs.size(); i++)
-        if (matrixMoved == &_data->voxelRenderObjs[i]->transformMatrix)
-            break;
-    
-    mat4 inverseLocalTransform;
-    glm_mat4_inv(_data->voxelRenderObjLocalTransforms[i].raw, inverseLocalTransform);
-    glm_mat4_mul(*matrixMoved, inverseLocalTransform, _data->vfpd->transform);
+    // The voxel field mesh is in the field's local space, so it moved exactly like the field.
+    glm_mat4_copy(*matrixMoved, _data->vfpd->transform);
 
     vec4 pos;
     mat4 rot;
@@ -751,18 +745,8 @@ void VoxelField::reportMoved(mat4* matrixMoved)
     //        the `current` and `previous` transform slots, thus causing any interpolated value to just equal
     //        the value that was put into the physics engine with `physengine::setVoxelFieldBodyTransform()`.
     //          -Timo 2023/12/27
-    for (auto& ro : _data->voxelRenderObjs)
-        ro->simTransformEnabled = false;
+    _data->voxelRenderObj->simTransformEnabled = false;
     _data->disableSimFollowTimer = 2;
-
-    // Update block render object positions.
-    {
-        std::lock_guard<std::mutex> lg(*_data->editorState.editingVoxelRenderObjsMutex);
-
-        for (size_t j = 0; j < _data->voxelRenderObjs.size(); j++)
-            if (i != j)  // Skip the render obj that has already been moved.
-                glm_mat4_mul(_data->vfpd->transform, _data->voxelRenderObjLocalTransforms[j].raw, _data->voxelRenderObjs[j]->transformMatrix);
-    }
 }
 
 bool isOutsideLightGrid(physengine::VoxelFieldPhysicsData* vfpd, ivec3 position)
@@ -1254,7 +1238,7 @@ void VoxelField::renderImGui()
     _data->isPicked = true;
 }
 
-inline void buildDefaultVoxelData(VoxelField_XData& data, const std::string& myGuid)
+inline void buildDefaultVoxelData(VoxelField_XData& data, Entity* myEntity)
 {
     size_t sizeX = 8, sizeY = 1, sizeZ = 8;
     uint8_t* vd = new uint8_t[sizeX * sizeY * sizeZ];
@@ -1263,57 +1247,288 @@ inline void buildDefaultVoxelData(VoxelField_XData& data, const std::string& myG
     for (size_t k = 0; k < sizeZ; k++)
         vd[i * sizeY * sizeZ + j * sizeZ + k] = 1;
     mat4 identity = GLM_MAT4_IDENTITY_INIT;
-    data.vfpd = physengine::createVoxelField(myGuid, identity, sizeX, sizeY, sizeZ, vd);
+    data.vfpd = physengine::createVoxelField(myEntity, identity, sizeX, sizeY, sizeZ, vd, physengine::Layers::NON_MOVING);
 }
 
-inline void assembleVoxelRenderObjects(VoxelField_XData& data, const std::string& attachedEntityGuid, std::vector<physengine::VoxelFieldCollisionShape>& inCollisionShapes)
+inline bool isVoxelFaceHiddenByNeighbor(uint8_t neighborVoxel, int32_t axis, int32_t sign)
 {
-    std::lock_guard<std::mutex> lg(*data.editorState.editingVoxelRenderObjsMutex);
+    // @NOTE: only faces that are guaranteed to be covered get culled. The sloped spaces only have
+    //        a guaranteed full face on their bottom side, so a face pointing up into one is hidden.
+    if (neighborVoxel == 1)
+        return true;
+    if (neighborVoxel >= 2)
+        return (axis == 1 && sign > 0);
+    return false;
+}
 
-    deleteVoxelRenderObjects(data);
+void appendVoxelMeshFace(vkglTF::RuntimeMeshData& outMesh, vec3* points, size_t numPoints, vec3 outwardDirection)
+{
+    // Orient the face so that it's counter-clockwise from the outside.
+    vec3 edge1, edge2, normal;
+    glm_vec3_sub(points[1], points[0], edge1);
+    glm_vec3_sub(points[2], points[0], edge2);
+    glm_vec3_cross(edge1, edge2, normal);
+    bool flip = (glm_vec3_dot(normal, outwardDirection) < 0.0f);
+    if (flip)
+        glm_vec3_negate(normal);
+    glm_vec3_normalize(normal);
+
+    // Project uvs along the most dominant axis so that textures tile with the voxel grid.
+    vec3 normalAbs;
+    glm_vec3_abs(normal, normalAbs);
+    int32_t dominantAxis = 0;
+    if (normalAbs[1] > normalAbs[dominantAxis]) dominantAxis = 1;
+    if (normalAbs[2] > normalAbs[dominantAxis]) dominantAxis = 2;
+    int32_t uAxis = (dominantAxis + 1) % 3;
+    int32_t vAxis = (dominantAxis + 2) % 3;
+
+    uint32_t firstVertex = (uint32_t)outMesh.vertices.size();
+    for (size_t i = 0; i < numPoints; i++)
+    {
+        vkglTF::Model::Vertex vert = {};
+        glm_vec3_copy(points[i], vert.pos);
+        vert.instanceIDOffset = 0;
+        glm_vec3_copy(normal, vert.normal);
+        vert.uv0[0] = points[i][uAxis];
+        vert.uv0[1] = points[i][vAxis];
+        glm_vec2_copy(vert.uv0, vert.uv1);
+        glm_vec4_one(vert.color);
+        outMesh.vertices.push_back(vert);
+    }
 
-    // Iterate thru each shape, adding it.
-    std::vector<RenderObject> inROs;
-    std::vector<RenderObject**> outRORefs;
-    for (auto& shape : inCollisionShapes)
+    for (uint32_t i = 1; i + 1 < (uint32_t)numPoints; i++)  // Triangle fan.
     {
-        RenderObject newRO = {
-            .model = data.voxelModel,
-            .simTransformId = data.vfpd->simTransformId,
-            .renderLayer = RenderLayer::BUILDER,
-            .attachedEntityGuid = attachedEntityGuid,
+        outMesh.indices.push_back(firstVertex);
+        outMesh.indices.push_back(firstVertex + (flip ? i + 1 : i));
+        outMesh.indices.push_back(firstVertex + (flip ? i : i + 1));
+    }
+}
+
+void meshVoxelFieldFilledSpaces(const physengine::VoxelFieldPhysicsData& vfpd, vkglTF::RuntimeMeshData& outMesh)
+{
+    // Greedy quad meshing, one slice at a time for each of the 6 face directions.
+    int32_t size[3] = { (int32_t)vfpd.sizeX, (int32_t)vfpd.sizeY, (int32_t)vfpd.sizeZ };
+    std::vector<bool> mask;
+    for (int32_t axis = 0; axis < 3; axis++)
+    for (int32_t sign = -1; sign <= 1; sign += 2)
+    {
+        int32_t uAxis = (axis + 1) % 3;
+        int32_t vAxis = (axis + 2) % 3;
+        int32_t sizeU = size[uAxis];
+        int32_t sizeV = size[vAxis];
+        mask.resize((size_t)sizeU * sizeV);
+
+        for (int32_t d = 0; d < size[axis]; d++)
+        {
+            // Find visible faces in this slice.
+            for (int32_t v = 0; v < sizeV; v++)
+            for (int32_t u = 0; u < sizeU; u++)
+            {
+                int32_t pos[3];
+                pos[axis] = d;
+                pos[uAxis] = u;
+                pos[vAxis] = v;
+                bool visible = false;
+                if (physengine::getVoxelDataAtPosition(vfpd, pos[0], pos[1], pos[2]) == 1)
+                {
+                    pos[axis] += sign;
+                    visible = !isVoxelFaceHiddenByNeighbor(physengine::getVoxelDataAtPosition(vfpd, pos[0], pos[1], pos[2]), axis, sign);
+                }
+                mask[(size_t)v * sizeU + u] = visible;
+            }
+
+            // Merge visible faces into quads.
+            for (int32_t v = 0; v < sizeV; v++)
+            for (int32_t u = 0; u < sizeU; )
+            {
+                if (!mask[(size_t)v * sizeU + u])
+                {
+                    u++;
+                    continue;
+                }
+
+                int32_t width = 1;
+                while (u + width < sizeU && mask[(size_t)v * sizeU + u + width])
+                    width++;
+
+                int32_t height = 1;
+                for (; v + height < sizeV; height++)
+                {
+                    bool rowViable = true;
+                    for (int32_t w = 0; w < width && rowViable; w++)
+                        rowViable = mask[(size_t)(v + height) * sizeU + u + w];
+                    if (!rowViable)
+                        break;
+                }
+
+                for (int32_t h = 0; h < height; h++)
+                for (int32_t w = 0; w < width; w++)
+                    mask[(size_t)(v + h) * sizeU + u + w] = false;
+
+                vec3 points[4];
+                float_t plane = (float_t)(sign > 0 ? d + 1 : d);
+                int32_t cornerUs[4] = { u, u + width, u + width, u };
+                int32_t cornerVs[4] = { v, v, v + height, v + height };
+                for (size_t i = 0; i < 4; i++)
+                {
+                    points[i][axis] = plane;
+                    points[i][uAxis] = (float_t)cornerUs[i];
+                    points[i][vAxis] = (float_t)cornerVs[i];
+                }
+                vec3 outward = GLM_VEC3_ZERO_INIT;
+                outward[axis] = (float_t)sign;
+                appendVoxelMeshFace(outMesh, points, 4, outward);
+
+                u += width;
+            }
+        }
+    }
+}
+
+void meshVoxelFieldSlopeSpaces(const physengine::VoxelFieldPhysicsData& vfpd, vkglTF::RuntimeMeshData& outMesh)
+{
+    // @NOTE: the slopes get grouped into runs exactly like in `physengine::cookVoxelDataIntoShape()`,
+    //        so that the ramps line up with the collision.
+    size_t totalSize = vfpd.sizeX * vfpd.sizeY * vfpd.sizeZ;
+    std::vector<bool> processed(totalSize, false);
+    auto toIndex = [&](size_t x, size_t y, size_t z) {
+        return x * vfpd.sizeY * vfpd.sizeZ + y * vfpd.sizeZ + z;
+    };
+
+    for (size_t i = 0; i < vfpd.sizeX; i++)
+    for (size_t j = 0; j < vfpd.sizeY; j++)
+    for (size_t k = 0; k < vfpd.sizeZ; k++)
+    {
+        uint8_t myType = physengine::getVoxelDataAtPosition(vfpd, (int32_t)i, (int32_t)j, (int32_t)k);
+        if (myType < 2 || myType > 5 || processed[toIndex(i, j, k)])
+            continue;
+
+        bool even = (myType == 2 || myType == 4);
+
+        // Get length (uphill axis) and width (neighboring runs with the same start and length) dimensions.
+        size_t length = physengine::getVoxelSlopeRunLength(vfpd, (int32_t)i, (int32_t)j, (int32_t)k);
+        size_t width = 1;
+        if (length == 0)
+            continue;  // Part of a run that started earlier.
+        for (size_t w = (even ? i : k) + 1; w < (even ? vfpd.sizeX : vfpd.sizeZ); w++)
+        {
+            size_t x = (even ? w : i);
+            size_t z = (even ? k : w);
+            if (physengine::getVoxelDataAtPosition(vfpd, (int32_t)x, (int32_t)j, (int32_t)z) != myType ||
+                processed[toIndex(x, j, z)] ||
+                physengine::getVoxelSlopeRunLength(vfpd, (int32_t)x, (int32_t)j, (int32_t)z) != length)
+                break;
+            width++;
+        }
+
+        for (size_t w = 0; w < width; w++)
+            processed[even ? toIndex(i + w, j, k) : toIndex(i, j, k + w)] = true;
+
+        // Build the ramp in (length, width, height) space, where length goes uphill.
+        float_t L = (float_t)length;
+        float_t W = (float_t)width;
+        auto toFieldSpace = [&](float_t l, float_t w, float_t h, vec3& out) {
+            out[1] = (float_t)j + h;
+            if (myType == 2)      { out[0] = (float_t)i + w;     out[2] = (float_t)k + l; }
+            else if (myType == 3) { out[0] = (float_t)i + l;     out[2] = (float_t)k + w; }
+            else if (myType == 4) { out[0] = (float_t)i + w;     out[2] = (float_t)k + L - l; }
+            else                  { out[0] = (float_t)i + L - l; out[2] = (float_t)k + w; }
+        };
+        auto isNeighborFilled = [&](int32_t l, int32_t w, int32_t h) {
+            vec3 p;
+            toFieldSpace((float_t)l + 0.5f, (float_t)w + 0.5f, (float_t)h + 0.5f, p);
+            return physengine::getVoxelDataAtPosition(vfpd, (int32_t)floor(p[0]), (int32_t)floor(p[1]), (int32_t)floor(p[2])) == 1;
+        };
+        auto appendRampFace = [&](std::initializer_list<vec3s> lwhPoints, vec3s lwhOutward) {
+            vec3 points[4];
+            size_t numPoints = 0;
+            for (const vec3s& lwh : lwhPoints)
+                toFieldSpace(lwh.raw[0], lwh.raw[1], lwh.raw[2], points[numPoints++]);
+
+            vec3 origin, outward;
+            toFieldSpace(0.0f, 0.0f, 0.0f, origin);
+            toFieldSpace(lwhOutward.raw[0], lwhOutward.raw[1], lwhOutward.raw[2], outward);
+            glm_vec3_sub(outward, origin, outward);
+            appendVoxelMeshFace(outMesh, points, numPoints, outward);
         };
 
-        mat4s localTransform;
-        glm_mat4_identity(localTransform.raw);
-        glm_translate(localTransform.raw, shape.origin);
-        glm_quat_rotate(localTransform.raw, shape.rotation, localTransform.raw);
-        vec3 extent2;
-        glm_vec3_scale(shape.extent, 2.0f, extent2);
-        glm_scale(localTransform.raw, extent2);
-        data.voxelRenderObjLocalTransforms.push_back(localTransform);
-
-        glm_mat4_copy(localTransform.raw, newRO.simTransformOffset);
-        inROs.push_back(newRO);
+        // Sloped top.
+        appendRampFace({ { 0, 0, 0 }, { L, 0, 1 }, { L, W, 1 }, { 0, W, 0 } }, { -1, 0, L });
+
+        // Bottom.
+        bool bottomHidden = true;
+        for (int32_t l = 0; l < (int32_t)length && bottomHidden; l++)
+        for (int32_t w = 0; w < (int32_t)width && bottomHidden; w++)
+            bottomHidden = isNeighborFilled(l, w, -1);
+        if (!bottomHidden)
+            appendRampFace({ { 0, 0, 0 }, { L, 0, 0 }, { L, W, 0 }, { 0, W, 0 } }, { 0, 0, -1 });
+
+        // Uphill wall.
+        bool wallHidden = true;
+        for (int32_t w = 0; w < (int32_t)width && wallHidden; w++)
+            wallHidden = isNeighborFilled((int32_t)length, w, 0);
+        if (!wallHidden)
+            appendRampFace({ { L, 0, 0 }, { L, W, 0 }, { L, W, 1 }, { L, 0, 1 } }, { 1, 0, 0 });
+
+        // Triangle sides.
+        bool side0Hidden = true;
+        bool side1Hidden = true;
+        for (int32_t l = 0; l < (int32_t)length; l++)
+        {
+            side0Hidden &= isNeighborFilled(l, -1, 0);
+            side1Hidden &= isNeighborFilled(l, (int32_t)width, 0);
+        }
+        if (!side0Hidden)
+            appendRampFace({ { 0, 0, 0 }, { L, 0, 0 }, { L, 0, 1 } }, { 0, -1, 0 });
+        if (!side1Hidden)
+            appendRampFace({ { 0, W, 0 }, { L, W, 0 }, { L, W, 1 } }, { 0, 1, 0 });
     }
+}
+
+void meshVoxelField(const physengine::VoxelFieldPhysicsData& vfpd, vkglTF::RuntimeMeshData& outMesh)
+{
+    ZoneScoped;
+
+    outMesh.vertices.clear();
+    outMesh.indices.clear();
+    meshVoxelFieldFilledSpaces(vfpd, outMesh);
+    meshVoxelFieldSlopeSpaces(vfpd, outMesh);
+}
 
-    data.voxelRenderObjs.resize(inROs.size(), nullptr);
-    for (size_t i = 0; i < data.voxelRenderObjs.size(); i++)
-        outRORefs.push_back(&data.voxelRenderObjs[i]);
+inline void remeshVoxelField(VoxelField_XData& data)
+{
+    // @NOTE: this only builds the mesh. The upload happens on the render thread at the start of the next frame.
+    vkglTF::RuntimeMeshData meshData;
+    meshVoxelField(*data.vfpd, meshData);
+    data.rom->requestRuntimeModelMesh(data.voxelModel, std::move(meshData));
+}
+
+inline void createVoxelRenderObject(VoxelField_XData& data, const std::string& attachedEntityGuid)
+{
+    // One render object for the whole field (the mesh is in the field's local space, so no offset needed).
+    std::vector<RenderObject> inROs = {
+        {
+            .model = data.voxelModel,
+            .simTransformId = data.vfpd->simTransformId,
+            .renderLayer = RenderLayer::BUILDER,
+            .attachedEntityGuid = attachedEntityGuid,
+        },
+    };
+    std::vector<RenderObjectHandle*> outRORefs = { &data.voxelRenderObj };
     data.rom->registerRenderObjects(inROs, outRORefs);
 
     // Assign the correct light grid id.
-    for (RenderObject** ro : outRORefs)
-        for (auto& inst : (*ro)->calculatedModelInstances)
-            inst.voxelFieldLightingGridID = data.lightgridId;
+    for (auto& inst : data.voxelRenderObj->calculatedModelInstances)
+        inst.voxelFieldLightingGridID = data.lightgridId;
+    data.rom->flagInstanceDataChanged();
 }
 
-inline void deleteVoxelRenderObjects(VoxelField_XData& data)
+inline void deleteVoxelRenderObject(VoxelField_XData& data)
 {
-    // Clear all.
-    data.rom->unregisterRenderObjects(data.voxelRenderObjs);
-    data.voxelRenderObjs.clear();
-    data.voxelRenderObjLocalTransforms.clear();
+    if (data.voxelRenderObj == nullptr)
+        return;
+    data.rom->unregisterRenderObjects({ data.voxelRenderObj });
+    data.voxelRenderObj = nullptr;
 }
 
 void VoxelField::setBodyKinematic(bool isKinematic)
@@ -1321,6 +1536,11 @@ void VoxelField::setBodyKinematic(bool isKinematic)
     physengine::setVoxelFieldBodyKinematic(*_data->vfpd, isKinematic);
 }
 
+void VoxelField::setCollisionLayer(JPH::ObjectLayer objectLayer)
+{
+    physengine::setVoxelFieldObjectLayer(*_data->vfpd, objectLayer);
+}
+
 void VoxelField::moveBody(vec3 newPosition, versor newRotation, bool immediate, float_t physicsDeltaTime)
 {
     if (immediate)
@@ -28,6 +28,7 @@ public:
     void renderImGui();
 
     void setBodyKinematic(bool isKinematic);
+    void setCollisionLayer(JPH::ObjectLayer objectLayer);
     void moveBody(vec3 newPosition, versor newRotation, bool immediate, float_t physicsDeltaTime);
     void getSize(vec3& outSize);
     void getTransform(mat4& outTransform);
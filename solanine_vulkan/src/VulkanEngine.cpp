@@ -24,6 +24,7 @@
 #include "HotswapResources.h"
 #include "GlobalState.h"
 #include "GondolaSystem.h"
+#include "OcclusionCulling.h"
 
 #ifdef _DEVELOP
 #include "EDITORTextureViewer.h"
@@ -88,6 +89,7 @@ void VulkanEngine::init()
 	initUIRenderpass();
 	initPostprocessRenderpass();
 	initPostprocessImages();
+	initDepthPyramid();
 	initPickingRenderpass();
 	initFramebuffers();
 	initSyncStructures();
@@ -207,7 +209,7 @@ void VulkanEngine::run()
 		// Update render objects.
 		physengine::recalcInterpolatedTransformsSet();
 		_roManager->updateSimTransforms();
-		_roManager->updateAnimators(scaledDeltaTime);
+		_roManager->updateAnimators(scaledDeltaTime, _camera->sceneCamera.gpuCameraData, _frameNumber);
 
 		// Update camera
 		_camera->update(deltaTime);
@@ -216,7 +218,9 @@ void VulkanEngine::run()
 		scene::tick();
 
 		// Add/Remove requested entities
+		physengine::beginBodyBatch();
 		_entityManager->INTERNALaddRemoveRequestedEntities();
+		physengine::endBodyBatch();
 
 		// Add/Change/Remove text meshes
 		// textmesh::INTERNALprocessChangeQueue();
@@ -323,77 +327,104 @@ void normalizePlane(vec4 a, vec4 w, vec4& outNormalizedPlane)
 
 static bool doCullingStuff = true;
 
-void VulkanEngine::computeShadowCulling(const FrameData& currentFrame, VkCommandBuffer cmd)
+void VulkanEngine::computeGPUSceneScatter(const FrameData& currentFrame, VkCommandBuffer cmd)
 {
 	ZoneScoped;
-	TracyVkZone(currentFrame.mainCommandBufferTracyVk, cmd, "Compute shadow culling");
+	TracyVkZone(currentFrame.mainCommandBufferTracyVk, cmd, "Compute gpu scene scatter");
 
-	// Set up frustum culling params.
-	mat4 reverseOrtho;
-	glm_ortho(
-		_camera->sceneCamera.wholeShadowMinExtents[0],
-		_camera->sceneCamera.wholeShadowMaxExtents[0],
-		_camera->sceneCamera.wholeShadowMinExtents[1],
-		_camera->sceneCamera.wholeShadowMaxExtents[1],
-		_camera->sceneCamera.wholeShadowMaxExtents[2],  // @NOTE: Znear and zfar are switched... though it doesn't really matter for anything with ortho projection.
-		_camera->sceneCamera.wholeShadowMinExtents[2],
-		reverseOrtho
+	if (currentFrame.numGPUSceneDeltas == 0)
+		return;
+
+	// Wait for the previous frames to be done reading the gpu scene before patching it.
+	// @NOTE: the gpu scene isn't double buffered, but submission order on the queue keeps this safe.
+	vkCmdPipelineBarrier(
+		cmd,
+		VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+		VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+		0, 0, nullptr, 0, nullptr, 0, nullptr
 	);
-	mat4 reverseOrthoTransposed;
-	glm_mat4_transpose_to(_camera->sceneCamera.gpuCameraData.projection, reverseOrthoTransposed);
-	vec4 frustumX;
-	vec4 frustumY;
-	normalizePlane(reverseOrthoTransposed[0], reverseOrthoTransposed[3], frustumX);
-	normalizePlane(reverseOrthoTransposed[1], reverseOrthoTransposed[3], frustumY);
 
-	GPUCullingParams pc = {
-		.zNear = std::numeric_limits<float_t>::min(),  // @TODO: add switch to turn off near/far plane comparison in frustum culling.
-		.zFar = std::numeric_limits<float_t>::max(),
-		.frustumX_x = frustumX[0],
-		.frustumX_z = frustumX[2],
-		.frustumY_y = frustumY[1],
-		.frustumY_z = frustumY[2],
-		.cullingEnabled = (uint32_t)true,
-		.numInstances = currentFrame.numInstances,
+	GPUSceneScatterParams pc = {
+		.numDeltas = currentFrame.numGPUSceneDeltas,
 	};
-	glm_mat4_copy(_camera->sceneCamera.wholeShadowLightViewMatrix, pc.view);
 
 	// Dispatch compute.
+	Material& computeGPUSceneScatter = *getMaterial("computeGPUSceneScatter");
+	vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, computeGPUSceneScatter.pipeline);
+	vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, computeGPUSceneScatter.pipelineLayout, 0, 1, &currentFrame.gpuSceneScatterDescriptor, 0, nullptr);
+	vkCmdPushConstants(cmd, computeGPUSceneScatter.pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(GPUSceneScatterParams), &pc);
+	vkCmdDispatch(cmd, std::ceil(currentFrame.numGPUSceneDeltas / 128.0f), 1, 1);
+
+	// Block culling and drawing from reading the gpu scene until the deltas are in.
+	VkMemoryBarrier barrier = {
+		.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+		.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+		.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_INDIRECT_COMMAND_READ_BIT,
+	};
+	vkCmdPipelineBarrier(
+		cmd,
+		VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+		VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+		0, 1, &barrier, 0, nullptr, 0, nullptr
+	);
+}
+
+void VulkanEngine::computeShadowCulling(const FrameData& currentFrame, VkCommandBuffer cmd)
+{
+	ZoneScoped;
+	TracyVkZone(currentFrame.mainCommandBufferTracyVk, cmd, "Compute shadow culling");
+
 	Material& computeCulling = *getMaterial("computeCulling");
 	vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, computeCulling.pipeline);
-	vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, computeCulling.pipelineLayout, 0, 1, &currentFrame.indirectShadowPass.indirectDrawCommandDescriptor, 0, nullptr);
 	vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, computeCulling.pipelineLayout, 1, 1, &currentFrame.objectDescriptor, 0, nullptr);
 	vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, computeCulling.pipelineLayout, 2, 1, &currentFrame.instancePtrDescriptor, 0, nullptr);
-	vkCmdPushConstants(cmd, computeCulling.pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(GPUCullingParams), &pc);
-	vkCmdDispatch(cmd, std::ceil(currentFrame.numInstances / 128.0f), 1, 1);
+	vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, computeCulling.pipelineLayout, 3, 1, &currentFrame.occlusionCullingDescriptor, 0, nullptr);
 
-	// Block vertex shaders from running until the dispatched job is finished.
-	VkBufferMemoryBarrier barriers[] = {
-		{
+	// Cull against each cascade's ortho frustum, into that cascade's draw commands.
+	std::array<VkBufferMemoryBarrier, SHADOWMAP_CASCADES * 2> barriers;
+	for (uint32_t i = 0; i < SHADOWMAP_CASCADES; i++)
+	{
+		auto& shadowPass = currentFrame.indirectShadowPasses[i];
+
+		GPUCullingParams pc = {
+			.cullingEnabled = (uint32_t)true,
+			.numInstances = currentFrame.numInstances,
+			.occlusionCullingEnabled = (uint32_t)false,  // @NOTE: depth pyramid is from the camera's view, not the light's.
+			.cullingMode = 2,
+		};
+		glm_mat4_copy(_camera->sceneCamera.gpuCascadeViewProjsData.cascadeViewProjs[i], pc.view);  // @NOTE: view projection goes in the view slot for this mode.
+
+		vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, computeCulling.pipelineLayout, 0, 1, &shadowPass.indirectDrawCommandDescriptor, 0, nullptr);
+		vkCmdPushConstants(cmd, computeCulling.pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(GPUCullingParams), &pc);
+		vkCmdDispatch(cmd, std::ceil(currentFrame.numInstances / 128.0f), 1, 1);
+
+		barriers[i * 2 + 0] = {
 			.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
 			.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
 			.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT,
 			.srcQueueFamilyIndex = _graphicsQueueFamily,
 			.dstQueueFamilyIndex = _graphicsQueueFamily,
-			.buffer = currentFrame.indirectShadowPass.indirectDrawCommandsBuffer._buffer,
+			.buffer = shadowPass.indirectDrawCommandsBuffer._buffer,
 			.offset = 0,
-			.size = sizeof(VkDrawIndexedIndirectCommand) * INSTANCE_PTR_MAX_CAPACITY,
-		},
-		{
+			.size = VK_WHOLE_SIZE,
+		};
+		barriers[i * 2 + 1] = {
 			.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
 			.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
 			.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT,
 			.srcQueueFamilyIndex = _graphicsQueueFamily,
 			.dstQueueFamilyIndex = _graphicsQueueFamily,
-			.buffer = currentFrame.indirectShadowPass.indirectDrawCommandCountsBuffer._buffer,
+			.buffer = shadowPass.indirectDrawCommandCountsBuffer._buffer,
 			.offset = 0,
-			.size = sizeof(uint32_t) * INSTANCE_PTR_MAX_CAPACITY,
-		}
-	};
-	vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, 0, 0, nullptr, 2, barriers, 0, nullptr);
+			.size = VK_WHOLE_SIZE,
+		};
+	}
+
+	// Block vertex shaders from running until the dispatched jobs are finished.
+	vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, 0, 0, nullptr, (uint32_t)barriers.size(), barriers.data(), 0, nullptr);
 }
 
-void VulkanEngine::computeMainCulling(const FrameData& currentFrame, VkCommandBuffer cmd)
+void VulkanEngine::computeMainCulling(const FrameData& currentFrame, VkCommandBuffer cmd, uint32_t cullingPhase)
 {
 	ZoneScoped;
 	TracyVkZone(currentFrame.mainCommandBufferTracyVk, cmd, "Compute main culling");
@@ -422,6 +453,14 @@ void VulkanEngine::computeMainCulling(const FrameData& currentFrame, VkCommandBu
 		.frustumY_z = frustumY[2],
 		.cullingEnabled = (uint32_t)true,
 		.numInstances = currentFrame.numInstances,
+		.P00 = _camera->sceneCamera.gpuCameraData.projection[0][0],
+		.P11 = _camera->sceneCamera.gpuCameraData.projection[1][1],
+		.P22 = _camera->sceneCamera.gpuCameraData.projection[2][2],
+		.P32 = _camera->sceneCamera.gpuCameraData.projection[3][2],
+		.pyramidWidth = (float_t)_depthPyramid.extent.width,
+		.pyramidHeight = (float_t)_depthPyramid.extent.height,
+		.occlusionCullingEnabled = (uint32_t)(_depthPyramid.valid && _camera->sceneCamera.isPerspective),
+		.cullingMode = cullingPhase,
 	};
 	glm_mat4_copy(_camera->sceneCamera.gpuCameraData.view, pc.view);
 
@@ -431,9 +470,28 @@ void VulkanEngine::computeMainCulling(const FrameData& currentFrame, VkCommandBu
 	vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, computeCulling.pipelineLayout, 0, 1, &currentFrame.indirectMainPass.indirectDrawCommandDescriptor, 0, nullptr);
 	vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, computeCulling.pipelineLayout, 1, 1, &currentFrame.objectDescriptor, 0, nullptr);
 	vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, computeCulling.pipelineLayout, 2, 1, &currentFrame.instancePtrDescriptor, 0, nullptr);
+	vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, computeCulling.pipelineLayout, 3, 1, &currentFrame.occlusionCullingDescriptor, 0, nullptr);
 	vkCmdPushConstants(cmd, computeCulling.pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(GPUCullingParams), &pc);
 	vkCmdDispatch(cmd, std::ceil(currentFrame.numInstances / 128.0f), 1, 1);
 
+	if (cullingPhase == 1)
+	{
+		// Block next frame's culling from reading the visibilities until they're written.
+		// Also keeps next frame's depth prepass from writing the depth buffer while the pyramid build still reads it.
+		VkMemoryBarrier barrier = {
+			.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+			.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+			.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+		};
+		vkCmdPipelineBarrier(
+			cmd,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+			0, 1, &barrier, 0, nullptr, 0, nullptr
+		);
+		return;
+	}
+
 	// Block vertex shaders from running until the dispatched job is finished.
 	VkBufferMemoryBarrier barriers[] = {
 		{
@@ -444,7 +502,7 @@ void VulkanEngine::computeMainCulling(const FrameData& currentFrame, VkCommandBu
 			.dstQueueFamilyIndex = _graphicsQueueFamily,
 			.buffer = currentFrame.indirectMainPass.indirectDrawCommandsBuffer._buffer,
 			.offset = 0,
-			.size = sizeof(VkDrawIndexedIndirectCommand) * INSTANCE_PTR_MAX_CAPACITY,
+			.size = VK_WHOLE_SIZE,
 		},
 		{
 			.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
@@ -454,12 +512,102 @@ void VulkanEngine::computeMainCulling(const FrameData& currentFrame, VkCommandBu
 			.dstQueueFamilyIndex = _graphicsQueueFamily,
 			.buffer = currentFrame.indirectMainPass.indirectDrawCommandCountsBuffer._buffer,
 			.offset = 0,
-			.size = sizeof(uint32_t) * INSTANCE_PTR_MAX_CAPACITY,
+			.size = VK_WHOLE_SIZE,
 		}
 	};
 	vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, 0, 0, nullptr, 2, barriers, 0, nullptr);
 }
 
+void VulkanEngine::buildDepthPyramid(const FrameData& currentFrame, VkCommandBuffer cmd)
+{
+	ZoneScoped;
+	TracyVkZone(currentFrame.mainCommandBufferTracyVk, cmd, "Build depth pyramid");
+
+	// Wait for the depth buffer to get written. Also wait for last frame's culling
+	// to finish reading the pyramid before overwriting it.
+	VkImageMemoryBarrier depthBarriers[] = {
+		{
+			.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+			.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+			.dstAccessMask = VK_ACCESS_SHADER_READ_BIT,
+			.oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+			.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+			.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+			.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+			.image = _depthImage.image._image,
+			.subresourceRange = {
+				.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT,
+				.baseMipLevel = 0,
+				.levelCount = 1,
+				.baseArrayLayer = 0,
+				.layerCount = 1,
+			},
+		},
+		{
+			.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+			.srcAccessMask = 0,
+			.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+			.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+			.newLayout = VK_IMAGE_LAYOUT_GENERAL,
+			.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+			.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+			.image = _depthPyramid.image._image,
+			.subresourceRange = {
+				.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+				.baseMipLevel = 0,
+				.levelCount = _depthPyramid.numMips,
+				.baseArrayLayer = 0,
+				.layerCount = 1,
+			},
+		},
+	};
+	vkCmdPipelineBarrier(
+		cmd,
+		VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+		VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+		0, 0, nullptr, 0, nullptr, 2, depthBarriers
+	);
+
+	// Reduce each mip from the one before it (mip 0 reduces from the depth buffer).
+	Material& computeDepthReduce = *getMaterial("computeDepthReduce");
+	vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, computeDepthReduce.pipeline);
+
+	for (uint32_t i = 0; i < _depthPyramid.numMips; i++)
+	{
+		uint32_t levelWidth = std::max(1u, _depthPyramid.extent.width >> i);
+		uint32_t levelHeight = std::max(1u, _depthPyramid.extent.height >> i);
+
+		GPUDepthReduceParams pc = {
+			.imageSize = { (float_t)levelWidth, (float_t)levelHeight },
+		};
+		vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, computeDepthReduce.pipelineLayout, 0, 1, &_depthPyramid.reduceDescriptors[i], 0, nullptr);
+		vkCmdPushConstants(cmd, computeDepthReduce.pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(GPUDepthReduceParams), &pc);
+		vkCmdDispatch(cmd, std::ceil(levelWidth / 32.0f), std::ceil(levelHeight / 32.0f), 1);
+
+		// Block the next mip (and the culling) from reading this mip until it's written.
+		VkImageMemoryBarrier reduceBarrier = {
+			.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+			.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+			.dstAccessMask = VK_ACCESS_SHADER_READ_BIT,
+			.oldLayout = VK_IMAGE_LAYOUT_GENERAL,
+			.newLayout = VK_IMAGE_LAYOUT_GENERAL,
+			.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+			.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+			.image = _depthPyramid.image._image,
+			.subresourceRange = {
+				.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+				.baseMipLevel = i,
+				.levelCount = 1,
+				.baseArrayLayer = 0,
+				.layerCount = 1,
+			},
+		};
+		vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &reduceBarrier);
+	}
+
+	_depthPyramid.valid = true;
+}
+
 void VulkanEngine::computeSkinnedMeshes(const FrameData& currentFrame, VkCommandBuffer cmd)
 {
 	ZoneScoped;
@@ -551,7 +699,7 @@ void VulkanEngine::renderPickingRenderpass(const FrameData& currentFrame)
 	std::cout << "[PICKING]" << std::endl
 		<< "set picking scissor to: x=" << scissor.offset.x << "  y=" << scissor.offset.y << "  w=" << scissor.extent.width << "  h=" << scissor.extent.height << std::endl;
 
-	renderRenderObjects(cmd, currentFrame, true, false);
+	renderRenderObjects(cmd, currentFrame, true, currentFrame.indirectMainPass);
 
 	// End renderpass
 	vkCmdEndRenderPass(cmd);
@@ -583,31 +731,30 @@ void VulkanEngine::renderPickingRenderpass(const FrameData& currentFrame)
 	VK_CHECK(vkResetFences(_device, 1, &currentFrame.pickingRenderFence));
 
 	// Read from the gpu
-	GPUPickingSelectedIdData resetData = {};
-	GPUPickingSelectedIdData p;
-
-	void* data;
-	vmaMapMemory(_allocator, currentFrame.pickingSelectedIdBuffer._allocation, &data);
-	memcpy(&p, data, sizeof(GPUPickingSelectedIdData));            // It's not Dmitri, it's Irtimd this time
-	memcpy(data, &resetData, sizeof(GPUPickingSelectedIdData));    // @NOTE: if you don't reset the buffer, then you won't get 0 if you click on an empty spot next time bc you end up just getting garbage data.  -Dmitri
-	vmaUnmapMemory(_allocator, currentFrame.pickingSelectedIdBuffer._allocation);
-
 	// @TODO: Make a pre-check to see if these combination of objects were selected in the previous click, and then choose the 2nd nearest object, 3rd nearest, etc. depending on how many clicks.
+	GPUPickingSelectedIdData* p;
+	vmaMapMemory(_allocator, currentFrame.pickingSelectedIdBuffer._allocation, (void**)&p);
 
 	uint32_t nearestSelectedId = 0;
 	float_t nearestDepth = std::numeric_limits<float_t>::max();
 	for (size_t poolIndex : _roManager->_renderObjectsIndices)
 	{
-		if (p.selectedId[poolIndex] == 0)
+		if (poolIndex >= currentFrame.renderObjectBufferCapacity)
+			continue;  // Buffer got recreated bigger after the picking pass was rendered.
+
+		if (p[poolIndex].selectedId == 0)
 			continue;  // Means that the data never got filled
 
-		if (p.selectedDepth[poolIndex] > nearestDepth)
+		if (p[poolIndex].selectedDepth > nearestDepth)
 			continue;
 
-		nearestSelectedId = p.selectedId[poolIndex];
-		nearestDepth = p.selectedDepth[poolIndex];
+		nearestSelectedId = p[poolIndex].selectedId;
+		nearestDepth = p[poolIndex].selectedDepth;
 	}
 
+	memset(p, 0, sizeof(GPUPickingSelectedIdData) * currentFrame.renderObjectBufferCapacity);    // @NOTE: if you don't reset the buffer, then you won't get 0 if you click on an empty spot next time bc you end up just getting garbage data.  -Dmitri
+	vmaUnmapMemory(_allocator, currentFrame.pickingSelectedIdBuffer._allocation);
+
 	submitSelectedRenderObjectId(static_cast<int32_t>(nearestSelectedId) - 1);
 }
 
@@ -654,7 +801,7 @@ void VulkanEngine::renderShadowRenderpass(const FrameData& currentFrame, VkComma
 		CascadeIndexPushConstBlock pc = { i };
 		vkCmdPushConstants(cmd, shadowDepthPassMaterial.pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(CascadeIndexPushConstBlock), &pc);
 
-		renderRenderObjects(cmd, currentFrame, true, true);
+		renderRenderObjects(cmd, currentFrame, true, currentFrame.indirectShadowPasses[i]);
 		
 		vkCmdEndRenderPass(cmd);
 	}
@@ -699,7 +846,7 @@ void VulkanEngine::renderMainRenderpass(const FrameData& currentFrame, VkCommand
 	vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, defaultZPrepassMaterial.pipelineLayout, 1, 1, &currentFrame.objectDescriptor, 0, nullptr);
 	vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, defaultZPrepassMaterial.pipelineLayout, 2, 1, &currentFrame.instancePtrDescriptor, 0, nullptr);
 	vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, defaultZPrepassMaterial.pipelineLayout, 3, 1, &defaultZPrepassMaterial.textureSet, 0, nullptr);
-	renderRenderObjects(cmd, currentFrame, true, false);
+	renderRenderObjects(cmd, currentFrame, true, currentFrame.indirectMainPass);
 	//////////////////////
 
 	// Switch from zprepass subpass to main subpass
@@ -721,7 +868,7 @@ void VulkanEngine::renderMainRenderpass(const FrameData& currentFrame, VkCommand
 	}
 	///////////////////
 
-	renderRenderObjects(cmd, currentFrame, false, false);
+	renderRenderObjects(cmd, currentFrame, false, currentFrame.indirectMainPass);
 	if (!pickingIndirectDrawCommandIds.empty())
 		renderPickedObject(cmd, currentFrame, pickingIndirectDrawCommandIds);
 	physengine::renderDebugVisualization(cmd);
@@ -1511,6 +1658,24 @@ void VulkanEngine::render()
 
 	VK_CHECK(vkResetFences(_device, 1, &currentFrame.renderFence));
 
+	// Shared buffers that got replaced the last time this frame was recorded aren't in use by the gpu anymore.
+	for (AllocatedBuffer& buffer : getCurrentFrame().retiredBuffers)
+		vmaDestroyBuffer(_allocator, buffer._buffer, buffer._allocation);
+	getCurrentFrame().retiredBuffers.clear();
+
+	// Swap in runtime generated meshes (i.e. voxel fields that got remeshed).
+	size_t frameIndex = _frameNumber % FRAME_OVERLAP;
+	_roManager->processRuntimeModelRequests(this, frameIndex);
+
+	// Write animator nodes now that this frame's node buffer isn't in use by the gpu anymore.
+	bool animatorNodesChanged = vkglTF::Animator::growNodeCollectionBufferIfNeeded(frameIndex);
+	{
+		std::lock_guard<std::mutex> lg(_roManager->renderObjectIndicesAndPoolMutex);
+		animatorNodesChanged |= _roManager->uploadAnimatorNodesToGPU(frameIndex);
+	}
+	if (animatorNodesChanged)
+		getCurrentFrame().skinning.recomputeSkinnedMeshes = true;
+
 	//
 	// Request image from swapchain
 	//
@@ -1556,27 +1721,74 @@ void VulkanEngine::render()
 		std::vector<ModelWithIndirectDrawId> pickingIndirectDrawCommandIds;
 	#endif
 
+		// @NOTE: other threads register and unregister render objects straight into the mesh buckets,
+		//        so hold the lock until the skinning buffers and the draw commands are both built off
+		//        of the same buckets. Otherwise a skinned object added in between gets a draw that
+		//        points past the end of the skinning buffers.
+		std::unique_lock<std::mutex> meshBucketsLock(_roManager->renderObjectIndicesAndPoolMutex);
+
+		bool skinnedMeshBucketsChanged = false;
 		if (_roManager->checkIsMetaMeshListUnoptimized())
 		{
 			_roManager->optimizeMetaMeshList();
+			skinnedMeshBucketsChanged = true;
+		}
+		else
+			skinnedMeshBucketsChanged = _roManager->compactStaleMeshBuckets();
+		if (skinnedMeshBucketsChanged)
 			for (size_t i = 0; i < FRAME_OVERLAP; i++)
 				_frames[i].skinning.recalculateSkinningBuffers = true;
-		}
 		if (currentFrame.skinning.recalculateSkinningBuffers)
 			createSkinningBuffers(getCurrentFrame());
 
 		if (doCullingStuff)
 			compactRenderObjectsIntoDraws(getCurrentFrame(), pickedPoolIndices, pickingIndirectDrawCommandIds);
+		meshBucketsLock.unlock();
+
+		// Start off a new object visibility buffer with everything visible so nothing pops in.
+		if (_objectVisibilityBufferNeedsFill)
+		{
+			vkCmdFillBuffer(cmd, _objectVisibilityBuffer._buffer, 0, VK_WHOLE_SIZE, 1);
+			VkBufferMemoryBarrier barrier = {
+				.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+				.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+				.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+				.srcQueueFamilyIndex = _graphicsQueueFamily,
+				.dstQueueFamilyIndex = _graphicsQueueFamily,
+				.buffer = _objectVisibilityBuffer._buffer,
+				.offset = 0,
+				.size = VK_WHOLE_SIZE,
+			};
+			vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 1, &barrier, 0, nullptr);
+			_objectVisibilityBufferNeedsFill = false;
+		}
 
 		// Render render passes.
 		if (doCullingStuff)
 		{
+			computeGPUSceneScatter(currentFrame, cmd);
 			computeShadowCulling(currentFrame, cmd);
-			computeMainCulling(currentFrame, cmd);
+			computeMainCulling(currentFrame, cmd, 0);
+		}
+		if (currentFrame.skinning.recomputeSkinnedMeshes)
+		{
+			computeSkinnedMeshes(currentFrame, cmd);
+			getCurrentFrame().skinning.recomputeSkinnedMeshes = false;
 		}
-		computeSkinnedMeshes(currentFrame, cmd);
 		renderShadowRenderpass(currentFrame, cmd);
 		renderMainRenderpass(currentFrame, cmd, pickingIndirectDrawCommandIds);
+
+		// Occlusion culling for next frame.
+		// @NOTE: the z prepass is a subpass of the main renderpass, so there's no spot to cull with this
+		//        frame's depth before drawing. Instead, visibility from this frame's depth gets carried
+		//        over to the next frame's culling (objects visible last frame skip the occlusion test).
+		if (doCullingStuff && _camera->sceneCamera.isPerspective)
+		{
+			buildDepthPyramid(currentFrame, cmd);
+			computeMainCulling(currentFrame, cmd, 1);
+		}
+		else
+			_depthPyramid.valid = false;
 		renderUIRenderpass(currentFrame, cmd);
 		renderPostprocessRenderpass(currentFrame, cmd, swapchainImageIndex);
 	}
@@ -1960,7 +2172,7 @@ Material* VulkanEngine::getMaterial(const std::string& name)
 	return &it->second;
 }
 
-AllocatedBuffer VulkanEngine::createBuffer(size_t allocSize, VkBufferUsageFlags usage, VmaMemoryUsage memoryUsage)
+AllocatedBuffer VulkanEngine::createBuffer(size_t allocSize, VkBufferUsageFlags usage, VmaMemoryUsage memoryUsage, bool persistentlyMapped)
 {
 	VkBufferCreateInfo bufferInfo = {
 		.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
@@ -1969,14 +2181,291 @@ AllocatedBuffer VulkanEngine::createBuffer(size_t allocSize, VkBufferUsageFlags
 		.usage = usage,
 	};
 	VmaAllocationCreateInfo vmaAllocInfo = {
+		.flags = (persistentlyMapped ? (VmaAllocationCreateFlags)VMA_ALLOCATION_CREATE_MAPPED_BIT : 0),
 		.usage = memoryUsage,
 	};
 
 	AllocatedBuffer newBuffer;
-	VK_CHECK(vmaCreateBuffer(_allocator, &bufferInfo, &vmaAllocInfo, &newBuffer._buffer, &newBuffer._allocation, nullptr));
+	VmaAllocationInfo allocationInfo;
+	VK_CHECK(vmaCreateBuffer(_allocator, &bufferInfo, &vmaAllocInfo, &newBuffer._buffer, &newBuffer._allocation, &allocationInfo));
+	if (persistentlyMapped)
+		newBuffer._mappedData = allocationInfo.pMappedData;  // @NOTE: stays mapped until `vmaDestroyBuffer()`, so no need for map/unmap pairs each frame.
 	return newBuffer;
 }
 
+void VulkanEngine::createRenderObjectBuffers(FrameData& frame, size_t capacity)
+{
+	//
+	// Object Information
+	//
+	frame.objectBuffer = createBuffer(sizeof(GPUObjectData) * capacity, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU, true);
+	VkDescriptorBufferInfo objectBufferInfo = {
+		.buffer = frame.objectBuffer._buffer,
+		.offset = 0,
+		.range = sizeof(GPUObjectData) * capacity,
+	};
+	vkutil::DescriptorBuilder::begin()
+		.bindBuffer(0, &objectBufferInfo, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_COMPUTE_BIT)
+		.buildOrUpdate(frame.objectDescriptor, _objectSetLayout);
+
+	//
+	// Picking ID Capture
+	//
+	frame.pickingSelectedIdBuffer = createBuffer(sizeof(GPUPickingSelectedIdData) * capacity, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VMA_MEMORY_USAGE_GPU_TO_CPU);    // @NOTE: primary focus is to read from gpu, so gpu_to_cpu
+	void* data;
+	vmaMapMemory(_allocator, frame.pickingSelectedIdBuffer._allocation, &data);
+	memset(data, 0, sizeof(GPUPickingSelectedIdData) * capacity);
+	vmaUnmapMemory(_allocator, frame.pickingSelectedIdBuffer._allocation);
+
+	VkDescriptorBufferInfo pickingSelectedIdBufferInfo = {
+		.buffer = frame.pickingSelectedIdBuffer._buffer,
+		.offset = 0,
+		.range = sizeof(GPUPickingSelectedIdData) * capacity,
+	};
+	vkutil::DescriptorBuilder::begin()
+		.bindBuffer(0, &pickingSelectedIdBufferInfo, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_FRAGMENT_BIT)
+		.buildOrUpdate(frame.pickingReturnValueDescriptor, _pickingReturnValueSetLayout);
+
+	frame.renderObjectBufferCapacity = capacity;
+}
+
+void VulkanEngine::destroyRenderObjectBuffers(FrameData& frame)
+{
+	vmaDestroyBuffer(_allocator, frame.objectBuffer._buffer, frame.objectBuffer._allocation);
+	vmaDestroyBuffer(_allocator, frame.pickingSelectedIdBuffer._buffer, frame.pickingSelectedIdBuffer._allocation);
+	frame.renderObjectBufferCapacity = 0;
+}
+
+void VulkanEngine::createGPUSceneBuffers(size_t capacity)
+{
+	// @NOTE: only the scatter compute shader writes to these, so they can live in device local memory.
+	_gpuScene.indirectDrawCommandRawBuffer = createBuffer(sizeof(VkDrawIndexedIndirectCommand) * capacity, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, VMA_MEMORY_USAGE_GPU_ONLY);
+	_gpuScene.indirectDrawCommandOffsetsBuffer = createBuffer(sizeof(GPUIndirectDrawCommandOffsetsData) * capacity, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VMA_MEMORY_USAGE_GPU_ONLY);
+	_gpuScene.instancePtrBuffer = createBuffer(sizeof(GPUInstancePointer) * capacity, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VMA_MEMORY_USAGE_GPU_ONLY);
+	_gpuScene.capacity = capacity;
+	_gpuScene.buffersGeneration++;
+
+	// Contents of the new buffers are undefined, so everything has to get scattered in again.
+	_gpuScene.numInstances = 0;
+	_gpuScene.compactedDrawCommandsGeneration = 0;
+	_gpuScene.drawCommands.clear();
+	_gpuScene.drawCommandOffsets.clear();
+	_gpuScene.instancePtrs.clear();
+}
+
+void VulkanEngine::destroyGPUSceneBuffers()
+{
+	vmaDestroyBuffer(_allocator, _gpuScene.indirectDrawCommandRawBuffer._buffer, _gpuScene.indirectDrawCommandRawBuffer._allocation);
+	vmaDestroyBuffer(_allocator, _gpuScene.indirectDrawCommandOffsetsBuffer._buffer, _gpuScene.indirectDrawCommandOffsetsBuffer._allocation);
+	vmaDestroyBuffer(_allocator, _gpuScene.instancePtrBuffer._buffer, _gpuScene.instancePtrBuffer._allocation);
+	_gpuScene.capacity = 0;
+}
+
+void VulkanEngine::createIndirectPassBuffers(FrameData& frame, size_t capacity)
+{
+	//
+	// Instance Pointers
+	//
+	VkDescriptorBufferInfo instancePtrBufferInfo = {
+		.buffer = _gpuScene.instancePtrBuffer._buffer,
+		.offset = 0,
+		.range = sizeof(GPUInstancePointer) * capacity,
+	};
+	vkutil::DescriptorBuilder::begin()
+		.bindBuffer(0, &instancePtrBufferInfo, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT)
+		.buildOrUpdate(frame.instancePtrDescriptor, _instancePtrSetLayout);
+
+	//
+	// Indirect draw commands (culled output)
+	//
+	VkDescriptorBufferInfo drawCommandsRawBufferInfo = {
+		.buffer = _gpuScene.indirectDrawCommandRawBuffer._buffer,
+		.offset = 0,
+		.range = sizeof(VkDrawIndexedIndirectCommand) * capacity,
+	};
+	VkDescriptorBufferInfo drawCommandOffsetsBufferInfo = {
+		.buffer = _gpuScene.indirectDrawCommandOffsetsBuffer._buffer,
+		.offset = 0,
+		.range = sizeof(GPUIndirectDrawCommandOffsetsData) * capacity,
+	};
+	auto createIndirectPass = [&](FrameData::IndirectPass& pass) {
+		pass.indirectDrawCommandsBuffer = createBuffer(sizeof(VkDrawIndexedIndirectCommand) * capacity, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, VMA_MEMORY_USAGE_GPU_ONLY);
+		pass.indirectDrawCommandCountsBuffer = createBuffer(sizeof(uint32_t) * capacity, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU, true);
+
+		// Descriptor set for compute culling.
+		VkDescriptorBufferInfo drawCommandsOutputBufferInfo = {
+			.buffer = pass.indirectDrawCommandsBuffer._buffer,
+			.offset = 0,
+			.range = sizeof(VkDrawIndexedIndirectCommand) * capacity,
+		};
+		VkDescriptorBufferInfo drawCommandCountsBufferInfo = {
+			.buffer = pass.indirectDrawCommandCountsBuffer._buffer,
+			.offset = 0,
+			.range = sizeof(uint32_t) * capacity,
+		};
+
+		vkutil::DescriptorBuilder::begin()
+			.bindBuffer(0, &drawCommandsRawBufferInfo, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+			.bindBuffer(1, &drawCommandsOutputBufferInfo, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+			.bindBuffer(2, &drawCommandOffsetsBufferInfo, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+			.bindBuffer(3, &drawCommandCountsBufferInfo, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+			.buildOrUpdate(pass.indirectDrawCommandDescriptor, _computeCullingIndirectDrawCommandSetLayout);
+	};
+
+	for (auto& shadowPass : frame.indirectShadowPasses)
+		createIndirectPass(shadowPass);  // One per cascade.
+	createIndirectPass(frame.indirectMainPass);
+
+	frame.indirectPassBufferCapacity = capacity;
+	frame.gpuSceneBuffersGeneration = _gpuScene.buffersGeneration;
+}
+
+void VulkanEngine::destroyIndirectPassBuffers(FrameData& frame)
+{
+	auto destroyIndirectPass = [&](FrameData::IndirectPass& pass) {
+		vmaDestroyBuffer(_allocator, pass.indirectDrawCommandsBuffer._buffer, pass.indirectDrawCommandsBuffer._allocation);
+		vmaDestroyBuffer(_allocator, pass.indirectDrawCommandCountsBuffer._buffer, pass.indirectDrawCommandCountsBuffer._allocation);
+	};
+
+	for (auto& shadowPass : frame.indirectShadowPasses)
+		destroyIndirectPass(shadowPass);
+	destroyIndirectPass(frame.indirectMainPass);
+	frame.indirectPassBufferCapacity = 0;
+}
+
+void VulkanEngine::buildGPUSceneScatterDescriptor(FrameData& frame)
+{
+	VkDescriptorBufferInfo deltasBufferInfo = {
+		.buffer = frame.gpuSceneDeltasBuffer._buffer,
+		.offset = 0,
+		.range = sizeof(GPUSceneDelta) * frame.gpuSceneDeltasBufferCapacity,
+	};
+	VkDescriptorBufferInfo drawCommandsRawBufferInfo = {
+		.buffer = _gpuScene.indirectDrawCommandRawBuffer._buffer,
+		.offset = 0,
+		.range = sizeof(VkDrawIndexedIndirectCommand) * _gpuScene.capacity,
+	};
+	VkDescriptorBufferInfo drawCommandOffsetsBufferInfo = {
+		.buffer = _gpuScene.indirectDrawCommandOffsetsBuffer._buffer,
+		.offset = 0,
+		.range = sizeof(GPUIndirectDrawCommandOffsetsData) * _gpuScene.capacity,
+	};
+	VkDescriptorBufferInfo instancePtrBufferInfo = {
+		.buffer = _gpuScene.instancePtrBuffer._buffer,
+		.offset = 0,
+		.range = sizeof(GPUInstancePointer) * _gpuScene.capacity,
+	};
+
+	vkutil::DescriptorBuilder::begin()
+		.bindBuffer(0, &deltasBufferInfo, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+		.bindBuffer(1, &drawCommandsRawBufferInfo, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+		.bindBuffer(2, &drawCommandOffsetsBufferInfo, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+		.bindBuffer(3, &instancePtrBufferInfo, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+		.buildOrUpdate(frame.gpuSceneScatterDescriptor, _computeGPUSceneScatterSetLayout);
+}
+
+void VulkanEngine::growGPUSceneDeltasBufferIfNeeded(FrameData& frame, size_t numDeltas)
+{
+	if (numDeltas <= frame.gpuSceneDeltasBufferCapacity)
+		return;
+
+	// @NOTE: this frame's fence was already waited on, so its part of the staging ring is free to swap out.
+	if (frame.gpuSceneDeltasBufferCapacity > 0)
+		vmaDestroyBuffer(_allocator, frame.gpuSceneDeltasBuffer._buffer, frame.gpuSceneDeltasBuffer._allocation);
+
+	size_t newCapacity = (numDeltas + INSTANCE_PTR_CHUNK_SIZE - 1) / INSTANCE_PTR_CHUNK_SIZE * INSTANCE_PTR_CHUNK_SIZE;
+	frame.gpuSceneDeltasBuffer = createBuffer(sizeof(GPUSceneDelta) * newCapacity, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU, true);
+	frame.gpuSceneDeltasBufferCapacity = newCapacity;
+	buildGPUSceneScatterDescriptor(frame);
+}
+
+void VulkanEngine::growRenderObjectBuffersIfNeeded(FrameData& currentFrame, size_t numRenderObjectSlots)
+{
+	size_t newCapacity = (numRenderObjectSlots + RENDER_OBJECTS_PAGE_SIZE - 1) / RENDER_OBJECTS_PAGE_SIZE * RENDER_OBJECTS_PAGE_SIZE;
+
+	// The visibility buffer is shared between frames, so the frame in flight could still be using the old one.
+	if (numRenderObjectSlots > _objectVisibilityBufferCapacity)
+	{
+		ZoneScopedN("Grow object visibility buffer");
+		currentFrame.retiredBuffers.push_back(_objectVisibilityBuffer);
+		createObjectVisibilityBuffer(newCapacity);
+	}
+
+	// @NOTE: this frame's fence was already waited on, so its own buffers are free to swap out.
+	//        The other frames' buffers grow when it's their turn.
+	if (numRenderObjectSlots > currentFrame.renderObjectBufferCapacity)
+	{
+		ZoneScopedN("Grow render object buffers");
+		destroyRenderObjectBuffers(currentFrame);
+		createRenderObjectBuffers(currentFrame, newCapacity);
+
+		// New buffers are empty, so every object needs to get written into this frame's copy again.
+		uint8_t currentFrameBit = (uint8_t)(1 << (_frameNumber % FRAME_OVERLAP));
+		for (size_t poolIndex : _roManager->_renderObjectsIndices)
+			_roManager->_renderObjectPool[poolIndex].gpuObjectDataDirtyBits |= currentFrameBit;
+	}
+}
+
+void VulkanEngine::growInstancePtrBuffersIfNeeded(FrameData& currentFrame, size_t numInstances)
+{
+	if (numInstances <= _gpuScene.capacity)
+		return;
+
+	ZoneScoped;
+
+	// The gpu scene is shared between frames, so the frame in flight could still be using the old buffers.
+	currentFrame.retiredBuffers.push_back(_gpuScene.indirectDrawCommandRawBuffer);
+	currentFrame.retiredBuffers.push_back(_gpuScene.indirectDrawCommandOffsetsBuffer);
+	currentFrame.retiredBuffers.push_back(_gpuScene.instancePtrBuffer);
+
+	size_t newCapacity = (numInstances + INSTANCE_PTR_CHUNK_SIZE - 1) / INSTANCE_PTR_CHUNK_SIZE * INSTANCE_PTR_CHUNK_SIZE;
+	createGPUSceneBuffers(newCapacity);
+	refreshSharedBufferDescriptors(currentFrame);
+}
+
+void VulkanEngine::refreshSharedBufferDescriptors(FrameData& currentFrame)
+{
+	// Catch up on the shared buffers that got replaced since this frame was last recorded.
+	// @NOTE: this frame's fence was already waited on, so its descriptor sets aren't in use anymore.
+	if (currentFrame.gpuSceneBuffersGeneration != _gpuScene.buffersGeneration)
+	{
+		destroyIndirectPassBuffers(currentFrame);
+		createIndirectPassBuffers(currentFrame, _gpuScene.capacity);  // Sized the same as the gpu scene.
+		buildGPUSceneScatterDescriptor(currentFrame);
+	}
+	if (currentFrame.objectVisibilityBufferGeneration != _objectVisibilityBufferGeneration)
+		buildOcclusionCullingDescriptor(currentFrame);
+}
+
+void VulkanEngine::createObjectVisibilityBuffer(size_t capacity)
+{
+	// @NOTE: the previous buffer (if any) is up to the caller to destroy, since frames in flight could still be using it.
+	_objectVisibilityBuffer = createBuffer(sizeof(uint32_t) * capacity, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_GPU_ONLY);
+	_objectVisibilityBufferCapacity = capacity;
+	_objectVisibilityBufferGeneration++;
+	_objectVisibilityBufferNeedsFill = true;
+}
+
+void VulkanEngine::buildOcclusionCullingDescriptor(FrameData& frame)
+{
+	VkDescriptorImageInfo depthPyramidImageInfo = {
+		.sampler = _depthPyramid.maxSampler,
+		.imageView = _depthPyramid.imageView,
+		.imageLayout = VK_IMAGE_LAYOUT_GENERAL,
+	};
+	VkDescriptorBufferInfo objectVisibilityBufferInfo = {
+		.buffer = _objectVisibilityBuffer._buffer,
+		.offset = 0,
+		.range = sizeof(uint32_t) * _objectVisibilityBufferCapacity,
+	};
+
+	vkutil::DescriptorBuilder::begin()
+		.bindImage(0, &depthPyramidImageInfo, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_COMPUTE_BIT)
+		.bindBuffer(1, &objectVisibilityBufferInfo, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+		.buildOrUpdate(frame.occlusionCullingDescriptor, _occlusionCullingSetLayout);
+	frame.objectVisibilityBufferGeneration = _objectVisibilityBufferGeneration;
+}
+
 size_t VulkanEngine::padUniformBufferSize(size_t originalSize)
 {
 	// https://github.com/SaschaWillems/Vulkan/tree/master/examples/dynamicuniformbuffer
@@ -2202,24 +2691,10 @@ void VulkanEngine::initCommands()
 			TracyVkContext(_chosenGPU, _device, _graphicsQueue, _frames[i].mainCommandBuffer);
 #endif
 
-		// Create indirect draw command buffer
-		_frames[i].indirectDrawCommandRawBuffer = createBuffer(sizeof(VkDrawIndexedIndirectCommand) * INSTANCE_PTR_MAX_CAPACITY, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
-		_frames[i].indirectShadowPass.indirectDrawCommandsBuffer = createBuffer(sizeof(VkDrawIndexedIndirectCommand) * INSTANCE_PTR_MAX_CAPACITY, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, VMA_MEMORY_USAGE_GPU_ONLY);
-		_frames[i].indirectMainPass.indirectDrawCommandsBuffer = createBuffer(sizeof(VkDrawIndexedIndirectCommand) * INSTANCE_PTR_MAX_CAPACITY, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, VMA_MEMORY_USAGE_GPU_ONLY);
-		_frames[i].indirectDrawCommandOffsetsBuffer = createBuffer(sizeof(GPUIndirectDrawCommandOffsetsData) * INSTANCE_PTR_MAX_CAPACITY, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
-		_frames[i].indirectShadowPass.indirectDrawCommandCountsBuffer = createBuffer(sizeof(uint32_t) * INSTANCE_PTR_MAX_CAPACITY, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
-		_frames[i].indirectMainPass.indirectDrawCommandCountsBuffer = createBuffer(sizeof(uint32_t) * INSTANCE_PTR_MAX_CAPACITY, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
-
 		// Add destroy command for cleanup
 		_mainDeletionQueue.pushFunction([=]() {
 			vkDestroyCommandPool(_device, _frames[i].commandPool, nullptr);
 			TracyVkDestroy(_frames[i].mainCommandBufferTracyVk);
-			vmaDestroyBuffer(_allocator, _frames[i].indirectDrawCommandRawBuffer._buffer, _frames[i].indirectDrawCommandRawBuffer._allocation);
-			vmaDestroyBuffer(_allocator, _frames[i].indirectShadowPass.indirectDrawCommandsBuffer._buffer, _frames[i].indirectShadowPass.indirectDrawCommandsBuffer._allocation);
-			vmaDestroyBuffer(_allocator, _frames[i].indirectMainPass.indirectDrawCommandsBuffer._buffer, _frames[i].indirectMainPass.indirectDrawCommandsBuffer._allocation);
-			vmaDestroyBuffer(_allocator, _frames[i].indirectDrawCommandOffsetsBuffer._buffer, _frames[i].indirectDrawCommandOffsetsBuffer._allocation);
-			vmaDestroyBuffer(_allocator, _frames[i].indirectShadowPass.indirectDrawCommandCountsBuffer._buffer, _frames[i].indirectShadowPass.indirectDrawCommandCountsBuffer._allocation);
-			vmaDestroyBuffer(_allocator, _frames[i].indirectMainPass.indirectDrawCommandCountsBuffer._buffer, _frames[i].indirectMainPass.indirectDrawCommandCountsBuffer._allocation);
 			});
 	}
 
@@ -3505,6 +3980,86 @@ void VulkanEngine::initPostprocessImages()
 	attachTextureSetToMaterial(postprocessingTextureSet, "postprocessMaterial");
 }
 
+void VulkanEngine::initDepthPyramid()
+{
+	// @NOTE: pyramid is the previous power of 2 of the screen so that every mip is exactly half of the one before it.
+	_depthPyramid.extent = {
+		.width = occlusionculling::previousPow2(_windowExtent.width),
+		.height = occlusionculling::previousPow2(_windowExtent.height),
+	};
+	_depthPyramid.numMips = occlusionculling::calcNumMips(_depthPyramid.extent.width, _depthPyramid.extent.height);
+	_depthPyramid.valid = false;
+
+	VkExtent3D pyramidExtent = { _depthPyramid.extent.width, _depthPyramid.extent.height, 1 };
+	VkImageCreateInfo pyramidImgInfo = vkinit::imageCreateInfo(VK_FORMAT_R32_SFLOAT, VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, pyramidExtent, _depthPyramid.numMips);
+	VmaAllocationCreateInfo pyramidAllocInfo = {
+		.usage = VMA_MEMORY_USAGE_GPU_ONLY,
+		.requiredFlags = VkMemoryPropertyFlags(VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)
+	};
+	vmaCreateImage(_allocator, &pyramidImgInfo, &pyramidAllocInfo, &_depthPyramid.image._image, &_depthPyramid.image._allocation, nullptr);
+	_depthPyramid.image._mipLevels = _depthPyramid.numMips;
+
+	VkImageViewCreateInfo pyramidViewInfo = vkinit::imageviewCreateInfo(VK_FORMAT_R32_SFLOAT, _depthPyramid.image._image, VK_IMAGE_ASPECT_COLOR_BIT, _depthPyramid.numMips);
+	VK_CHECK(vkCreateImageView(_device, &pyramidViewInfo, nullptr, &_depthPyramid.imageView));
+
+	_depthPyramid.mipImageViews.resize(_depthPyramid.numMips);
+	for (uint32_t i = 0; i < _depthPyramid.numMips; i++)
+	{
+		VkImageViewCreateInfo mipViewInfo = vkinit::imageviewCreateInfo(VK_FORMAT_R32_SFLOAT, _depthPyramid.image._image, VK_IMAGE_ASPECT_COLOR_BIT, 1);
+		mipViewInfo.subresourceRange.baseMipLevel = i;
+		VK_CHECK(vkCreateImageView(_device, &mipViewInfo, nullptr, &_depthPyramid.mipImageViews[i]));
+	}
+
+	// Create special MAX sampler for reducing the depth.
+	VkSamplerCreateInfo samplerInfo = vkinit::samplerCreateInfo((float_t)_depthPyramid.numMips, VK_FILTER_LINEAR, VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE, false);
+	samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+
+	VkSamplerReductionModeCreateInfo reductionSamplerInfo = {
+		.sType = VK_STRUCTURE_TYPE_SAMPLER_REDUCTION_MODE_CREATE_INFO,
+		.pNext = nullptr,
+		.reductionMode = VK_SAMPLER_REDUCTION_MODE_MAX,
+	};
+
+	samplerInfo.pNext = &reductionSamplerInfo;
+
+	VK_CHECK(vkCreateSampler(_device, &samplerInfo, nullptr, &_depthPyramid.maxSampler));
+
+	// Reduce descriptors (mip 0 reads the depth buffer, the rest read the previous mip).
+	_depthPyramid.reduceDescriptors.resize(_depthPyramid.numMips);
+	for (uint32_t i = 0; i < _depthPyramid.numMips; i++)
+	{
+		VkDescriptorImageInfo outImageInfo = {
+			.sampler = VK_NULL_HANDLE,
+			.imageView = _depthPyramid.mipImageViews[i],
+			.imageLayout = VK_IMAGE_LAYOUT_GENERAL,
+		};
+		VkDescriptorImageInfo inImageInfo = {
+			.sampler = _depthPyramid.maxSampler,
+			.imageView = (i == 0 ? _depthImage.imageView : _depthPyramid.mipImageViews[i - 1]),
+			.imageLayout = (i == 0 ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_GENERAL),
+		};
+		vkutil::DescriptorBuilder::begin()
+			.bindImage(0, &outImageInfo, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT)
+			.bindImage(1, &inImageInfo, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_COMPUTE_BIT)
+			.build(_depthPyramid.reduceDescriptors[i], _depthReduceSetLayout);
+	}
+
+	// @NOTE: the frames' occlusion culling descriptor sets don't exist yet during the first init (they get
+	//        made in `refreshSharedBufferDescriptors()`). The device is idle here, so they can get rewritten.
+	for (FrameData& frame : _frames)
+		if (frame.occlusionCullingDescriptor != VK_NULL_HANDLE)
+			buildOcclusionCullingDescriptor(frame);
+
+	// Add destroy command
+	_swapchainDependentDeletionQueue.pushFunction([=]() {
+		vkDestroySampler(_device, _depthPyramid.maxSampler, nullptr);
+		for (VkImageView mipImageView : _depthPyramid.mipImageViews)
+			vkDestroyImageView(_device, mipImageView, nullptr);
+		vkDestroyImageView(_device, _depthPyramid.imageView, nullptr);
+		vmaDestroyImage(_allocator, _depthPyramid.image._image, _depthPyramid.image._allocation);
+		});
+}
+
 void VulkanEngine::initPickingRenderpass()    // @NOTE: @COPYPASTA: This is really copypasta of the above function (initMainRenderpass)
 {
 	//
@@ -3817,13 +4372,18 @@ void VulkanEngine::initDescriptors()    // @NOTE: don't destroy and then recreat
 	//
 	// Create Descriptor Sets
 	//
+	createGPUSceneBuffers(INSTANCE_PTR_CHUNK_SIZE);
+	_mainDeletionQueue.pushFunction([=]() {
+		destroyGPUSceneBuffers();
+	});
+
 	for (size_t i = 0; i < FRAME_OVERLAP; i++)
 	{
 		//
 		// Global
 		//
-		_frames[i].cameraBuffer = createBuffer(sizeof(GPUCameraData), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
-		_frames[i].pbrShadingPropsBuffer = createBuffer(sizeof(GPUPBRShadingProps), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
+		_frames[i].cameraBuffer = createBuffer(sizeof(GPUCameraData), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU, true);
+		_frames[i].pbrShadingPropsBuffer = createBuffer(sizeof(GPUPBRShadingProps), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU, true);
 
 		VkDescriptorBufferInfo cameraInfo = {
 			.buffer = _frames[i].cameraBuffer._buffer,
@@ -3885,43 +4445,12 @@ void VulkanEngine::initDescriptors()    // @NOTE: don't destroy and then recreat
 			.build(_frames[i].cascadeViewProjsDescriptor, _cascadeViewProjsSetLayout);
 
 		//
-		// Object Information
-		//
-		_frames[i].objectBuffer = createBuffer(sizeof(GPUObjectData) * RENDER_OBJECTS_MAX_CAPACITY, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
-		VkDescriptorBufferInfo objectBufferInfo = {
-			.buffer = _frames[i].objectBuffer._buffer,
-			.offset = 0,
-			.range = sizeof(GPUObjectData) * RENDER_OBJECTS_MAX_CAPACITY,
-		};
-		vkutil::DescriptorBuilder::begin()
-			.bindBuffer(0, &objectBufferInfo, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_COMPUTE_BIT)
-			.build(_frames[i].objectDescriptor, _objectSetLayout);
-
-		//
-		// Instance Pointers
-		//
-		_frames[i].instancePtrBuffer = createBuffer(sizeof(GPUInstancePointer) * INSTANCE_PTR_MAX_CAPACITY, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
-		VkDescriptorBufferInfo instancePtrBufferInfo = {
-			.buffer = _frames[i].instancePtrBuffer._buffer,
-			.offset = 0,
-			.range = sizeof(GPUInstancePointer) * INSTANCE_PTR_MAX_CAPACITY,
-		};
-		vkutil::DescriptorBuilder::begin()
-			.bindBuffer(0, &instancePtrBufferInfo, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT)
-			.build(_frames[i].instancePtrDescriptor, _instancePtrSetLayout);
-
-		//
-		// Picking ID Capture
+		// Object Information, Picking ID Capture, Instance Pointers and Indirect Draw Commands
+		// @NOTE: these start small and get recreated bigger whenever the render object pool outgrows them.
 		//
-		_frames[i].pickingSelectedIdBuffer = createBuffer(sizeof(GPUPickingSelectedIdData), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VMA_MEMORY_USAGE_GPU_TO_CPU);    // @NOTE: primary focus is to read from gpu, so gpu_to_cpu
-		VkDescriptorBufferInfo pickingSelectedIdBufferInfo = {
-			.buffer = _frames[i].pickingSelectedIdBuffer._buffer,
-			.offset = 0,
-			.range = sizeof(GPUPickingSelectedIdData),
-		};
-		vkutil::DescriptorBuilder::begin()
-			.bindBuffer(0, &pickingSelectedIdBufferInfo, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_FRAGMENT_BIT)
-			.build(_frames[i].pickingReturnValueDescriptor, _pickingReturnValueSetLayout);
+		createRenderObjectBuffers(_frames[i], RENDER_OBJECTS_PAGE_SIZE);
+		createIndirectPassBuffers(_frames[i], INSTANCE_PTR_CHUNK_SIZE);
+		growGPUSceneDeltasBufferIfNeeded(_frames[i], INSTANCE_PTR_CHUNK_SIZE);
 
 		//
 		// Add destroy command for cleanup
@@ -3930,12 +4459,23 @@ void VulkanEngine::initDescriptors()    // @NOTE: don't destroy and then recreat
 			vmaDestroyBuffer(_allocator, _frames[i].cameraBuffer._buffer, _frames[i].cameraBuffer._allocation);
 			vmaDestroyBuffer(_allocator, _frames[i].pbrShadingPropsBuffer._buffer, _frames[i].pbrShadingPropsBuffer._allocation);
 			vmaDestroyBuffer(_allocator, _frames[i].cascadeViewProjsBuffer._buffer, _frames[i].cascadeViewProjsBuffer._allocation);
-			vmaDestroyBuffer(_allocator, _frames[i].objectBuffer._buffer, _frames[i].objectBuffer._allocation);
-			vmaDestroyBuffer(_allocator, _frames[i].instancePtrBuffer._buffer, _frames[i].instancePtrBuffer._allocation);
-			vmaDestroyBuffer(_allocator, _frames[i].pickingSelectedIdBuffer._buffer, _frames[i].pickingSelectedIdBuffer._allocation);
+			destroyRenderObjectBuffers(_frames[i]);
+			destroyIndirectPassBuffers(_frames[i]);
+			vmaDestroyBuffer(_allocator, _frames[i].gpuSceneDeltasBuffer._buffer, _frames[i].gpuSceneDeltasBuffer._allocation);
+			for (AllocatedBuffer& buffer : _frames[i].retiredBuffers)
+				vmaDestroyBuffer(_allocator, buffer._buffer, buffer._allocation);
 		});
 	}
 
+	//
+	// Object visibility for occlusion culling
+	// @NOTE: shared between frames, since each frame's culling needs the last frame's results.
+	//
+	createObjectVisibilityBuffer(RENDER_OBJECTS_PAGE_SIZE);
+	_mainDeletionQueue.pushFunction([=]() {
+		vmaDestroyBuffer(_allocator, _objectVisibilityBuffer._buffer, _objectVisibilityBuffer._allocation);
+	});
+
 	//
 	// Single texture (i.e. skybox)
 	//
@@ -3967,63 +4507,6 @@ void VulkanEngine::initDescriptors()    // @NOTE: don't destroy and then recreat
 
 	physengine::initDebugVisDescriptors(this);
 
-	// Descriptor set for compute culling.
-	for (size_t i = 0; i < FRAME_OVERLAP; i++)
-	{
-		auto& currentFrame = _frames[i];
-
-		VkDescriptorBufferInfo drawCommandsRawBufferInfo = {
-			.buffer = currentFrame.indirectDrawCommandRawBuffer._buffer,
-			.offset = 0,
-			.range = sizeof(VkDrawIndexedIndirectCommand) * INSTANCE_PTR_MAX_CAPACITY,
-		};
-		VkDescriptorBufferInfo drawCommandOffsetsBufferInfo = {
-			.buffer = currentFrame.indirectDrawCommandOffsetsBuffer._buffer,
-			.offset = 0,
-			.range = sizeof(GPUIndirectDrawCommandOffsetsData) * INSTANCE_PTR_MAX_CAPACITY,
-		};
-		{
-			// Shadow pass.
-			VkDescriptorBufferInfo drawCommandsOutputBufferInfo = {
-				.buffer = currentFrame.indirectShadowPass.indirectDrawCommandsBuffer._buffer,
-				.offset = 0,
-				.range = sizeof(VkDrawIndexedIndirectCommand) * INSTANCE_PTR_MAX_CAPACITY,
-			};
-			VkDescriptorBufferInfo drawCommandCountsBufferInfo = {
-				.buffer = currentFrame.indirectShadowPass.indirectDrawCommandCountsBuffer._buffer,
-				.offset = 0,
-				.range = sizeof(uint32_t) * INSTANCE_PTR_MAX_CAPACITY,
-			};
-
-			vkutil::DescriptorBuilder::begin()
-				.bindBuffer(0, &drawCommandsRawBufferInfo, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
-				.bindBuffer(1, &drawCommandsOutputBufferInfo, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
-				.bindBuffer(2, &drawCommandOffsetsBufferInfo, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
-				.bindBuffer(3, &drawCommandCountsBufferInfo, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
-				.build(currentFrame.indirectShadowPass.indirectDrawCommandDescriptor, _computeCullingIndirectDrawCommandSetLayout);
-		}
-		{
-			// Main pass.
-			VkDescriptorBufferInfo drawCommandsOutputBufferInfo = {
-				.buffer = currentFrame.indirectMainPass.indirectDrawCommandsBuffer._buffer,
-				.offset = 0,
-				.range = sizeof(VkDrawIndexedIndirectCommand) * INSTANCE_PTR_MAX_CAPACITY,
-			};
-			VkDescriptorBufferInfo drawCommandCountsBufferInfo = {
-				.buffer = currentFrame.indirectMainPass.indirectDrawCommandCountsBuffer._buffer,
-				.offset = 0,
-				.range = sizeof(uint32_t) * INSTANCE_PTR_MAX_CAPACITY,
-			};
-
-			vkutil::DescriptorBuilder::begin()
-				.bindBuffer(0, &drawCommandsRawBufferInfo, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
-				.bindBuffer(1, &drawCommandsOutputBufferInfo, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
-				.bindBuffer(2, &drawCommandOffsetsBufferInfo, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
-				.bindBuffer(3, &drawCommandCountsBufferInfo, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
-				.build(currentFrame.indirectMainPass.indirectDrawCommandDescriptor, _computeCullingIndirectDrawCommandSetLayout);
-		}
-	}
-
 	// Descriptor set layout for compute skinning.
 	// (Can't create descriptors bc 0 byte buffers can't get created)
 	_computeSkinningInoutVerticesSetLayout =
@@ -4509,7 +4992,7 @@ void VulkanEngine::initPipelines()
 				.size = sizeof(GPUCullingParams)
 			}
 		},
-		{ _computeCullingIndirectDrawCommandSetLayout, _objectSetLayout, _instancePtrSetLayout },
+		{ _computeCullingIndirectDrawCommandSetLayout, _objectSetLayout, _instancePtrSetLayout, _occlusionCullingSetLayout },
 		{ VK_SHADER_STAGE_COMPUTE_BIT, "res/shaders/indirect_culling.comp.spv" },
 		computeCullingPipeline,
 		computeCullingPipelineLayout,
@@ -4517,6 +5000,44 @@ void VulkanEngine::initPipelines()
 	);
 	attachPipelineToMaterial(computeCullingPipeline, computeCullingPipelineLayout, "computeCulling");
 
+	// Compute depth reduce pipeline.
+	VkPipeline computeDepthReducePipeline;
+	VkPipelineLayout computeDepthReducePipelineLayout;
+	vkutil::pipelinebuilder::buildCompute(
+		{
+			VkPushConstantRange{
+				.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+				.offset = 0,
+				.size = sizeof(GPUDepthReduceParams)
+			}
+		},
+		{ _depthReduceSetLayout },
+		{ VK_SHADER_STAGE_COMPUTE_BIT, "res/shaders/depth_reduce.comp.spv" },
+		computeDepthReducePipeline,
+		computeDepthReducePipelineLayout,
+		_swapchainDependentDeletionQueue
+	);
+	attachPipelineToMaterial(computeDepthReducePipeline, computeDepthReducePipelineLayout, "computeDepthReduce");
+
+	// Compute gpu scene scatter pipeline.
+	VkPipeline computeGPUSceneScatterPipeline;
+	VkPipelineLayout computeGPUSceneScatterPipelineLayout;
+	vkutil::pipelinebuilder::buildCompute(
+		{
+			VkPushConstantRange{
+				.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+				.offset = 0,
+				.size = sizeof(GPUSceneScatterParams)
+			}
+		},
+		{ _computeGPUSceneScatterSetLayout },
+		{ VK_SHADER_STAGE_COMPUTE_BIT, "res/shaders/gpu_scene_scatter.comp.spv" },
+		computeGPUSceneScatterPipeline,
+		computeGPUSceneScatterPipelineLayout,
+		_swapchainDependentDeletionQueue  // Ultimately this doesn't need to change when the swapchain changes, but this allows for the shader getting reloaded when a swapchain recreation occurs.
+	);
+	attachPipelineToMaterial(computeGPUSceneScatterPipeline, computeGPUSceneScatterPipelineLayout, "computeGPUSceneScatter");
+
 	// Compute skinning pipeline.
 	VkPipeline computeSkinningPipeline;
 	VkPipelineLayout computeSkinningPipelineLayout;
@@ -5553,6 +6074,7 @@ void VulkanEngine::recreateSwapchain()
 	initUIRenderpass();
 	initPostprocessRenderpass();
 	initPostprocessImages();
+	initDepthPyramid();
 	initPickingRenderpass();
 	initFramebuffers();
 	initPipelines();
@@ -5641,61 +6163,73 @@ void VulkanEngine::uploadCurrentFrameToGPU(const FrameData& currentFrame)
 	//
 	// Upload Camera Data to GPU
 	//
-	void* data;
-	vmaMapMemory(_allocator, currentFrame.cameraBuffer._allocation, &data);
-	memcpy(data, &_camera->sceneCamera.gpuCameraData, sizeof(GPUCameraData));
-	vmaUnmapMemory(_allocator, currentFrame.cameraBuffer._allocation);
+	memcpy(currentFrame.cameraBuffer._mappedData, &_camera->sceneCamera.gpuCameraData, sizeof(GPUCameraData));
 
 	//
 	// Upload pbr shading props to GPU
 	//
-	vmaMapMemory(_allocator, currentFrame.pbrShadingPropsBuffer._allocation, &data);
-	memcpy(data, &_pbrRendering.gpuSceneShadingProps, sizeof(GPUPBRShadingProps));
-	vmaUnmapMemory(_allocator, currentFrame.pbrShadingPropsBuffer._allocation);
+	memcpy(currentFrame.pbrShadingPropsBuffer._mappedData, &_pbrRendering.gpuSceneShadingProps, sizeof(GPUPBRShadingProps));
 
 	//
 	// Fill in object data into current frame object buffer
 	//
 	{
 		std::lock_guard<std::mutex> lg(_roManager->renderObjectIndicesAndPoolMutex);
-		void* objectData;
-		vmaMapMemory(_allocator, currentFrame.objectBuffer._allocation, &objectData);
-		GPUObjectData* objectSSBO = (GPUObjectData*)objectData;    // @IMPROVE: perhaps multithread this? Or only update when the object moves?
-		for (size_t poolIndex : _roManager->_renderObjectsIndices)  // @NOTE: bc of the pool system these indices will be scattered, but that should work just fine
-		{
-			// Another evil pointer trick I love... call me Dmitri the Evil!
-
-			// Assign model matrix.
-			mat4& modelMatrix = _roManager->_renderObjectPool[poolIndex].transformMatrix;
-			glm_mat4_copy(
-				modelMatrix,
-				objectSSBO[poolIndex].modelMatrix
-			);
+		growRenderObjectBuffersIfNeeded(getCurrentFrame(), _roManager->_renderObjectPool.capacity());
+		refreshSharedBufferDescriptors(getCurrentFrame());
+		GPUObjectData* objectSSBO = (GPUObjectData*)currentFrame.objectBuffer._mappedData;
+		uint8_t currentFrameBit = (uint8_t)(1 << (_frameNumber % FRAME_OVERLAP));
+		constexpr uint8_t allFramesBits = (uint8_t)((1 << FRAME_OVERLAP) - 1);
+
+		// @NOTE: bc of the pool system these indices will be scattered, but that should work just fine.
+		//        Each object only touches its own pool slot, so this is safe to run in parallel.
+		auto uploadObjectData = [&](size_t poolIndex) {
+			RenderObject& ro = _roManager->_renderObjectPool[poolIndex];
+
+			// Only recalculate if the object moved (a straight compare is much cheaper than the decompose).
+			if (ro.gpuObjectDataStale ||
+				memcmp(ro.transformMatrix, ro.gpuCachedTransformMatrix, sizeof(mat4)) != 0)
+			{
+				glm_mat4_copy(ro.transformMatrix, ro.gpuCachedTransformMatrix);
+
+				// Calc bounding sphere center.
+				vec3& boundingSphereCenter = ro.model->boundingSphere.center;
+				vec4 boundingSphere = { boundingSphereCenter[0], boundingSphereCenter[1], boundingSphereCenter[2], 1.0f };
+				glm_mat4_mulv(ro.transformMatrix, boundingSphere, boundingSphere);
+
+				// Calc bounding sphere radius.
+				vec3 scale;
+				glm_decompose_scalev(ro.transformMatrix, scale);
+				glm_vec3_abs(scale, scale);
+				boundingSphere[3] = ro.model->boundingSphere.radius * glm_vec3_max(scale);
+				glm_vec4_copy(boundingSphere, ro.gpuCachedBoundingSphere);
+
+				ro.gpuObjectDataStale = false;
+				ro.gpuObjectDataDirtyBits = allFramesBits;
+			}
 
-			// Calc bounding sphere center.
-			vec3& boundingSphereCenter = _roManager->_renderObjectPool[poolIndex].model->boundingSphere.center;
-			vec4 boundingSphere = { boundingSphereCenter[0], boundingSphereCenter[1], boundingSphereCenter[2], 1.0f };
-			glm_mat4_mulv(
-				modelMatrix,
-				boundingSphere,
-				boundingSphere
-			);
+			// Only write to the mapped buffer if this frame's copy is out of date.
+			if (ro.gpuObjectDataDirtyBits & currentFrameBit)
+			{
+				glm_mat4_copy(ro.gpuCachedTransformMatrix, objectSSBO[poolIndex].modelMatrix);
+				glm_vec4_copy(ro.gpuCachedBoundingSphere, objectSSBO[poolIndex].boundingSphere);
+				ro.gpuObjectDataDirtyBits &= ~currentFrameBit;
+			}
+		};
 
-			// Calc bounding sphere radius.
-			vec3 scale;
-			glm_decompose_scalev(modelMatrix, scale);
-			glm_vec3_abs(scale, scale);
-			boundingSphere[3] =
-				_roManager->_renderObjectPool[poolIndex].model->boundingSphere.radius
-					* glm_vec3_max(scale);
-
-			// Assign bounding sphere.
-			glm_vec4_copy(
-				boundingSphere,
-				objectSSBO[poolIndex].boundingSphere
-			);
+		auto& indices = _roManager->_renderObjectsIndices;
+		constexpr size_t minIndicesForParallelUpload = 512;  // Below this, the job overhead isn't worth it.
+		if (indices.size() < minIndicesForParallelUpload)
+		{
+			for (size_t poolIndex : indices)
+				uploadObjectData(poolIndex);
+		}
+		else
+		{
+			tf::Taskflow taskflow;
+			taskflow.for_each(indices.begin(), indices.end(), uploadObjectData);
+			_roManager->_jobExecutor.run(taskflow).wait();
 		}
-		vmaUnmapMemory(_allocator, currentFrame.objectBuffer._allocation);
 	}
 }
 
@@ -5703,9 +6237,11 @@ void VulkanEngine::createSkinningBuffers(FrameData& currentFrame)
 {
 	ZoneScoped;
 
+	// @NOTE: `renderObjectIndicesAndPoolMutex` is expected to be locked already.
+
 	destroySkinningBuffersIfCreated(currentFrame);
 
-	if (!_roManager->_skinnedMeshEntriesExist)
+	if (_roManager->_numSkinnedMeshBucketEntries == 0)
 		return;  // Exit early bc buffers will be initialized to be empty.
 
 	// Traverse buckets and count up skinned mesh indices.
@@ -5914,6 +6450,7 @@ void VulkanEngine::createSkinningBuffers(FrameData& currentFrame)
 	// Finish.
 	s.created = true;
 	s.recalculateSkinningBuffers = false;
+	s.recomputeSkinnedMeshes = true;
 }
 
 void VulkanEngine::destroySkinningBuffersIfCreated(FrameData& currentFrame)
@@ -5930,126 +6467,213 @@ void VulkanEngine::destroySkinningBuffersIfCreated(FrameData& currentFrame)
 	}
 }
 
+void VulkanEngine::resetIndirectDrawCommandCounts(FrameData& currentFrame, size_t numBatches)
+{
+	for (auto& shadowPass : currentFrame.indirectShadowPasses)
+		memset(shadowPass.indirectDrawCommandCountsBuffer._mappedData, 0, sizeof(uint32_t) * numBatches);
+	memset(currentFrame.indirectMainPass.indirectDrawCommandCountsBuffer._mappedData, 0, sizeof(uint32_t) * numBatches);
+}
+
 void VulkanEngine::compactRenderObjectsIntoDraws(FrameData& currentFrame, std::vector<size_t> onlyPoolIndices, std::vector<ModelWithIndirectDrawId>& outIndirectDrawCommandIdsForPoolIndex)
 {
 	ZoneScoped;
 
-	GPUInstancePointer* instancePtrSSBO;
-	vmaMapMemory(_allocator, currentFrame.instancePtrBuffer._allocation, (void**)&instancePtrSSBO);
-	VkDrawIndexedIndirectCommand* indirectDrawCommands;
-	vmaMapMemory(_allocator, currentFrame.indirectDrawCommandRawBuffer._allocation, (void**)&indirectDrawCommands);
-	GPUIndirectDrawCommandOffsetsData* indirectDrawCommandOffsets;
-	vmaMapMemory(_allocator, currentFrame.indirectDrawCommandOffsetsBuffer._allocation, (void**)&indirectDrawCommandOffsets);
-	uint32_t* indirectDrawCommandCountsShadow;
-	vmaMapMemory(_allocator, currentFrame.indirectShadowPass.indirectDrawCommandCountsBuffer._allocation, (void**)&indirectDrawCommandCountsShadow);
-	uint32_t* indirectDrawCommandCountsMain;
-	vmaMapMemory(_allocator, currentFrame.indirectMainPass.indirectDrawCommandCountsBuffer._allocation, (void**)&indirectDrawCommandCountsMain);
-
-	// Traverse thru bucket to write commands.
-	{
-		std::vector<IndirectBatch> batches;
-		size_t nextSkinnedIndex = 0;
-		size_t instanceID = 0;
+	// @NOTE: `renderObjectIndicesAndPoolMutex` is expected to be locked already.
 
-		std::lock_guard<std::mutex> lg(_roManager->renderObjectIndicesAndPoolMutex);
+	// The gpu scene already has the command stream if nothing changed since the last compaction.
+	// @NOTE: picking needs the draw ids of the picked objects, so go thru the whole thing then.
+	uint64_t drawCommandsGeneration = _roManager->_drawCommandsGeneration;
+	if (onlyPoolIndices.empty() &&
+		_gpuScene.compactedDrawCommandsGeneration == drawCommandsGeneration)
+	{
+		// Init as count of 0 so that culling can increment this value.
+		resetIndirectDrawCommandCounts(currentFrame, indirectBatches.size());
+		currentFrame.numInstances = _gpuScene.numInstances;
+		currentFrame.numGPUSceneDeltas = 0;
+		return;
+	}
 
-		for (size_t i = 0; i < _roManager->_numUmbBuckets; i++)
+	// Pass 1: prefix sum the bucket sizes to give each bucket its range of draw commands.
+	// @NOTE: big buckets get split up so that the fill work spreads out evenly.
+	struct DrawRange
+	{
+		const std::vector<size_t>* renderObjectIndices;
+		size_t roIdxBegin;
+		size_t roIdxEnd;
+		size_t modelIdx;
+		size_t meshIdx;
+		bool isSkinnedPass;
+		size_t firstInstanceID;
+		size_t firstSkinnedIndex;
+		uint32_t batchFirstIndex;
+		uint32_t countIndex;
+		std::vector<uint32_t> changedInstanceIDs;
+	};
+	constexpr size_t maxInstancesPerDrawRange = 256;
+	std::vector<DrawRange> drawRanges;
+	std::vector<IndirectBatch> batches;
+	size_t nextSkinnedIndex = 0;
+	size_t instanceID = 0;
+
+	for (size_t i = 0; i < _roManager->_numUmbBuckets; i++)
+	{
+		auto& umbBucket = _roManager->_umbBuckets[i];
+		for (size_t j = 0; j < 2; j++)
 		{
-			auto& umbBucket = _roManager->_umbBuckets[i];
-			for (size_t j = 0; j < 2; j++)
+			bool isSkinnedPass = (j == 0);
+			for (size_t k = 0; k < _roManager->_numModelBuckets; k++)
 			{
-				bool isSkinnedPass = (j == 0);
-				auto modelIter = _roManager->_renderObjectModels.begin();
-				for (size_t k = 0; k < _roManager->_numModelBuckets; k++, modelIter++)
-				{
-					auto& modelBucket = umbBucket.modelBucketSets[j].modelBuckets[k];
-
-					// Create new batch.
-					IndirectBatch batch = {
-						.model = (isSkinnedPass ? (vkglTF::Model*)&_roManager->_skinnedMeshModelMemAddr : modelIter->second),
-						.uniqueMaterialBaseId = (uint32_t)i,
-						.first = (uint32_t)instanceID,  // @NOTE: This is actually the draw command id.
-						.count = 0,
-					};
+				auto& modelBucket = umbBucket.modelBucketSets[j].modelBuckets[k];
+
+				// Create new batch.
+				IndirectBatch batch = {
+					.model = (isSkinnedPass ? (vkglTF::Model*)&_roManager->_skinnedMeshModelMemAddr : _roManager->_modelsByModelIdx[k]),
+					.uniqueMaterialBaseId = (uint32_t)i,
+					.first = (uint32_t)instanceID,  // @NOTE: This is actually the draw command id.
+					.count = 0,
+				};
 
-					for (size_t l = 0; l < _roManager->_numMeshBucketsByModelIdx[k]; l++)
+				for (size_t l = 0; l < _roManager->_numMeshBucketsByModelIdx[k]; l++)
+				{
+					auto& renderObjectIndices = modelBucket.meshBuckets[l].renderObjectIndices;
+					uint32_t meshIndexCount = _roManager->_modelMeshDraws[k][l].meshIndexCount;
+					for (size_t roIdxBegin = 0; roIdxBegin < renderObjectIndices.size(); roIdxBegin += maxInstancesPerDrawRange)
 					{
-						auto& meshBucket = modelBucket.meshBuckets[l];
-						for (auto& roIdx : meshBucket.renderObjectIndices)
-						{
-							auto& meshDraw = _roManager->_modelMeshDraws[k][l];
-							*indirectDrawCommands = {
-								.indexCount = meshDraw.meshIndexCount,
-								.instanceCount = 1,
-								.firstIndex = (isSkinnedPass ? (uint32_t)nextSkinnedIndex : meshDraw.meshFirstIndex),
-								.vertexOffset = 0,
-								.firstInstance = (uint32_t)instanceID,
-							};
-
-							*indirectDrawCommandOffsets = {
-								.batchFirstIndex = batch.first,
-								.countIndex = (uint32_t)batches.size(),
-							};
+						size_t roIdxEnd = std::min(roIdxBegin + maxInstancesPerDrawRange, renderObjectIndices.size());
+						drawRanges.push_back({
+							.renderObjectIndices = &renderObjectIndices,
+							.roIdxBegin = roIdxBegin,
+							.roIdxEnd = roIdxEnd,
+							.modelIdx = k,
+							.meshIdx = l,
+							.isSkinnedPass = isSkinnedPass,
+							.firstInstanceID = instanceID,
+							.firstSkinnedIndex = nextSkinnedIndex,
+							.batchFirstIndex = batch.first,
+							.countIndex = (uint32_t)batches.size(),
+						});
+
+						size_t numInstances = roIdxEnd - roIdxBegin;
+						if (isSkinnedPass)
+							nextSkinnedIndex += meshIndexCount * numInstances;  // Jump num indices to go to next index group (if wanting to do an offset, use vertex count).
+						instanceID += numInstances;
+						batch.count += (uint32_t)numInstances;
+					}
+				}
 
-							GPUInstancePointer& gip = _roManager->_renderObjectPool[roIdx].calculatedModelInstances[l];
-							*instancePtrSSBO = gip;
+				if (batch.count > 0)
+					batches.push_back(batch);  // Only add the batch in if there are instances in the batch.
+			}
+		}
+	}
 
-#ifdef _DEVELOP
-							if (!onlyPoolIndices.empty())  // Is this line even necessary? I'm doing this bc the for loop setup code could take longer than just checking whether the list is empty.
-								for (size_t index : onlyPoolIndices)
-									if (index == gip.objectID)
-									{
-										// Include this draw indirect command list for picking.
-										outIndirectDrawCommandIdsForPoolIndex.push_back({
-											meshDraw.model,
-											(uint32_t)instanceID
-										});
-										break;
-									}
-#endif
+	// Pass 2: fill in each range and note which entries differ from what's in the gpu scene.
+	//         Ranges don't overlap so they can get written in parallel.
+	growInstancePtrBuffersIfNeeded(currentFrame, instanceID);
 
-							if (isSkinnedPass)
-								nextSkinnedIndex += meshDraw.meshIndexCount;  // Jump num indices to go to next index group (if wanting to do an offset, use vertex count).
-							indirectDrawCommands++;
-							indirectDrawCommandOffsets++;
-							instancePtrSSBO++;
-							instanceID++;
-							batch.count++;
-						}
-					}
+	size_t numValidGPUSceneEntries = std::min(_gpuScene.drawCommands.size(), instanceID);
+	_gpuScene.drawCommands.resize(instanceID);
+	_gpuScene.drawCommandOffsets.resize(instanceID);
+	_gpuScene.instancePtrs.resize(instanceID);
 
-					if (batch.count > 0)
-					{
-						batches.push_back(batch);  // Only add the batch in if there are instances in the batch.
+	auto fillDrawRange = [&](DrawRange& range) {
+		auto& meshDraw = _roManager->_modelMeshDraws[range.modelIdx][range.meshIdx];
+		size_t instID = range.firstInstanceID;
+		size_t skinnedIndex = range.firstSkinnedIndex;
+		for (size_t m = range.roIdxBegin; m < range.roIdxEnd; m++, instID++)
+		{
+			size_t roIdx = (*range.renderObjectIndices)[m];
+			VkDrawIndexedIndirectCommand drawCommand = {
+				.indexCount = meshDraw.meshIndexCount,
+				.instanceCount = 1,
+				.firstIndex = (range.isSkinnedPass ? (uint32_t)skinnedIndex : meshDraw.meshFirstIndex),
+				.vertexOffset = 0,
+				.firstInstance = (uint32_t)instID,
+			};
+			GPUIndirectDrawCommandOffsetsData drawCommandOffsets = {
+				.batchFirstIndex = range.batchFirstIndex,
+				.countIndex = range.countIndex,
+			};
+			const GPUInstancePointer& instancePtr = _roManager->_renderObjectPool[roIdx].calculatedModelInstances[range.meshIdx];
 
-						// Init as count of 0 so that culling can increment this value.
-						*indirectDrawCommandCountsShadow = 0;
-						indirectDrawCommandCountsShadow++;
-						*indirectDrawCommandCountsMain = 0;
-						indirectDrawCommandCountsMain++;
-					}
-				}
+			if (instID >= numValidGPUSceneEntries ||
+				memcmp(&drawCommand, &_gpuScene.drawCommands[instID], sizeof(VkDrawIndexedIndirectCommand)) != 0 ||
+				memcmp(&drawCommandOffsets, &_gpuScene.drawCommandOffsets[instID], sizeof(GPUIndirectDrawCommandOffsetsData)) != 0 ||
+				memcmp(&instancePtr, &_gpuScene.instancePtrs[instID], sizeof(GPUInstancePointer)) != 0)
+			{
+				_gpuScene.drawCommands[instID] = drawCommand;
+				_gpuScene.drawCommandOffsets[instID] = drawCommandOffsets;
+				_gpuScene.instancePtrs[instID] = instancePtr;
+				range.changedInstanceIDs.push_back((uint32_t)instID);
 			}
+
+			if (range.isSkinnedPass)
+				skinnedIndex += meshDraw.meshIndexCount;
 		}
+	};
 
-		currentFrame.numInstances = instanceID;
-		indirectBatches = batches;
+	constexpr size_t minInstancesForParallelFill = 2048;
+	if (instanceID < minInstancesForParallelFill)
+	{
+		for (auto& range : drawRanges)
+			fillDrawRange(range);
+	}
+	else
+	{
+		tf::Taskflow taskflow;
+		taskflow.for_each(drawRanges.begin(), drawRanges.end(), fillDrawRange);
+		_roManager->_jobExecutor.run(taskflow).wait();
 	}
 
-	// Finish.
-	vmaUnmapMemory(_allocator, currentFrame.instancePtrBuffer._allocation);
-	vmaUnmapMemory(_allocator, currentFrame.indirectDrawCommandRawBuffer._allocation);
-	vmaUnmapMemory(_allocator, currentFrame.indirectDrawCommandOffsetsBuffer._allocation);
-	vmaUnmapMemory(_allocator, currentFrame.indirectShadowPass.indirectDrawCommandCountsBuffer._allocation);
-	vmaUnmapMemory(_allocator, currentFrame.indirectMainPass.indirectDrawCommandCountsBuffer._allocation);
+	// Write the changed entries into this frame's part of the staging ring. `computeGPUSceneScatter()` applies them.
+	size_t numDeltas = 0;
+	for (auto& range : drawRanges)
+		numDeltas += range.changedInstanceIDs.size();
+	growGPUSceneDeltasBufferIfNeeded(currentFrame, numDeltas);
+
+	GPUSceneDelta* deltas = (GPUSceneDelta*)currentFrame.gpuSceneDeltasBuffer._mappedData;
+	for (auto& range : drawRanges)
+		for (uint32_t instID : range.changedInstanceIDs)
+			*deltas++ = {
+				.instanceID = instID,
+				.drawCommand = _gpuScene.drawCommands[instID],
+				.drawCommandOffsets = _gpuScene.drawCommandOffsets[instID],
+				.instancePtr = _gpuScene.instancePtrs[instID],
+			};
+	currentFrame.numGPUSceneDeltas = (uint32_t)numDeltas;
+
+	// Init as count of 0 so that culling can increment this value.
+	resetIndirectDrawCommandCounts(currentFrame, batches.size());
+
+#ifdef _DEVELOP
+	// Include the draw indirect commands of the picked objects for picking.
+	if (!onlyPoolIndices.empty())
+		for (auto& range : drawRanges)
+			for (size_t m = range.roIdxBegin; m < range.roIdxEnd; m++)
+			{
+				size_t roIdx = (*range.renderObjectIndices)[m];
+				for (size_t index : onlyPoolIndices)
+					if (index == _roManager->_renderObjectPool[roIdx].calculatedModelInstances[range.meshIdx].objectID)
+					{
+						outIndirectDrawCommandIdsForPoolIndex.push_back({
+							_roManager->_modelMeshDraws[range.modelIdx][range.meshIdx].model,
+							(uint32_t)(range.firstInstanceID + m - range.roIdxBegin)
+						});
+						break;
+					}
+			}
+#endif
+
+	currentFrame.numInstances = instanceID;
+	_gpuScene.numInstances = instanceID;
+	_gpuScene.compactedDrawCommandsGeneration = drawCommandsGeneration;
+	indirectBatches = batches;
 }
 
-void VulkanEngine::renderRenderObjects(VkCommandBuffer cmd, const FrameData& currentFrame, bool materialOverride, bool useShadowIndirectPass)
+void VulkanEngine::renderRenderObjects(VkCommandBuffer cmd, const FrameData& currentFrame, bool materialOverride, const FrameData::IndirectPass& pass)
 {
 	ZoneScoped;
 
-	auto& pass = useShadowIndirectPass ? currentFrame.indirectShadowPass : currentFrame.indirectMainPass;
-
 	// Iterate thru all the batches
 	vkglTF::Model* lastModel = nullptr;
 	size_t lastUMBIdx = (size_t)-1;
@@ -6098,7 +6722,7 @@ void VulkanEngine::renderRenderObjects(VkCommandBuffer cmd, const FrameData& cur
 
 			VkDeviceSize indirectOffset = batch.first * drawStride;
 			VkDeviceSize countOffset = countIdx * countStride;
-			// vkCmdDrawIndexedIndirect(cmd, currentFrame.indirectDrawCommandRawBuffer._buffer, indirectOffset, batch.count, drawStride);
+			// vkCmdDrawIndexedIndirect(cmd, _gpuScene.indirectDrawCommandRawBuffer._buffer, indirectOffset, batch.count, drawStride);
 			vkCmdDrawIndexedIndirectCount(cmd, pass.indirectDrawCommandsBuffer._buffer, indirectOffset, pass.indirectDrawCommandCountsBuffer._buffer, countOffset, batch.count, drawStride);
 			countIdx++;
 		}
@@ -6166,7 +6790,7 @@ void VulkanEngine::renderPickedObject(VkCommandBuffer cmd, const FrameData& curr
 			}
 			else
 				mwidid.model->bind(cmd);
-			vkCmdDrawIndexedIndirect(cmd, currentFrame.indirectDrawCommandRawBuffer._buffer, indirectOffset, 1, drawStride);
+			vkCmdDrawIndexedIndirect(cmd, _gpuScene.indirectDrawCommandRawBuffer._buffer, indirectOffset, 1, drawStride);
 		}
 	}
 }
@@ -6720,6 +7344,20 @@ void VulkanEngine::renderImGuiContent(float_t deltaTime, ImGuiIO& io)
 						physengine::setWorldGravity(worldGravity);
 				}
 
+				// Benchmarks and self-checks.
+				ImGui::Separator();
+				if (ImGui::CollapsingHeader("Benchmarks"))
+				{
+					if (ImGui::Button("Check/Benchmark Keyframe Cursors"))
+						vkglTF::runKeyframeCursorBenchmark();
+					if (ImGui::Button("Check Occlusion Culling"))
+						occlusionculling::runSelfCheck();
+					if (ImGui::Button("Benchmark Batched Raycasts"))
+						physengine::runBatchedCastBenchmark();
+					if (ImGui::Button("Benchmark Animators"))
+						_roManager->runAnimatorBenchmark();
+				}
+
 				// Camera props.
 				ImGui::Separator();
 				if (ImGui::CollapsingHeader("Camera Properties", ImGuiTreeNodeFlags_DefaultOpen))
@@ -6797,7 +7435,7 @@ void VulkanEngine::renderImGuiContent(float_t deltaTime, ImGuiIO& io)
 						// Figure out linecast for .
 						ImGuiIO& io = ImGui::GetIO();
 						bool raycastSuccess = false;
-						std::string raycastGuid;
+						Entity* raycastEntity = nullptr;
 						vec3 initPosition;
 						{
 							vec3 linecastPt1, linecastPt2;
@@ -6817,7 +7455,7 @@ void VulkanEngine::renderImGuiContent(float_t deltaTime, ImGuiIO& io)
 							vec3 delta;
 							glm_vec3_sub(linecastPt2, linecastPt1, delta);
 							float_t frac;
-							raycastSuccess = physengine::raycast(linecastPt1, delta, raycastGuid, frac);
+							raycastSuccess = physengine::raycast(linecastPt1, delta, physengine::Layers::MOVING, raycastEntity, frac);  // @NOTE: moving objects collide with every layer, so this picks anything.
 							if (raycastSuccess)
 							{
 								glm_vec3_scale(delta, frac, delta);
@@ -6837,7 +7475,7 @@ void VulkanEngine::renderImGuiContent(float_t deltaTime, ImGuiIO& io)
 							listEntityTypes[(size_t)entityToCreateIndex] +
 							"`\nOr Esc to cancel.\n";
 						if (raycastSuccess)
-							tip += "On top of `" + raycastGuid.substr(0, 6) + "` at (" + std::to_string((int32_t)initPosition[0]) + ", " + std::to_string((int32_t)initPosition[1]) + ", " + std::to_string((int32_t)initPosition[2]) + ").";
+							tip += "On top of `" + (raycastEntity != nullptr ? raycastEntity->getGUID().substr(0, 6) : "??????") + "` at (" + std::to_string((int32_t)initPosition[0]) + ", " + std::to_string((int32_t)initPosition[1]) + ", " + std::to_string((int32_t)initPosition[2]) + ").";
 						else
 							tip += "At cursor (" + std::to_string((int32_t)io.MousePos.x) + ", " + std::to_string((int32_t)io.MousePos.y) + "), 20m away.";
 						ImGui::TextUnformatted(tip.c_str());
@@ -7058,12 +7696,14 @@ void VulkanEngine::renderImGuiContent(float_t deltaTime, ImGuiIO& io)
 						// Edit props exclusive to render objects
 						//
 						RenderObject* foundRO = nullptr;
+						RenderObjectHandle foundROHandle;
 						for (size_t poolIndex : _roManager->_renderObjectsIndices)
 						{
 							auto& ro = _roManager->_renderObjectPool[poolIndex];
 							if (_movingMatrix.matrixToMove == &ro.transformMatrix)
 							{
 								foundRO = &ro;
+								foundROHandle = RenderObjectHandle(&ro, _roManager->_renderObjectGenerations[poolIndex]);
 								break;
 							}
 						}
@@ -7074,7 +7714,7 @@ void VulkanEngine::renderImGuiContent(float_t deltaTime, ImGuiIO& io)
 							{
 								int32_t temp = (int32_t)foundRO->renderLayer;
 								if (ImGui::Combo("Render Layer##asdfasdfasgasgcombo", &temp, "VISIBLE\0INVISIBLE\0BUILDER"))
-									foundRO->renderLayer = RenderLayer(temp);
+									_roManager->setRenderLayer(foundROHandle, RenderLayer(temp));
 							}
 
 							//
@@ -2,6 +2,7 @@
 
 #include "Settings.h"
 #include "VkDataStructures.h"
+#include "RenderObject.h"
 #include "EntityManager.h"
 #include "SceneManagement.h"
 
@@ -45,8 +46,8 @@ struct GPUObjectData
 
 struct GPUPickingSelectedIdData
 {
-	uint32_t selectedId[RENDER_OBJECTS_MAX_CAPACITY];
-	float_t selectedDepth[RENDER_OBJECTS_MAX_CAPACITY];
+	uint32_t selectedId;
+	float_t selectedDepth;
 };
 
 struct ColorPushConstBlock
@@ -104,6 +105,21 @@ struct GPUCullingParams
 	float_t  frustumY_z;
 	uint32_t cullingEnabled;
 	uint32_t numInstances;
+
+	// Occlusion culling.
+	float_t  P00;
+	float_t  P11;
+	float_t  P22;
+	float_t  P32;
+	float_t  pyramidWidth;
+	float_t  pyramidHeight;
+	uint32_t occlusionCullingEnabled;
+	uint32_t cullingMode;  // 0: cull draw commands with the camera, 1: write object visibility for next frame, 2: cull draw commands with an ortho view projection (shadow cascades).
+};
+
+struct GPUDepthReduceParams
+{
+	vec2 imageSize;
 };
 
 struct GPUIndirectDrawCommandOffsetsData
@@ -114,6 +130,19 @@ struct GPUIndirectDrawCommandOffsetsData
 	uint32_t pad1;
 };
 
+struct GPUSceneDelta
+{
+	uint32_t                          instanceID;
+	VkDrawIndexedIndirectCommand      drawCommand;
+	GPUIndirectDrawCommandOffsetsData drawCommandOffsets;
+	GPUInstancePointer                instancePtr;
+};
+
+struct GPUSceneScatterParams
+{
+	uint32_t numDeltas;
+};
+
 struct GPUInputSkinningMeshPrefixData
 {
 	uint32_t numVertices;
@@ -163,13 +192,18 @@ struct FrameData
 	{
 		AllocatedBuffer indirectDrawCommandsBuffer;
 		AllocatedBuffer indirectDrawCommandCountsBuffer;
-		VkDescriptorSet indirectDrawCommandDescriptor;
+		VkDescriptorSet indirectDrawCommandDescriptor = VK_NULL_HANDLE;
 	};
-	AllocatedBuffer indirectDrawCommandRawBuffer;
-	AllocatedBuffer indirectDrawCommandOffsetsBuffer;
-	IndirectPass    indirectShadowPass;
+	std::array<IndirectPass, SHADOWMAP_CASCADES> indirectShadowPasses;  // Casters that touch each cascade.
 	IndirectPass    indirectMainPass;
 	uint32_t        numInstances;
+	size_t          indirectPassBufferCapacity = 0;
+
+	// Changes to the gpu scene for this frame (this frame's part of the staging ring).
+	AllocatedBuffer gpuSceneDeltasBuffer;
+	VkDescriptorSet gpuSceneScatterDescriptor = VK_NULL_HANDLE;
+	size_t          gpuSceneDeltasBufferCapacity = 0;
+	uint32_t        numGPUSceneDeltas = 0;
 
 	AllocatedBuffer cameraBuffer;
 	AllocatedBuffer pbrShadingPropsBuffer;
@@ -179,13 +213,22 @@ struct FrameData
 	VkDescriptorSet cascadeViewProjsDescriptor;
 
 	AllocatedBuffer objectBuffer;
-	VkDescriptorSet objectDescriptor;
+	VkDescriptorSet objectDescriptor = VK_NULL_HANDLE;
 
-	AllocatedBuffer instancePtrBuffer;
-	VkDescriptorSet instancePtrDescriptor;
+	VkDescriptorSet instancePtrDescriptor = VK_NULL_HANDLE;
 
 	AllocatedBuffer pickingSelectedIdBuffer;
-	VkDescriptorSet pickingReturnValueDescriptor;
+	VkDescriptorSet pickingReturnValueDescriptor = VK_NULL_HANDLE;
+	size_t          renderObjectBufferCapacity = 0;  // @NOTE: capacity of both the object buffer and picking buffer.
+
+	VkDescriptorSet occlusionCullingDescriptor = VK_NULL_HANDLE;
+
+	// Shared buffers (gpu scene, object visibility) get replaced while the other frames in flight could still be
+	// using the old ones. Those get destroyed once this frame's fence gets waited on again, and the other frames
+	// point their descriptor sets at the new ones when it's their turn.
+	std::vector<AllocatedBuffer> retiredBuffers;
+	size_t          gpuSceneBuffersGeneration = 0;         // `GPUScene::buffersGeneration` this frame's descriptor sets point at.
+	size_t          objectVisibilityBufferGeneration = 0;  // Same for `_objectVisibilityBufferGeneration`.
 
 	struct ComputeSkinning
 	{
@@ -198,6 +241,7 @@ struct FrameData
 		VkDescriptorSet inoutVerticesDescriptor;
 		bool created                    = false;
 		bool recalculateSkinningBuffers = true;
+		bool recomputeSkinnedMeshes     = true;   // Output vertices are kept from the last dispatch when no animator nodes changed for this frame.
 	} skinning;
 };
 
@@ -274,6 +318,28 @@ public:
 	Texture        _depthImage;
 	VkFormat       _depthFormat;
 
+	// Hierarchical Z buffer (previous frame's depth, MAX reduced) for occlusion culling.
+	struct DepthPyramid
+	{
+		AllocatedImage               image;
+		VkImageView                  imageView;  // @NOTE: all mips, for the culling shader.
+		std::vector<VkImageView>     mipImageViews;
+		std::vector<VkDescriptorSet> reduceDescriptors;  // One per mip.
+		VkSampler                    maxSampler;
+		VkExtent2D                   extent;
+		uint32_t                     numMips;
+		bool                         valid = false;  // False until a pyramid gets built with the current swapchain.
+	} _depthPyramid;
+	VkDescriptorSetLayout _depthReduceSetLayout;
+	VkDescriptorSetLayout _occlusionCullingSetLayout;
+	AllocatedBuffer       _objectVisibilityBuffer;  // One uint per render object slot. Written by the 2nd culling phase.
+	size_t                _objectVisibilityBufferCapacity = 0;
+	size_t                _objectVisibilityBufferGeneration = 0;
+	bool                  _objectVisibilityBufferNeedsFill = false;  // Filled at the start of the next recorded frame.
+	void initDepthPyramid();
+	void createObjectVisibilityBuffer(size_t capacity);
+	void buildOcclusionCullingDescriptor(FrameData& frame);
+
 	//
 	// Texture for taking a snapshot of the rendered game screen
 	// (to warp for screen transitions, pause menus, etc.)
@@ -414,10 +480,42 @@ public:
 	VkDescriptorSetLayout _postprocessSetLayout;
 	VkDescriptorSetLayout _computeCullingIndirectDrawCommandSetLayout;
 	VkDescriptorSetLayout _computeSkinningInoutVerticesSetLayout;
+	VkDescriptorSetLayout _computeGPUSceneScatterSetLayout;
 
-	AllocatedBuffer createBuffer(size_t allocSize, VkBufferUsageFlags usage, VmaMemoryUsage memoryUsage);
+	AllocatedBuffer createBuffer(size_t allocSize, VkBufferUsageFlags usage, VmaMemoryUsage memoryUsage, bool persistentlyMapped = false);
 	size_t padUniformBufferSize(size_t originalSize);    // @NOTE: this is unused, but it's useful for dynamic uniform buffers
 
+	// Per-frame buffers sized by the render object pool. These get recreated bigger when the pool grows.
+	void createRenderObjectBuffers(FrameData& frame, size_t capacity);
+	void destroyRenderObjectBuffers(FrameData& frame);
+	void createIndirectPassBuffers(FrameData& frame, size_t capacity);
+	void destroyIndirectPassBuffers(FrameData& frame);
+	void growRenderObjectBuffersIfNeeded(FrameData& currentFrame, size_t numRenderObjectSlots);  // @NOTE: render thread only, after waiting on the frame's fence.
+	void growInstancePtrBuffersIfNeeded(FrameData& currentFrame, size_t numInstances);           // Same here.
+	void refreshSharedBufferDescriptors(FrameData& currentFrame);
+
+	// Draw commands and instance pointers stay resident on the gpu and only get patched
+	// with what changed since the last compaction (see `compactRenderObjectsIntoDraws()`).
+	struct GPUScene
+	{
+		AllocatedBuffer indirectDrawCommandRawBuffer;
+		AllocatedBuffer indirectDrawCommandOffsetsBuffer;
+		AllocatedBuffer instancePtrBuffer;
+		size_t          capacity = 0;
+		size_t          buffersGeneration = 0;  // Bumped whenever the buffers get recreated.
+		uint32_t        numInstances = 0;
+		uint64_t        compactedDrawCommandsGeneration = 0;  // `RenderObjectManager::_drawCommandsGeneration` the gpu scene was compacted from.
+
+		// Copy of what the gpu buffers contain, for finding the deltas.
+		std::vector<VkDrawIndexedIndirectCommand>      drawCommands;
+		std::vector<GPUIndirectDrawCommandOffsetsData> drawCommandOffsets;
+		std::vector<GPUInstancePointer>                instancePtrs;
+	} _gpuScene;
+	void createGPUSceneBuffers(size_t capacity);
+	void destroyGPUSceneBuffers();
+	void buildGPUSceneScatterDescriptor(FrameData& frame);
+	void growGPUSceneDeltasBufferIfNeeded(FrameData& frame, size_t numDeltas);
+
 #ifdef _DEVELOP
 	bool generateCollisionDebugVisualization = false;
 #endif
@@ -465,6 +563,7 @@ private:
 		uint32_t indirectDrawId;
 	};
 
+	void resetIndirectDrawCommandCounts(FrameData& currentFrame, size_t numBatches);
 	void compactRenderObjectsIntoDraws(
 		FrameData& currentFrame,
 #ifdef _DEVELOP
@@ -472,13 +571,15 @@ private:
 		std::vector<ModelWithIndirectDrawId>& outIndirectDrawCommandIdsForPoolIndex
 #endif
 		);
-	void renderRenderObjects(VkCommandBuffer cmd, const FrameData& currentFrame, bool materialOverride, bool useShadowIndirectPass);
+	void renderRenderObjects(VkCommandBuffer cmd, const FrameData& currentFrame, bool materialOverride, const FrameData::IndirectPass& pass);
 
 	bool searchForPickedObjectPoolIndex(size_t& outPoolIndex);
 	void renderPickedObject(VkCommandBuffer cmd, const FrameData& currentFrame, const std::vector<ModelWithIndirectDrawId>& indirectDrawCommandIds);
 
+	void computeGPUSceneScatter(const FrameData& currentFrame, VkCommandBuffer cmd);
 	void computeShadowCulling(const FrameData& currentFrame, VkCommandBuffer cmd);
-	void computeMainCulling(const FrameData& currentFrame, VkCommandBuffer cmd);
+	void computeMainCulling(const FrameData& currentFrame, VkCommandBuffer cmd, uint32_t cullingPhase);
+	void buildDepthPyramid(const FrameData& currentFrame, VkCommandBuffer cmd);
 	void computeSkinnedMeshes(const FrameData& currentFrame, VkCommandBuffer cmd);
 	void renderPickingRenderpass(const FrameData& currentFrame);
 	void renderShadowRenderpass(const FrameData& currentFrame, VkCommandBuffer cmd);